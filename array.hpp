@@ -26,18 +26,416 @@
 #pragma once
 
 #include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
 #include <cstdlib>
+#include <cstring>
 #include <functional>
 #include <tr1/functional>
 #include <iterator>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+#include <new>
 #include <numeric>
+#include <string>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
 #include <vector>
 
+#include "ordered_table.hpp"
+
 /**
  * Project's namespace.
  */
 namespace js4cpp {
 
+/**
+ * Tag selecting %Array's uninitialized-length constructor.
+ */
+struct Uninitialized {};
+
+/**
+ * Allocator which default-initializes (i.e. leaves trivial types untouched)
+ * instead of value-initializing elements constructed without arguments.
+ *
+ * @tparam T Allocated type.
+ */
+template <typename T> class DefaultInitAllocator : public std::allocator<T>
+{
+public:
+    template <typename U> struct rebind {
+        typedef DefaultInitAllocator<U> other;
+    };
+
+    DefaultInitAllocator() {}
+
+    template <typename U>
+    DefaultInitAllocator(const DefaultInitAllocator<U> &) {}
+
+    template <typename U>
+    void construct(U * p) {
+        ::new (static_cast<void *>(p)) U;
+    }
+
+    template <typename U, typename... Args>
+    void construct(U * p, Args &&... args) {
+        ::new (static_cast<void *>(p)) U(std::forward<Args>(args)...);
+    }
+};
+
+/**
+ * Random access iterator over array indexes. Dereferencing is delegated to
+ * Derived::at(index).
+ *
+ * @tparam Derived Concrete iterator type.
+ * @tparam Value Type dereferencing yields (by value).
+ */
+template <typename Derived, typename Value> class IndexedIterator
+{
+public:
+    typedef std::random_access_iterator_tag iterator_category;
+    typedef Value value_type;
+    typedef ptrdiff_t difference_type;
+    typedef Value reference;
+    typedef void pointer;
+
+    explicit IndexedIterator(size_t index = 0) : index_(index) {}
+
+    Value operator *() const { return self().at(index_); }
+    Value operator [](difference_type n) const { return self().at(index_ + n); }
+
+    Derived & operator ++() { ++index_; return self(); }
+    Derived & operator --() { --index_; return self(); }
+    Derived operator ++(int) { Derived result = self(); ++index_; return result; }
+    Derived operator --(int) { Derived result = self(); --index_; return result; }
+    Derived & operator +=(difference_type n) { index_ += n; return self(); }
+    Derived & operator -=(difference_type n) { index_ -= n; return self(); }
+    Derived operator +(difference_type n) const { Derived result = self(); return result += n; }
+    Derived operator -(difference_type n) const { Derived result = self(); return result -= n; }
+    difference_type operator -(const Derived & other) const { return index_ - other.index_; }
+
+    bool operator ==(const Derived & other) const { return index_ == other.index_; }
+    bool operator !=(const Derived & other) const { return index_ != other.index_; }
+    bool operator <(const Derived & other) const { return index_ < other.index_; }
+    bool operator >(const Derived & other) const { return index_ > other.index_; }
+    bool operator <=(const Derived & other) const { return index_ <= other.index_; }
+    bool operator >=(const Derived & other) const { return index_ >= other.index_; }
+
+protected:
+    size_t index_;
+
+private:
+    Derived & self() { return static_cast<Derived &>(*this); }
+    const Derived & self() const { return static_cast<const Derived &>(*this); }
+};
+
+/**
+ * Iterator yielding indexes themselves.
+ */
+class KeyIterator : public IndexedIterator<KeyIterator, size_t>
+{
+public:
+    explicit KeyIterator(size_t index = 0) : IndexedIterator<KeyIterator, size_t>(index) {}
+
+    size_t at(size_t index) const { return index; }
+};
+
+/**
+ * Iterator yielding (index, element reference) pairs.
+ *
+ * @tparam T Elements type (const-qualified for read-only iteration).
+ */
+template <typename T> class EntryIterator : public IndexedIterator<EntryIterator<T>, std::pair<size_t, T &> >
+{
+public:
+    EntryIterator(T * data = 0, size_t index = 0) :
+        IndexedIterator<EntryIterator<T>, std::pair<size_t, T &> >(index), data_(data) {}
+
+    std::pair<size_t, T &> at(size_t index) const { return std::pair<size_t, T &>(index, data_[index]); }
+
+private:
+    T * data_;
+};
+
+/**
+ * Pair of iterators usable in range-based for loops and STL algorithms.
+ *
+ * @tparam Iterator Iterator type.
+ */
+template <typename Iterator> class Range
+{
+public:
+    Range(Iterator begin, Iterator end) : begin_(begin), end_(end) {}
+
+    Iterator begin() const { return begin_; }
+    Iterator end() const { return end_; }
+    size_t size() const { return std::distance(begin_, end_); }
+
+private:
+    Iterator begin_, end_;
+};
+
+/**
+ * Convert JS-style relative index (negative ones are counted from the end)
+ * to absolute one clamped to [0, length].
+ *
+ * @param index Relative index.
+ * @param length Length of the indexed sequence.
+ * @returns Absolute index.
+ */
+inline size_t relativeIndex(ssize_t index, size_t length) {
+    ssize_t signedLength = length;
+
+    if (index < 0) {
+        return index + signedLength < 0 ? 0 : index + signedLength;
+    }
+
+    return index > signedLength ? length : index;
+}
+
+/**
+ * Append decimal digits of an integer, without going through printf.
+ *
+ * @param out String to append to.
+ * @param value Integer.
+ */
+template <typename T>
+void appendInteger(std::string & out, T value) {
+    char digits[24];
+    char * p = digits + sizeof(digits);
+    bool negative = value < 0;
+    typename std::make_unsigned<T>::type magnitude = negative ? 0 - static_cast<typename std::make_unsigned<T>::type>(value) : value;
+
+    do {
+        *--p = char('0' + magnitude % 10);
+        magnitude /= 10;
+    } while (magnitude != 0);
+    if (negative) {
+        *--p = '-';
+    }
+
+    out.append(p, digits + sizeof(digits));
+}
+
+/**
+ * Append number the way JS `String(number)` writes it: the shortest form
+ * which reads back to the same value.
+ * @see https://developer.mozilla.org/en-US/docs/Web/JavaScript/Reference/Global_Objects/Number/toString
+ *
+ * @param out String to append to.
+ * @param value Number.
+ */
+inline void appendNumber(std::string & out, double value) {
+    if (value != value) {
+        out += "NaN";
+        return;
+    }
+    if (std::isinf(value)) {
+        out += value > 0 ? "Infinity" : "-Infinity";
+        return;
+    }
+    char buffer[32];
+
+    // JS writes integers below 1e21 in plain notation.
+    if (value == std::trunc(value) && std::fabs(value) < 1e21) {
+        if (std::fabs(value) < 9007199254740992.0) {
+            appendInteger(out, static_cast<int64_t>(value));
+        } else {
+            out.append(buffer, std::snprintf(buffer, sizeof(buffer), "%.0f", value));
+        }
+        return;
+    }
+
+    // If some precision reads back to the same value, so does every
+    // higher one, so the shortest is found by binary search.
+    int low = 1, high = 17;
+
+    while (low < high) {
+        int middle = (low + high) / 2;
+
+        std::snprintf(buffer, sizeof(buffer), "%.*e", middle - 1, value);
+        if (std::strtod(buffer, 0) == value) {
+            high = middle;
+        } else {
+            low = middle + 1;
+        }
+    }
+    std::snprintf(buffer, sizeof(buffer), "%.*e", low - 1, value);
+
+    // Split "-d.ddde-n" into digits and the decimal point position, i.e.
+    // value is 0.digits times 10 to the point.
+    char digits[20];
+    int count = 0;
+    const char * p = buffer;
+
+    if (*p == '-') {
+        out += '-';
+        ++p;
+    }
+    for (; *p != 'e'; ++p) {
+        if (*p != '.') {
+            digits[count++] = *p;
+        }
+    }
+    while (count > 1 && digits[count - 1] == '0') {
+        --count;
+    }
+
+    int point = std::atoi(p + 1) + 1;
+
+    // Layout of Number::toString: plain notation for 1e-6 <= |value| < 1e21,
+    // exponential one otherwise.
+    if (count <= point && point <= 21) {
+        out.append(digits, count);
+        out.append(point - count, '0');
+    } else if (0 < point && point <= 21) {
+        out.append(digits, point);
+        out += '.';
+        out.append(digits + point, count - point);
+    } else if (-6 < point && point <= 0) {
+        out += "0.";
+        out.append(-point, '0');
+        out.append(digits, count);
+    } else {
+        out += digits[0];
+        if (count > 1) {
+            out += '.';
+            out.append(digits + 1, count - 1);
+        }
+        out += point > 0 ? "e+" : "e-";
+        appendInteger(out, point > 0 ? point - 1 : 1 - point);
+    }
+}
+
+/**
+ * Append string form of an element, as used by Array::join. Types declared
+ * elsewhere add overloads next to themselves, found by argument-dependent
+ * lookup.
+ *
+ * @param out String to append to.
+ * @param value Element.
+ */
+inline void appendString(std::string & out, const std::string & value) {
+    out += value;
+}
+
+inline void appendString(std::string & out, const char * value) {
+    out += value;
+}
+
+inline void appendString(std::string & out, char value) {
+    out += value;
+}
+
+inline void appendString(std::string & out, bool value) {
+    out += value ? "true" : "false";
+}
+
+template <typename T>
+typename std::enable_if<std::is_integral<T>::value && !std::is_same<T, bool>::value && !std::is_same<T, char>::value>::type
+appendString(std::string & out, T value) {
+    appendInteger(out, value);
+}
+
+template <typename T>
+typename std::enable_if<std::is_floating_point<T>::value>::type
+appendString(std::string & out, T value) {
+    appendNumber(out, value);
+}
+
+/**
+ * Get per-thread scratch index reused by Array::unique, so repeated calls
+ * do not allocate. Very large indexes are released by the caller.
+ *
+ * @returns Scratch index.
+ */
+inline std::vector<uint32_t> & uniqueScratch() {
+    static thread_local std::vector<uint32_t> scratch;
+    return scratch;
+}
+
+/**
+ * Overload priority tag for invokeCallback: higher arity is tried first.
+ */
+template <int N> struct CallbackArity : CallbackArity<N - 1> {};
+template <> struct CallbackArity<0> {};
+
+template <typename F, typename E, typename I, typename A>
+auto invokeCallback(F & f, E & element, const I & index, A & array, CallbackArity<3>) -> decltype(f(element, index, array)) {
+    return f(element, index, array);
+}
+
+template <typename F, typename E, typename I, typename A>
+auto invokeCallback(F & f, E & element, const I & index, A &, CallbackArity<2>) -> decltype(f(element, index)) {
+    return f(element, index);
+}
+
+template <typename F, typename E, typename I, typename A>
+auto invokeCallback(F & f, E & element, const I &, A &, CallbackArity<1>) -> decltype(f(element)) {
+    return f(element);
+}
+
+/**
+ * Call JS-style callback with as many of (element, index, array) arguments
+ * as it accepts. Arity is resolved at compile time, so callbacks which take
+ * only an element pay nothing for the rest.
+ *
+ * @param f Callback.
+ * @param element Element.
+ * @param index Element's index (or key, for Map).
+ * @param array Array (or collection) being iterated.
+ * @returns Callback's result.
+ */
+template <typename F, typename E, typename I, typename A>
+auto invokeCallback(F & f, E & element, const I & index, A & array) -> decltype(invokeCallback(f, element, index, array, CallbackArity<3>())) {
+    return invokeCallback(f, element, index, array, CallbackArity<3>());
+}
+
+template <typename F, typename R, typename E, typename A>
+auto invokeReducer(F & f, R & accumulator, E & element, size_t index, A & array, CallbackArity<3>) -> decltype(f(accumulator, element, index, array)) {
+    return f(accumulator, element, index, array);
+}
+
+template <typename F, typename R, typename E, typename A>
+auto invokeReducer(F & f, R & accumulator, E & element, size_t index, A &, CallbackArity<2>) -> decltype(f(accumulator, element, index)) {
+    return f(accumulator, element, index);
+}
+
+template <typename F, typename R, typename E, typename A>
+auto invokeReducer(F & f, R & accumulator, E & element, size_t, A &, CallbackArity<1>) -> decltype(f(accumulator, element)) {
+    return f(accumulator, element);
+}
+
+/**
+ * Call JS-style reducer with as many of (accumulator, element, index, array)
+ * arguments as it accepts.
+ *
+ * @param f Reducer.
+ * @param accumulator Accumulated value.
+ * @param element Element.
+ * @param index Element's index.
+ * @param array Array being reduced.
+ * @returns Reducer's result.
+ */
+template <typename F, typename R, typename E, typename A>
+auto invokeReducer(F & f, R & accumulator, E & element, size_t index, A & array) -> decltype(invokeReducer(f, accumulator, element, index, array, CallbackArity<3>())) {
+    return invokeReducer(f, accumulator, element, index, array, CallbackArity<3>());
+}
+
+template <typename T> class Array;
+
+template <typename T> class ParallelAlgorithms;
+
+/**
+ * Packed array of booleans, see bit_array.hpp.
+ */
+template <> class Array<bool>;
+
 /**
  * JS-style array.
  * @see https://developer.mozilla.org/en-US/docs/JavaScript/Reference/Global_Objects/Array
@@ -46,14 +444,64 @@ namespace js4cpp {
  */
 template <typename T> class Array
 {
+    /**
+     * Type of keys given function generates for elements.
+     */
+    template <typename KeyFn> struct GroupKey {
+        typedef typename std::decay<decltype(invokeCallback(std::declval<KeyFn &>(),
+            std::declval<const T &>(), size_t(), std::declval<const Array<T> &>()))>::type type;
+    };
+
+    /**
+     * Type of elements map generates: R if given explicitly, callback's
+     * result type otherwise.
+     */
+    template <typename R, typename F> struct MapResult {
+        typedef R type;
+    };
+
+    template <typename F> struct MapResult<void, F> {
+        typedef typename std::decay<decltype(invokeCallback(std::declval<F &>(),
+            std::declval<const T &>(), size_t(), std::declval<const Array<T> &>()))>::type type;
+    };
+
+    template <typename U> friend class ParallelAlgorithms;
+
 public:
+    /**
+     * Iterator over the array's elements.
+     */
+    typedef T * iterator;
+
+    /**
+     * Read-only iterator over the array's elements.
+     */
+    typedef const T * const_iterator;
+
+    typedef T value_type;
+    typedef T & reference;
+    typedef const T & const_reference;
+    typedef size_t size_type;
+
     /**
      * Create new array with given preallocated length.
      * @see https://developer.mozilla.org/en-US/docs/JavaScript/Reference/Global_Objects/Array#Syntax
      *
      * @param length Length.
      */
-    explicit Array(size_t length = 0) : data_(length) {}
+    explicit Array(size_t length = 0) : data_(length, T()) {}
+
+    /**
+     * Create new array with given length leaving elements uninitialized.
+     * Only available for trivial types; elements must be written before
+     * they are read.
+     *
+     * @param length Length.
+     */
+    Array(size_t length, Uninitialized) : data_(length) {
+        static_assert(std::is_trivial<T>::value,
+            "Uninitialized arrays are only allowed for trivial types");
+    }
 
     /**
      * Create new array from iterators range.
@@ -81,12 +529,82 @@ public:
         //  a.length; // -> 100
 #ifndef INTOLERANT_TO_OUT_OF_RANGE_INDEXES
         if (i >= data_.size()) {
-            data_.resize(i + 1);
+            data_.resize(i + 1, T());
         }
 #endif
         return data_[i];
     }
 
+    /**
+     * Create new array from any iterable (anything std::begin/std::end accept).
+     * @see https://developer.mozilla.org/en-US/docs/JavaScript/Reference/Global_Objects/Array/from
+     *
+     * @tparam Iterable Source type.
+     * @param iterable Source.
+     * @returns New array.
+     */
+    template <typename Iterable>
+    static Array<T> from(const Iterable & iterable) {
+        return Array<T>(std::begin(iterable), std::end(iterable));
+    }
+
+    /**
+     * Create new array from any iterable mapping every element. Elements are
+     * constructed in place from mapping function's results.
+     * @see https://developer.mozilla.org/en-US/docs/JavaScript/Reference/Global_Objects/Array/from
+     *
+     * @tparam Iterable Source type.
+     * @tparam MapFn Mapping function type.
+     * @param iterable Source.
+     * @param mapFn Function producing new array's element from source's one.
+     * @returns New array.
+     */
+    template <typename Iterable, typename MapFn>
+    static typename std::enable_if<!std::is_integral<Iterable>::value, Array<T> >::type
+    from(const Iterable & iterable, MapFn mapFn) {
+        Array<T> result;
+
+        reserveFor(result.data_, std::begin(iterable), std::end(iterable));
+        for (auto it = std::begin(iterable); it != std::end(iterable); ++it) {
+            result.data_.emplace_back(mapFn(*it));
+        }
+
+        return result;
+    }
+
+    /**
+     * Create new array of given length generating every element from its
+     * index, i.e. `Array.from({length: length}, (_, i) => ...)`.
+     * @see https://developer.mozilla.org/en-US/docs/JavaScript/Reference/Global_Objects/Array/from
+     *
+     * @tparam Generator Generator type.
+     * @param length Length.
+     * @param generator Function producing element from its index.
+     * @returns New array.
+     */
+    template <typename Generator>
+    static Array<T> from(size_t length, Generator generator) {
+        return generate(length, generator, std::is_trivial<T>());
+    }
+
+    /**
+     * Create new array from given elements.
+     * @see https://developer.mozilla.org/en-US/docs/JavaScript/Reference/Global_Objects/Array/of
+     *
+     * @param items Elements.
+     * @returns New array.
+     */
+    template <typename... Args>
+    static Array<T> of(Args &&... items) {
+        Array<T> result;
+
+        result.data_.reserve(sizeof...(items));
+        int expand[] = { 0, (result.data_.emplace_back(std::forward<Args>(items)), 0)... };
+        (void) expand;
+
+        return result;
+    }
+
 
     /**
      * Get index of given item.
@@ -168,6 +686,45 @@ public:
         std::reverse(data_.begin(), data_.end());
     }
 
+    /**
+     * Fill elements from start to end (not including) with given value.
+     * Negative indexes are counted from the end of the array.
+     * @see https://developer.mozilla.org/en-US/docs/JavaScript/Reference/Global_Objects/Array/fill
+     *
+     * @param value Value.
+     * @param start Start index.
+     * @param end End index. If not specified, filling stops at the end of the array.
+     */
+    void fill(const T & value, ssize_t start = 0, ssize_t end = std::numeric_limits<ssize_t>::max()) {
+        size_t from = relativeIndex(start), to = relativeIndex(end);
+
+        if (from < to) {
+            fillRange(from, to, value, std::is_trivially_copyable<T>());
+        }
+    }
+
+    /**
+     * Copy elements from start to end (not including) to position starting at target.
+     * Length of the array stays the same. Negative indexes are counted from
+     * the end of the array.
+     * @see https://developer.mozilla.org/en-US/docs/JavaScript/Reference/Global_Objects/Array/copyWithin
+     *
+     * @param target Index to copy elements to.
+     * @param start Index of the first element to copy.
+     * @param end Index to stop copying at. If not specified, copying stops at the end of the array.
+     */
+    void copyWithin(ssize_t target, ssize_t start = 0, ssize_t end = std::numeric_limits<ssize_t>::max()) {
+        size_t to = relativeIndex(target), from = relativeIndex(start), last = relativeIndex(end);
+
+        if (from >= last || to >= data_.size()) {
+            return;
+        }
+
+        size_t count = std::min(last - from, data_.size() - to);
+
+        copyRange(from, from + count, to, std::is_trivially_copyable<T>());
+    }
+
 
     /**
      * Create subarray bounded by begin and end indexes.
@@ -209,33 +766,258 @@ public:
         std::sort(data_.begin(), data_.end(), comparator);
     }
 
+    /**
+     * Create sorted copy of the array. The copy is sorted in its own buffer
+     * right after the elements are copied into it.
+     * @see https://developer.mozilla.org/en-US/docs/JavaScript/Reference/Global_Objects/Array/toSorted
+     *
+     * @param comparator Comparator.
+     * @returns Sorted array.
+     */
+    Array<T> toSorted(std::tr1::function<bool(const T &, const T &)> comparator = std::less<T>()) const & {
+        Array<T> result(*this);
+        std::sort(result.data_.begin(), result.data_.end(), comparator);
+        return result;
+    }
+
+    /**
+     * Sort temporary array in place and hand its buffer over to the result.
+     *
+     * @param comparator Comparator.
+     * @returns Sorted array.
+     */
+    Array<T> toSorted(std::tr1::function<bool(const T &, const T &)> comparator = std::less<T>()) && {
+        std::sort(data_.begin(), data_.end(), comparator);
+        return std::move(*this);
+    }
+
+    /**
+     * Create copy of the array with elements in reverse order. Elements are
+     * copied in reverse order directly.
+     * @see https://developer.mozilla.org/en-US/docs/JavaScript/Reference/Global_Objects/Array/toReversed
+     *
+     * @returns Reversed array.
+     */
+    Array<T> toReversed() const & {
+        return Array<T>(data_.rbegin(), data_.rend());
+    }
+
+    /**
+     * Reverse temporary array in place and hand its buffer over to the result.
+     *
+     * @returns Reversed array.
+     */
+    Array<T> toReversed() && {
+        reverse();
+        return std::move(*this);
+    }
+
+    /**
+     * Remove repeated elements in place, keeping first occurrences in
+     * order. Elements are compared with SameValueZero, like in a Set, using
+     * a hash index of positions of kept elements, so nothing is copied into
+     * a table.
+     */
+    void unique() {
+        T * data = data_.data();
+        size_t length = data_.size(), kept = 0, capacity = 16;
+        unsigned shift = 60;
+
+        if (length >= std::numeric_limits<uint32_t>::max()) {
+            throw std::length_error("Array is too long to deduplicate");
+        }
+        while (capacity < length * 2) {
+            capacity *= 2;
+            --shift;
+        }
+
+        std::vector<uint32_t> & index = uniqueScratch();
+        index.assign(capacity, 0);
+
+        for (size_t i = 0; i < length; ++i) {
+            uint64_t hash = SameValueZeroHash<T>()(data[i]);
+
+            for (size_t slot = (hash * 0x9e3779b97f4a7c15ULL) >> shift;; slot = (slot + 1) & (capacity - 1)) {
+                uint32_t position = index[slot];
+
+                if (position == 0) {
+                    if (kept != i) {
+                        data[kept] = std::move(data[i]);
+                    }
+                    index[slot] = static_cast<uint32_t>(++kept);
+                    break;
+                }
+                if (sameValueZero(data[position - 1], data[i])) {
+                    break;
+                }
+            }
+        }
+
+        if (capacity > (1 << 20)) {
+            std::vector<uint32_t>().swap(index);
+        }
+        data_.erase(data_.begin() + kept, data_.end());
+    }
+
+    /**
+     * Create copy of the array without repeated elements.
+     *
+     * @returns Distinct elements in order of first occurrence.
+     */
+    Array<T> toUnique() const & {
+        Array<T> result(*this);
+        result.unique();
+        return result;
+    }
+
+    Array<T> toUnique() && {
+        unique();
+        return std::move(*this);
+    }
+
+    /**
+     * Remove repeated elements of a sorted array in place, in one linear
+     * pass. Numbers are compacted without branches.
+     */
+    void uniqueSorted() {
+        data_.erase(data_.begin() + uniqueSortedLength(std::is_arithmetic<T>()), data_.end());
+    }
+
+    /**
+     * Create copy of a sorted array without repeated elements.
+     *
+     * @returns Distinct elements.
+     */
+    Array<T> toUniqueSorted() const & {
+        Array<T> result(*this);
+        result.uniqueSorted();
+        return result;
+    }
+
+    Array<T> toUniqueSorted() && {
+        uniqueSorted();
+        return std::move(*this);
+    }
+
+    /**
+     * Create copy of the array with some elements removed and/or replaced
+     * by given items. Negative start is counted from the end of the array.
+     * @see https://developer.mozilla.org/en-US/docs/JavaScript/Reference/Global_Objects/Array/toSpliced
+     *
+     * @param start Index at which to start changing the array.
+     * @param skipCount Number of elements to remove.
+     * @param items Elements to insert at start.
+     * @returns New array.
+     */
+    template <typename... Args>
+    Array<T> toSpliced(ssize_t start, size_t skipCount, Args &&... items) const & {
+        size_t from = relativeIndex(start), to = from + std::min(skipCount, data_.size() - from);
+        Array<T> result;
+
+        result.data_.reserve(data_.size() - (to - from) + sizeof...(items));
+        result.data_.insert(result.data_.end(), data_.begin(), data_.begin() + from);
+        int expand[] = { 0, (result.data_.emplace_back(std::forward<Args>(items)), 0)... };
+        (void) expand;
+        result.data_.insert(result.data_.end(), data_.begin() + to, data_.end());
+
+        return result;
+    }
+
+    /**
+     * Splice temporary array in place and hand its buffer over to the result.
+     *
+     * @param start Index at which to start changing the array.
+     * @param skipCount Number of elements to remove.
+     * @param items Elements to insert at start.
+     * @returns New array.
+     */
+    template <typename... Args>
+    Array<T> toSpliced(ssize_t start, size_t skipCount, Args &&... items) && {
+        size_t from = relativeIndex(start), to = from + std::min(skipCount, data_.size() - from);
+        std::array<T, sizeof...(Args)> inserted = {{ T(std::forward<Args>(items))... }};
+        size_t count = inserted.size(), common = std::min(count, to - from);
+
+        std::move(inserted.begin(), inserted.begin() + common, data_.begin() + from);
+        if (common < to - from) {
+            data_.erase(data_.begin() + from + common, data_.begin() + to);
+        } else {
+            data_.insert(data_.begin() + to,
+                std::make_move_iterator(inserted.begin() + common),
+                std::make_move_iterator(inserted.begin() + count));
+        }
+
+        return std::move(*this);
+    }
+
+    /**
+     * Create copy of the array with element under given index replaced.
+     * Negative index is counted from the end of the array.
+     * @see https://developer.mozilla.org/en-US/docs/JavaScript/Reference/Global_Objects/Array/with
+     *
+     * @param index Index.
+     * @param value New value.
+     * @returns New array.
+     * @throws std::out_of_range If index is out of the array's bounds.
+     */
+    Array<T> with(ssize_t index, const T & value) const & {
+        size_t i = checkedIndex(index);
+        Array<T> result;
+
+        result.data_.reserve(data_.size());
+        result.data_.insert(result.data_.end(), data_.begin(), data_.begin() + i);
+        result.data_.push_back(value);
+        result.data_.insert(result.data_.end(), data_.begin() + i + 1, data_.end());
+
+        return result;
+    }
+
+    /**
+     * Replace element of temporary array in place and hand its buffer over
+     * to the result.
+     *
+     * @param index Index.
+     * @param value New value.
+     * @returns New array.
+     * @throws std::out_of_range If index is out of the array's bounds.
+     */
+    Array<T> with(ssize_t index, const T & value) && {
+        data_[checkedIndex(index)] = value;
+        return std::move(*this);
+    }
+
 
     /**
      * Iterate over all elements and call callback for every one.
+     * Like all iteration methods below, callback may accept (element),
+     * (element, index) or (element, index, array).
      * @see https://developer.mozilla.org/en-US/docs/JavaScript/Reference/Global_Objects/Array/forEach
      *
      * @param callback Callback.
      */
-    void forEach(std::tr1::function<void(T &)> callback) {
-        std::for_each(data_.begin(), data_.end(), callback);
+    template <typename F>
+    void forEach(F callback) {
+        T * data = data_.data();
+
+        for (size_t i = 0, length = data_.size(); i < length; ++i) {
+            invokeCallback(callback, data[i], i, *this);
+        }
     }
 
     /**
      * Creates a new array with the results of calling a provided function on every element in this array.
      * @see https://developer.mozilla.org/en-US/docs/JavaScript/Reference/Global_Objects/Array/map
      *
-     * @tparam R New array's element type.
+     * @tparam R New array's element type. Deduced from callback if not specified.
      * @param callback Function generates new array's element from this array's one.
      * @returns New array.
      */
-    template <typename R>
-    Array<R> map(std::tr1::function<R(const T &)> callback) const {
-        Array<R> result(length());
+    template <typename R = void, typename F>
+    Array<typename MapResult<R, F>::type> map(F callback) const {
+        const T * data = data_.data();
 
-        std::transform(data_.begin(), data_.end(),
-            result.data_.begin(), callback);
-
-        return result;
+        return Array<typename MapResult<R, F>::type>::from(data_.size(), [&] (size_t i) {
+            return invokeCallback(callback, data[i], i, *this);
+        });
     }
 
     /**
@@ -245,8 +1027,17 @@ public:
      * @param condition Test implementation.
      * @returns `true` if all elements passed the test and `false` otherwise.
      */
-    bool every(std::tr1::function<bool(const T &)> condition) const {
-        return std::find_if(data_.begin(), data_.end(), std::not1(condition)) == data_.end();
+    template <typename F>
+    bool every(F condition) const {
+        const T * data = data_.data();
+
+        for (size_t i = 0, length = data_.size(); i < length; ++i) {
+            if (!invokeCallback(condition, data[i], i, *this)) {
+                return false;
+            }
+        }
+
+        return true;
     }
 
     /**
@@ -256,8 +1047,17 @@ public:
      * @param condition Test implementation.
      * @returns `true` if at least one element passed the test and `false` otherwise.
      */
-    bool some(std::tr1::function<bool(const T &)> condition) const {
-        return std::find_if(data_.begin(), data_.end(), condition) != data_.end();
+    template <typename F>
+    bool some(F condition) const {
+        const T * data = data_.data();
+
+        for (size_t i = 0, length = data_.size(); i < length; ++i) {
+            if (invokeCallback(condition, data[i], i, *this)) {
+                return true;
+            }
+        }
+
+        return false;
     }
 
     /**
@@ -267,16 +1067,205 @@ public:
      * @param test Test implementation.
      * @returns New array.
      */
-    Array<T> filter(std::tr1::function<bool(const T &)> test) const {
+    template <typename F>
+    typename std::enable_if<!std::is_same<F, Array<bool> >::value, Array<T> >::type
+    filter(F test) const {
+        const T * data = data_.data();
+        Array<T> result;
+
+        for (size_t i = 0, length = data_.size(); i < length; ++i) {
+            if (invokeCallback(test, data[i], i, *this)) {
+                result.data_.push_back(data[i]);
+            }
+        }
+
+        return result;
+    }
+
+    /**
+     * Create new array of elements where mask is true. Mask is read a word
+     * (64 elements) at a time, and set bits are visited with
+     * count-trailing-zeros, so sparse masks skip unselected runs.
+     *
+     * @tparam Mask Array<bool>.
+     * @param mask Mask; elements past its end are not selected.
+     * @returns New array.
+     */
+    template <typename Mask>
+    typename std::enable_if<std::is_same<Mask, Array<bool> >::value, Array<T> >::type
+    filter(const Mask & mask) const {
+        const T * data = data_.data();
+        const typename Mask::Word * words = mask.words();
+        size_t length = std::min(data_.size(), mask.length());
         Array<T> result;
 
-        std::remove_copy_if(data_.begin(), data_.end(),
-            std::back_inserter(result.data_),
-            std::not1(test));
+        result.data_.reserve(mask.count());
+        for (size_t w = 0; w * Mask::WORD_BITS < length; ++w) {
+            typename Mask::Word bits = words[w];
+
+            if (length - w * Mask::WORD_BITS < Mask::WORD_BITS) {
+                bits &= (typename Mask::Word(1) << (length - w * Mask::WORD_BITS)) - 1;
+            }
+            for (; bits != 0; bits &= bits - 1) {
+                result.data_.push_back(data[w * Mask::WORD_BITS + __builtin_ctzll(bits)]);
+            }
+        }
+
+        return result;
+    }
+
+    /**
+     * Same as filter(mask).
+     *
+     * @param mask Mask; elements past its end are not selected.
+     * @returns New array.
+     */
+    Array<T> select(const Array<bool> & mask) const {
+        return filter(mask);
+    }
+
+    /**
+     * Create new array of elements under given indexes, so that result[i] is
+     * this[indices[i]]. Elements a few iterations ahead are prefetched, which
+     * hides most of the cache misses of random indexes.
+     *
+     * @tparam I Integral index type.
+     * @param indices Indexes to read.
+     * @returns New array of indices' length.
+     * @throws std::out_of_range If some index is out of the array's bounds.
+     */
+    template <typename I>
+    Array<T> gather(const Array<I> & indices) const {
+        Array<T> result = allocate(indices.length(), std::is_trivial<T>());
+
+        gatherRange(indices.begin(), result.data_.data(), 0, indices.length());
+
+        return result;
+    }
+
+    /**
+     * Write values under given indexes, so that this[indices[i]] becomes
+     * values[i]. When an index repeats, the last value wins.
+     *
+     * @tparam I Integral index type.
+     * @param indices Indexes to write.
+     * @param values Values, one per index.
+     * @throws std::invalid_argument If lengths of indices and values differ.
+     * @throws std::out_of_range If some index is out of the array's bounds;
+     *         values before it are already written.
+     */
+    template <typename I>
+    void scatter(const Array<I> & indices, const Array<T> & values) {
+        if (indices.length() != values.length()) {
+            throw std::invalid_argument("Scatter indices and values lengths differ");
+        }
+
+        const I * index = indices.begin();
+        const T * value = values.begin();
+        T * data = data_.data();
+        size_t count = indices.length(), length = data_.size();
+
+        for (size_t i = 0; i < count; ++i) {
+            if (i + PREFETCH_DISTANCE < count) {
+                __builtin_prefetch(data + prefetchIndex(index[i + PREFETCH_DISTANCE], length), 1);
+            }
+            if (static_cast<size_t>(index[i]) >= length) {
+                throw std::out_of_range("Scatter index out of range");
+            }
+            data[index[i]] = value[i];
+        }
+    }
+
+    /**
+     * Reorder elements in place, so that this[i] becomes old this[order[i]].
+     * Elements are moved along the permutation's cycles, each one exactly
+     * once, without copying the array.
+     *
+     * @tparam I Integral index type.
+     * @param order Permutation of the array's indexes.
+     * @throws std::invalid_argument If order is not a permutation of the
+     *         array's indexes; the array is left unchanged.
+     */
+    template <typename I>
+    void permute(const Array<I> & order) {
+        size_t length = data_.size();
+
+        if (order.length() != length) {
+            throw std::invalid_argument("Permutation length differs from array length");
+        }
+
+        const I * index = order.begin();
+        std::vector<bool> pending(length);
+
+        for (size_t i = 0; i < length; ++i) {
+            size_t j = index[i];
+
+            if (j >= length || pending[j]) {
+                throw std::invalid_argument("Order is not a permutation");
+            }
+            pending[j] = true;
+        }
+
+        for (size_t start = 0; start < length; ++start) {
+            if (!pending[start]) {
+                continue;
+            }
+
+            T saved = std::move(data_[start]);
+            size_t j = start;
+
+            for (size_t next = index[j]; next != start; j = next, next = index[j]) {
+                data_[j] = std::move(data_[next]);
+                pending[j] = false;
+            }
+            data_[j] = std::move(saved);
+            pending[j] = false;
+        }
+    }
+
+    /**
+     * Split the array into elements passed the test and the rest. Test is
+     * run once per element; both parts are allocated with exact sizes.
+     *
+     * @tparam Predicate Test implementation type.
+     * @param test Test implementation.
+     * @returns Pair of arrays: passed elements and failed ones.
+     */
+    template <typename Predicate>
+    std::pair<Array<T>, Array<T> > partition(Predicate test) const {
+        std::vector<char> passed(data_.size());
+        size_t count = 0;
+
+        for (size_t i = 0; i < data_.size(); ++i) {
+            count += passed[i] = invokeCallback(test, data_[i], i, *this) ? 1 : 0;
+        }
+
+        std::pair<Array<T>, Array<T> > result;
+
+        result.first.data_.reserve(count);
+        result.second.data_.reserve(data_.size() - count);
+        for (size_t i = 0; i < data_.size(); ++i) {
+            (passed[i] ? result.first : result.second).data_.push_back(data_[i]);
+        }
 
         return result;
     }
 
+    /**
+     * Group elements by keys generated by given function. Order of elements
+     * inside every group is preserved; every group is allocated once with
+     * its exact size.
+     * @see https://developer.mozilla.org/en-US/docs/Web/JavaScript/Reference/Global_Objects/Map/groupBy
+     *
+     * @tparam KeyFn Key function type.
+     * @param keyFn Function generating key for an element.
+     * @returns Map from keys to groups.
+     */
+    template <typename KeyFn>
+    std::unordered_map<typename GroupKey<KeyFn>::type, Array<T> > groupBy(KeyFn keyFn) const {
+        return groupRange(0, data_.size(), keyFn);
+    }
+
     /**
      * Apply a function against an accumulator and each value of the array (from left-to-right) as to reduce it to a single value.
      * @see https://developer.mozilla.org/en-US/docs/JavaScript/Reference/Global_Objects/Array/reduce
@@ -284,7 +1273,8 @@ public:
      * @param callback Function to execute on each value in the array.
      * @returns Accumulated value.
      */
-    T reduce(std::tr1::function<T(const T &, const T &)> callback = std::plus<T>()) const {
+    template <typename F = std::plus<T> >
+    T reduce(F callback = F()) const {
         return reduce(callback, data_[0], 1);
     }
 
@@ -297,8 +1287,37 @@ public:
      * @param startFrom Index from which iteration will start.
      * @returns Accumulated value.
      */
-    T reduce(std::tr1::function<T(const T &, const T &)> callback, const T & initialValue, size_t startFrom = 0) const {
-        return std::accumulate(data_.begin() + startFrom, data_.end(), initialValue, callback);
+    template <typename F>
+    T reduce(F callback, const T & initialValue, size_t startFrom = 0) const {
+        const T * data = data_.data();
+        T accumulator = initialValue;
+
+        for (size_t i = startFrom, length = data_.size(); i < length; ++i) {
+            accumulator = invokeReducer(callback, accumulator, data[i], i, *this);
+        }
+
+        return accumulator;
+    }
+
+    /**
+     * Join string forms of all elements, separated by a separator.
+     * @see https://developer.mozilla.org/en-US/docs/Web/JavaScript/Reference/Global_Objects/Array/join
+     *
+     * @param separator Separator.
+     * @returns Joined string.
+     */
+    std::string join(const std::string & separator = ",") const {
+        std::string result;
+        const T * data = data_.data();
+
+        for (size_t i = 0, length = data_.size(); i < length; ++i) {
+            if (i != 0) {
+                result += separator;
+            }
+            appendString(result, data[i]);
+        }
+
+        return result;
     }
 
     /**
@@ -311,8 +1330,277 @@ public:
         return data_.size();
     }
 
+    /**
+     * Get iterator to the first element.
+     *
+     * @returns Iterator.
+     */
+    iterator begin() {
+        return data_.data();
+    }
+
+    /**
+     * Get iterator past the last element.
+     *
+     * @returns Iterator.
+     */
+    iterator end() {
+        return data_.data() + data_.size();
+    }
+
+    /**
+     * Get read-only iterator to the first element.
+     *
+     * @returns Iterator.
+     */
+    const_iterator begin() const {
+        return data_.data();
+    }
+
+    /**
+     * Get read-only iterator past the last element.
+     *
+     * @returns Iterator.
+     */
+    const_iterator end() const {
+        return data_.data() + data_.size();
+    }
+
+    /**
+     * Get range of the array's indexes.
+     * @see https://developer.mozilla.org/en-US/docs/JavaScript/Reference/Global_Objects/Array/keys
+     *
+     * @returns Range.
+     */
+    Range<KeyIterator> keys() const {
+        return Range<KeyIterator>(KeyIterator(0), KeyIterator(data_.size()));
+    }
+
+    /**
+     * Get range of the array's elements.
+     * @see https://developer.mozilla.org/en-US/docs/JavaScript/Reference/Global_Objects/Array/values
+     *
+     * @returns Range.
+     */
+    Range<iterator> values() {
+        return Range<iterator>(begin(), end());
+    }
+
+    /**
+     * Get read-only range of the array's elements.
+     * @see https://developer.mozilla.org/en-US/docs/JavaScript/Reference/Global_Objects/Array/values
+     *
+     * @returns Range.
+     */
+    Range<const_iterator> values() const {
+        return Range<const_iterator>(begin(), end());
+    }
+
+    /**
+     * Get range of (index, element) pairs.
+     * @see https://developer.mozilla.org/en-US/docs/JavaScript/Reference/Global_Objects/Array/entries
+     *
+     * @returns Range.
+     */
+    Range<EntryIterator<T> > entries() {
+        return Range<EntryIterator<T> >(EntryIterator<T>(begin(), 0), EntryIterator<T>(begin(), data_.size()));
+    }
+
+    /**
+     * Get read-only range of (index, element) pairs.
+     * @see https://developer.mozilla.org/en-US/docs/JavaScript/Reference/Global_Objects/Array/entries
+     *
+     * @returns Range.
+     */
+    Range<EntryIterator<const T> > entries() const {
+        return Range<EntryIterator<const T> >(EntryIterator<const T>(begin(), 0), EntryIterator<const T>(begin(), data_.size()));
+    }
+
 private:
-    std::vector<T> data_;
+    typedef std::vector<T, DefaultInitAllocator<T> > Storage;
+
+    /**
+     * Group elements in [begin, end) in two passes: the first one assigns
+     * every element a group id and counts group sizes, the second one
+     * scatters elements to exactly sized groups.
+     */
+    template <typename KeyFn>
+    std::unordered_map<typename GroupKey<KeyFn>::type, Array<T> > groupRange(size_t begin, size_t end, KeyFn & keyFn) const {
+        typedef typename GroupKey<KeyFn>::type Key;
+
+        std::unordered_map<Key, size_t> ids;
+        std::vector<size_t> groupOf(end - begin), sizes;
+
+        for (size_t i = begin; i < end; ++i) {
+            auto inserted = ids.insert(std::make_pair(invokeCallback(keyFn, data_[i], i, *this), sizes.size()));
+            if (inserted.second) {
+                sizes.push_back(0);
+            }
+            ++sizes[groupOf[i - begin] = inserted.first->second];
+        }
+
+        std::unordered_map<Key, Array<T> > result(ids.size());
+        std::vector<Storage *> groups(ids.size());
+
+        for (auto it = ids.begin(); it != ids.end(); ++it) {
+            groups[it->second] = &result[it->first].data_;
+            groups[it->second]->reserve(sizes[it->second]);
+        }
+        for (size_t i = begin; i < end; ++i) {
+            groups[groupOf[i - begin]]->push_back(data_[i]);
+        }
+
+        return result;
+    }
+
+    /**
+     * Convert JS-style relative index (negative ones are counted from the
+     * end) to absolute one clamped to [0, length].
+     */
+    size_t relativeIndex(ssize_t index) const {
+        return js4cpp::relativeIndex(index, data_.size());
+    }
+
+    /**
+     * Convert JS-style relative index to absolute one.
+     *
+     * @throws std::out_of_range If index is out of the array's bounds.
+     */
+    size_t checkedIndex(ssize_t index) const {
+        ssize_t length = data_.size();
+
+        if (index < -length || index >= length) {
+            throw std::out_of_range("Array index out of range");
+        }
+
+        return index < 0 ? index + length : index;
+    }
+
+    /**
+     * How many iterations ahead gather and scatter prefetch elements.
+     */
+    static const size_t PREFETCH_DISTANCE = 16;
+
+    /**
+     * Clamp index to be prefetched into the array's bounds, so that the
+     * prefetched address is always valid.
+     */
+    template <typename I>
+    static size_t prefetchIndex(I index, size_t length) {
+        return static_cast<size_t>(index) < length ? static_cast<size_t>(index) : 0;
+    }
+
+    template <typename I>
+    void gatherRange(const I * indices, T * out, size_t begin, size_t end) const {
+        const T * data = data_.data();
+        size_t length = data_.size();
+
+        for (size_t i = begin; i < end; ++i) {
+            if (i + PREFETCH_DISTANCE < end) {
+                __builtin_prefetch(data + prefetchIndex(indices[i + PREFETCH_DISTANCE], length));
+            }
+            if (static_cast<size_t>(indices[i]) >= length) {
+                throw std::out_of_range("Gather index out of range");
+            }
+            out[i] = data[indices[i]];
+        }
+    }
+
+    static Array<T> allocate(size_t length, std::true_type) {
+        return Array<T>(length, Uninitialized());
+    }
+
+    static Array<T> allocate(size_t length, std::false_type) {
+        return Array<T>(length);
+    }
+
+    template <typename Iterator>
+    static void reserveFor(Storage & storage, Iterator begin, Iterator end, std::forward_iterator_tag) {
+        storage.reserve(std::distance(begin, end));
+    }
+
+    template <typename Iterator>
+    static void reserveFor(Storage &, Iterator, Iterator, std::input_iterator_tag) {}
+
+    template <typename Iterator>
+    static void reserveFor(Storage & storage, Iterator begin, Iterator end) {
+        reserveFor(storage, begin, end, typename std::iterator_traits<Iterator>::iterator_category());
+    }
+
+    size_t uniqueSortedLength(std::true_type) {
+        T * data = data_.data();
+        size_t length = data_.size(), kept = length != 0;
+
+        // Every element is written to the next free place, which only
+        // advances when it differs from the previous kept one.
+        for (size_t i = 1; i < length; ++i) {
+            T value = data[i];
+            data[kept] = value;
+            kept += !sameValueZero(value, data[kept - 1]);
+        }
+
+        return kept;
+    }
+
+    size_t uniqueSortedLength(std::false_type) {
+        return std::unique(data_.begin(), data_.end(), sameValueZero<T>) - data_.begin();
+    }
+
+    template <typename Generator>
+    static Array<T> generate(size_t length, Generator & generator, std::true_type) {
+        // Trivial elements are written exactly once, in a plain counted loop.
+        Array<T> result(length, Uninitialized());
+        T * data = result.data_.data();
+
+        for (size_t i = 0; i < length; ++i) {
+            data[i] = generator(i);
+        }
+
+        return result;
+    }
+
+    template <typename Generator>
+    static Array<T> generate(size_t length, Generator & generator, std::false_type) {
+        Array<T> result;
+
+        result.data_.reserve(length);
+        for (size_t i = 0; i < length; ++i) {
+            result.data_.emplace_back(generator(i));
+        }
+
+        return result;
+    }
+
+    void fillRange(size_t from, size_t to, const T & value, std::true_type) {
+        const unsigned char * bytes = reinterpret_cast<const unsigned char *>(&value);
+
+        // Single-byte patterns (including any all-zero value) go to memset.
+        if (std::count(bytes, bytes + sizeof(T), bytes[0]) == static_cast<ssize_t>(sizeof(T))) {
+            std::memset(&data_[from], bytes[0], (to - from) * sizeof(T));
+        } else {
+            std::fill(data_.begin() + from, data_.begin() + to, value);
+        }
+    }
+
+    void fillRange(size_t from, size_t to, const T & value, std::false_type) {
+        std::fill(data_.begin() + from, data_.begin() + to, value);
+    }
+
+    void copyRange(size_t from, size_t to, size_t target, std::true_type) {
+        std::memmove(&data_[target], &data_[from], (to - from) * sizeof(T));
+    }
+
+    void copyRange(size_t from, size_t to, size_t target, std::false_type) {
+        if (target < from) {
+            std::copy(data_.begin() + from, data_.begin() + to, data_.begin() + target);
+        } else {
+            std::copy_backward(data_.begin() + from, data_.begin() + to, data_.begin() + target + (to - from));
+        }
+    }
+
+    Storage data_;
 };
 
 } // namespace js4cpp
+
+#include "bit_array.hpp"
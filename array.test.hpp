@@ -1,6 +1,10 @@
 #pragma once
 
+#include <algorithm>
+#include <cmath>
 #include <functional>
+#include <numeric>
+#include <stdexcept>
 #include <string>
 #include <tr1/functional>
 
@@ -10,6 +14,7 @@
 #include <cppunit/extensions/HelperMacros.h>
 
 #include "array.hpp"
+#include "parallel.hpp"
 
 class ArrayTest : public CppUnit::TestCase
 {
@@ -19,10 +24,7 @@ public:
     void setUp() {
         arr = new js4cpp::Array<int>(10);
 
-        int count = 0;
-        arr->forEach([&count] (int & item) {
-            item = count++;
-        });
+        std::iota(arr->begin(), arr->end(), 0);
     }
 
     void testLength() {
@@ -117,6 +119,303 @@ public:
         CPPUNIT_ASSERT( arr->length() == 10 );
     }
 
+    void testFill() {
+        arr->fill(7, 2, -2);
+        CPPUNIT_ASSERT( (*arr)[1] == 1 && (*arr)[2] == 7 && (*arr)[7] == 7 && (*arr)[8] == 8 );
+
+        arr->fill(0);
+        CPPUNIT_ASSERT( arr->indexOf(0) == 0 && arr->lastIndexOf(0) == 9 );
+
+        js4cpp::Array<std::string> strings(3);
+        strings.fill("js", 1);
+        CPPUNIT_ASSERT( strings[0] == "" && strings[1] == "js" && strings[2] == "js" );
+    }
+
+    void testCopyWithin() {
+        arr->copyWithin(0, 3, 5);
+        CPPUNIT_ASSERT( (*arr)[0] == 3 && (*arr)[1] == 4 && (*arr)[2] == 2 );
+
+        arr->copyWithin(6, 4);
+        CPPUNIT_ASSERT( (*arr)[6] == 4 && (*arr)[9] == 7 && arr->length() == 10 );
+
+        js4cpp::Array<std::string> strings = js4cpp::Array<std::string>::of("a", "b", "c");
+        strings.copyWithin(1);
+        CPPUNIT_ASSERT( strings[0] == "a" && strings[1] == "a" && strings[2] == "b" );
+    }
+
+    void testFrom() {
+        using js4cpp::Array;
+
+        Array<int> squares = Array<int>::from(4, [] (size_t i) { return int(i * i); });
+        CPPUNIT_ASSERT( squares.length() == 4 && squares[3] == 9 );
+
+        Array<std::string> strings = Array<std::string>::from(2, [] (size_t i) {
+            return std::string(i + 1, 'x');
+        });
+        CPPUNIT_ASSERT( strings[0] == "x" && strings[1] == "xx" );
+
+        const int source[] = { 1, 2, 3 };
+        Array<int> copy = Array<int>::from(source);
+        CPPUNIT_ASSERT( copy.length() == 3 && copy[2] == 3 );
+
+        Array<double> halves = Array<double>::from(source, [] (int x) { return x / 2.0; });
+        CPPUNIT_ASSERT( halves.length() == 3 && halves[0] == 0.5 );
+
+        Array<int> raw(5, js4cpp::Uninitialized());
+        raw.fill(1);
+        CPPUNIT_ASSERT( raw.length() == 5 && raw.reduce() == 5 );
+    }
+
+    void testOf() {
+        js4cpp::Array<int> a = js4cpp::Array<int>::of(3, 1, 2);
+        CPPUNIT_ASSERT( a.length() == 3 && a[0] == 3 && a[2] == 2 );
+
+        CPPUNIT_ASSERT( js4cpp::Array<int>::of().length() == 0 );
+    }
+
+    void testToSorted() {
+        using js4cpp::Array;
+
+        Array<int> sorted = arr->toSorted(std::greater<int>());
+        CPPUNIT_ASSERT( sorted[0] == 9 && sorted[9] == 0 );
+        CPPUNIT_ASSERT( (*arr)[0] == 0 );
+
+        Array<int> temporary = Array<int>::of(3, 1, 2).toSorted();
+        CPPUNIT_ASSERT( temporary[0] == 1 && temporary[1] == 2 && temporary[2] == 3 );
+    }
+
+    void testToReversed() {
+        using js4cpp::Array;
+
+        Array<int> reversed = arr->toReversed();
+        CPPUNIT_ASSERT( reversed.length() == 10 && reversed[0] == 9 && reversed[9] == 0 );
+        CPPUNIT_ASSERT( (*arr)[0] == 0 );
+
+        Array<int> temporary = Array<int>::of(1, 2).toReversed();
+        CPPUNIT_ASSERT( temporary[0] == 2 && temporary[1] == 1 );
+    }
+
+    void testToSpliced() {
+        using js4cpp::Array;
+
+        Array<int> removed = arr->toSpliced(2, 3);
+        CPPUNIT_ASSERT( removed.length() == 7 && removed[1] == 1 && removed[2] == 5 );
+
+        Array<int> replaced = arr->toSpliced(-2, 1, 42, 43, 44);
+        CPPUNIT_ASSERT( replaced.length() == 12 && replaced[8] == 42 && replaced[10] == 44 && replaced[11] == 9 );
+        CPPUNIT_ASSERT( arr->length() == 10 );
+
+        Array<int> shrunk = Array<int>::of(1, 2, 3, 4).toSpliced(1, 2, 7);
+        CPPUNIT_ASSERT( shrunk.length() == 3 && shrunk[1] == 7 && shrunk[2] == 4 );
+
+        Array<int> grown = Array<int>::of(1, 2).toSpliced(1, 0, 5, 6);
+        CPPUNIT_ASSERT( grown.length() == 4 && grown[1] == 5 && grown[2] == 6 && grown[3] == 2 );
+    }
+
+    void testWith() {
+        using js4cpp::Array;
+
+        Array<int> changed = arr->with(-1, 42);
+        CPPUNIT_ASSERT( changed.length() == 10 && changed[9] == 42 && changed[8] == 8 );
+        CPPUNIT_ASSERT( (*arr)[9] == 9 );
+
+        CPPUNIT_ASSERT( Array<int>::of(1, 2).with(0, 5)[0] == 5 );
+
+        bool thrown = false;
+        try {
+            arr->with(10, 0);
+        } catch (const std::out_of_range &) {
+            thrown = true;
+        }
+        CPPUNIT_ASSERT( thrown );
+    }
+
+    void testPartition() {
+        std::pair<js4cpp::Array<int>, js4cpp::Array<int> > parts = arr->partition([] (int x) { return x % 3 == 0; });
+
+        CPPUNIT_ASSERT( parts.first.length() == 4 && parts.first[1] == 3 && parts.first[3] == 9 );
+        CPPUNIT_ASSERT( parts.second.length() == 6 && parts.second[0] == 1 && parts.second[5] == 8 );
+    }
+
+    void testGroupBy() {
+        auto groups = arr->groupBy([] (int x) { return x % 3; });
+
+        CPPUNIT_ASSERT( groups.size() == 3 );
+        CPPUNIT_ASSERT( groups[0].length() == 4 && groups[0][3] == 9 );
+        CPPUNIT_ASSERT( groups[2].length() == 3 && groups[2][0] == 2 && groups[2][2] == 8 );
+    }
+
+    void testGroupByParallel() {
+        js4cpp::Array<int> big = js4cpp::Array<int>::from(100000, [] (size_t i) { return int(i); });
+
+        auto groups = js4cpp::groupByParallel(big, [] (int x) { return x % 7; }, 4);
+        auto expected = big.groupBy([] (int x) { return x % 7; });
+
+        CPPUNIT_ASSERT( groups.size() == 7 );
+        for (int key = 0; key < 7; ++key) {
+            CPPUNIT_ASSERT( groups[key].length() == expected[key].length() );
+            for (size_t i = 0; i < groups[key].length(); ++i) {
+                CPPUNIT_ASSERT( groups[key][i] == expected[key][i] );
+            }
+        }
+    }
+
+    void testIterators() {
+        int sum = 0;
+        for (int item : *arr) {
+            sum += item;
+        }
+        CPPUNIT_ASSERT( sum == 45 );
+
+        CPPUNIT_ASSERT( std::find(arr->begin(), arr->end(), 7) - arr->begin() == 7 );
+        CPPUNIT_ASSERT( arr->end() - arr->begin() == 10 );
+
+        std::sort(arr->begin(), arr->end(), std::greater<int>());
+        CPPUNIT_ASSERT( (*arr)[0] == 9 );
+    }
+
+    void testKeysValuesEntries() {
+        size_t keys = 0;
+        for (size_t key : arr->keys()) {
+            keys += key;
+        }
+        CPPUNIT_ASSERT( keys == 45 && arr->keys().size() == 10 );
+
+        for (int & value : arr->values()) {
+            value *= 2;
+        }
+        CPPUNIT_ASSERT( (*arr)[9] == 18 );
+
+        for (auto entry : arr->entries()) {
+            entry.second = int(entry.first) + 1;
+        }
+        CPPUNIT_ASSERT( (*arr)[0] == 1 && (*arr)[9] == 10 );
+
+        const js4cpp::Array<int> & constArr = *arr;
+        auto entries = constArr.entries();
+        CPPUNIT_ASSERT( (*(entries.begin() + 3)).second == 4 && entries.end() - entries.begin() == 10 );
+    }
+
+    void testCallbackArity() {
+        using js4cpp::Array;
+
+        arr->forEach([] (int & item, size_t index) {
+            item = int(index) * 2;
+        });
+        CPPUNIT_ASSERT( (*arr)[9] == 18 );
+
+        Array<size_t> lengths = arr->map([] (int, size_t, const Array<int> & array) {
+            return array.length();
+        });
+        CPPUNIT_ASSERT( lengths.length() == 10 && lengths[0] == 10 );
+
+        Array<double> halves = arr->map<double>([] (int item) { return item / 4.0; });
+        CPPUNIT_ASSERT( halves[1] == 0.5 );
+
+        CPPUNIT_ASSERT( arr->every([] (int item, size_t index) { return item == int(index) * 2; }) );
+        CPPUNIT_ASSERT( arr->some([] (int, size_t index) { return index == 9; }) );
+        CPPUNIT_ASSERT( arr->filter([] (int, size_t index) { return index % 2 == 0; }).length() == 5 );
+
+        CPPUNIT_ASSERT( arr->reduce([] (int sum, int, size_t index) { return sum + int(index); }, 0) == 45 );
+        CPPUNIT_ASSERT( arr->reduce([] (int sum, int item, size_t, const Array<int> & array) {
+            return sum + item * int(array.length());
+        }, 0) == 900 );
+    }
+
+    void testJoin() {
+        using js4cpp::Array;
+
+        CPPUNIT_ASSERT( arr->join() == "0,1,2,3,4,5,6,7,8,9" );
+        CPPUNIT_ASSERT( Array<int>().join() == "" && Array<int>::of(-1).join("; ") == "-1" );
+        CPPUNIT_ASSERT( Array<double>::of(0.5, 1e21, -0.0, NAN).join(" ") == "0.5 1e+21 0 NaN" );
+        CPPUNIT_ASSERT( Array<double>::of(1e-5, 1e-6, 1e-7, 1.5e-7, -2.5e-10).join(" ") == "0.00001 0.000001 1e-7 1.5e-7 -2.5e-10" );
+        CPPUNIT_ASSERT( Array<double>::of(5e-324, 1.7976931348623157e308, 1.5e21, 123456.789).join(" ") == "5e-324 1.7976931348623157e+308 1.5e+21 123456.789" );
+        CPPUNIT_ASSERT( Array<double>::of(0.1 + 0.2, 0.1, -1.25, 1e20 + 0.5).join(" ") == "0.30000000000000004 0.1 -1.25 100000000000000000000" );
+        CPPUNIT_ASSERT( Array<std::string>::of("a", "", "c").join("") == "ac" );
+        CPPUNIT_ASSERT( Array<char>::of('x', 'y').join() == "x,y" );
+    }
+
+    void testUnique() {
+        using js4cpp::Array;
+
+        Array<int> numbers = Array<int>::of(3, 1, 3, 2, 1, 3);
+        numbers.unique();
+        CPPUNIT_ASSERT( numbers.join() == "3,1,2" );
+
+        CPPUNIT_ASSERT( Array<std::string>::of("b", "a", "b", "c", "a").toUnique().join() == "b,a,c" );
+        CPPUNIT_ASSERT( Array<double>::of(NAN, 0.0, -0.0, NAN, 1.0).toUnique().join() == "NaN,0,1" );
+        CPPUNIT_ASSERT( Array<int>().toUnique().length() == 0 );
+
+        Array<int> many = Array<int>::from(100000, [] (size_t i) { return int(i % 1000) * 1024; });
+        Array<int> distinct = many.toUnique();
+        CPPUNIT_ASSERT( distinct.length() == 1000 && distinct[999] == 999 * 1024 && many.length() == 100000 );
+        CPPUNIT_ASSERT( Array<int>(*arr).toUnique().length() == 10 );
+    }
+
+    void testUniqueSorted() {
+        using js4cpp::Array;
+
+        Array<int> numbers = Array<int>::of(1, 1, 2, 3, 3, 3, 7);
+        numbers.uniqueSorted();
+        CPPUNIT_ASSERT( numbers.join() == "1,2,3,7" );
+
+        CPPUNIT_ASSERT( Array<double>::of(-0.0, 0.0, 0.5, 0.5).toUniqueSorted().join() == "0,0.5" );
+        CPPUNIT_ASSERT( Array<std::string>::of("a", "a", "b").toUniqueSorted().join() == "a,b" );
+        CPPUNIT_ASSERT( Array<int>().toUniqueSorted().length() == 0 && Array<int>::of(5).toUniqueSorted().join() == "5" );
+        CPPUNIT_ASSERT( Array<int>(*arr).toUniqueSorted().length() == 10 );
+    }
+
+    void testGatherScatter() {
+        using js4cpp::Array;
+
+        Array<std::string> words = Array<std::string>::of("a", "b", "c", "d");
+        CPPUNIT_ASSERT( words.gather(Array<int>::of(3, 0, 0, 2)).join() == "d,a,a,c" );
+        CPPUNIT_ASSERT( words.gather(Array<size_t>()).length() == 0 );
+        CPPUNIT_ASSERT( words.select(Array<bool>::of(true, false, true)).join() == "a,c" );
+
+        Array<size_t> indices = Array<size_t>::from(100000, [] (size_t i) { return (i * 7919) % 100000; });
+        Array<size_t> gathered = js4cpp::gatherParallel(Array<size_t>::from(100000, [] (size_t i) { return i * 2; }), indices, 4);
+        CPPUNIT_ASSERT( gathered.length() == 100000 && gathered[1] == 7919 * 2 && gathered[99999] == (99999 * 7919 % 100000) * 2 );
+
+        bool thrown = false;
+        try {
+            words.gather(Array<int>::of(0, -1));
+        } catch (const std::out_of_range &) {
+            thrown = true;
+        }
+        CPPUNIT_ASSERT( thrown );
+
+        Array<int> numbers(5);
+        numbers.scatter(Array<unsigned>::of(4, 1, 4), Array<int>::of(7, 8, 9));
+        CPPUNIT_ASSERT( numbers.join() == "0,8,0,0,9" );
+
+        thrown = false;
+        try {
+            numbers.scatter(Array<unsigned>::of(0, 1), Array<int>::of(1));
+        } catch (const std::invalid_argument &) {
+            thrown = true;
+        }
+        CPPUNIT_ASSERT( thrown );
+    }
+
+    void testPermute() {
+        using js4cpp::Array;
+
+        Array<std::string> words = Array<std::string>::of("a", "b", "c", "d", "e");
+        words.permute(Array<int>::of(1, 2, 0, 4, 3));
+        CPPUNIT_ASSERT( words.join() == "b,c,a,e,d" );
+        words.permute(Array<int>::of(0, 1, 2, 3, 4));
+        CPPUNIT_ASSERT( words.join() == "b,c,a,e,d" );
+
+        bool thrown = false;
+        try {
+            words.permute(Array<int>::of(0, 1, 1, 3, 4));
+        } catch (const std::invalid_argument &) {
+            thrown = true;
+        }
+        CPPUNIT_ASSERT( thrown && words.join() == "b,c,a,e,d" );
+    }
+
     void tearDown() {
         delete arr;
     }
@@ -132,6 +431,25 @@ public:
         CPPUNIT_TEST( testSome );
         CPPUNIT_TEST( testPopPush );
         CPPUNIT_TEST( testShiftUnshift );
+        CPPUNIT_TEST( testFill );
+        CPPUNIT_TEST( testCopyWithin );
+        CPPUNIT_TEST( testFrom );
+        CPPUNIT_TEST( testOf );
+        CPPUNIT_TEST( testToSorted );
+        CPPUNIT_TEST( testToReversed );
+        CPPUNIT_TEST( testToSpliced );
+        CPPUNIT_TEST( testWith );
+        CPPUNIT_TEST( testPartition );
+        CPPUNIT_TEST( testGroupBy );
+        CPPUNIT_TEST( testGroupByParallel );
+        CPPUNIT_TEST( testIterators );
+        CPPUNIT_TEST( testKeysValuesEntries );
+        CPPUNIT_TEST( testCallbackArity );
+        CPPUNIT_TEST( testJoin );
+        CPPUNIT_TEST( testUnique );
+        CPPUNIT_TEST( testUniqueSorted );
+        CPPUNIT_TEST( testGatherScatter );
+        CPPUNIT_TEST( testPermute );
 
     CPPUNIT_TEST_SUITE_END();
 
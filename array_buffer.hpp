@@ -0,0 +1,233 @@
+/* Copyright (c) 2012 Kirill Dmitrenko <kdmitrenko@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is furnished
+ * to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * @file array_buffer.hpp
+ * JS-style ArrayBuffer.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <sys/types.h>
+
+#include "array.hpp"
+
+namespace js4cpp {
+
+/**
+ * JS-style buffer of raw bytes. Copies of an ArrayBuffer refer to the same
+ * bytes, just like JS references do; use slice() to copy the contents.
+ *
+ * Resizable buffers reserve their maximal length up front, so resizing never
+ * moves the bytes and views created over the buffer stay valid.
+ * @see https://developer.mozilla.org/en-US/docs/Web/JavaScript/Reference/Global_Objects/ArrayBuffer
+ */
+class ArrayBuffer
+{
+public:
+    /**
+     * Alignment of owned buffers' data in bytes.
+     */
+    static const size_t ALIGNMENT = 64;
+
+    /**
+     * Create new zero-filled buffer of fixed length.
+     *
+     * @param byteLength Length in bytes.
+     * @throws std::bad_alloc If memory can't be allocated.
+     */
+    explicit ArrayBuffer(size_t byteLength = 0) :
+        block_(std::make_shared<Block>(byteLength, byteLength, false)) {}
+
+    /**
+     * Create new zero-filled resizable buffer.
+     *
+     * @param byteLength Length in bytes.
+     * @param maxByteLength Maximal length in bytes the buffer can be resized to.
+     * @throws std::out_of_range If length exceeds maximal one.
+     * @throws std::bad_alloc If memory can't be allocated.
+     */
+    ArrayBuffer(size_t byteLength, size_t maxByteLength) :
+        block_(std::make_shared<Block>(byteLength, checkedMaxLength(byteLength, maxByteLength), true)) {}
+
+    /**
+     * Create buffer over external memory without copying it, e.g. over a
+     * memory mapped file or a network packet. Such buffers are not resizable.
+     *
+     * @param data Memory.
+     * @param byteLength Length in bytes.
+     * @param release Function called with data once the last reference to
+     *      the buffer is gone. By default memory is not released.
+     * @returns Buffer.
+     */
+    static ArrayBuffer wrap(void * data, size_t byteLength, std::function<void(void *)> release = std::function<void(void *)>()) {
+        return ArrayBuffer(std::make_shared<Block>(data, byteLength, release));
+    }
+
+    /**
+     * Get length in bytes.
+     *
+     * @returns Length.
+     */
+    size_t byteLength() const {
+        return block_->byteLength;
+    }
+
+    /**
+     * Get maximal length in bytes the buffer can be resized to.
+     *
+     * @returns Maximal length.
+     */
+    size_t maxByteLength() const {
+        return block_->maxByteLength;
+    }
+
+    /**
+     * Check whether the buffer can be resized.
+     *
+     * @returns `true` if buffer is resizable.
+     */
+    bool resizable() const {
+        return block_->resizable;
+    }
+
+    /**
+     * Change length of resizable buffer. New bytes are zero-filled.
+     * @see https://developer.mozilla.org/en-US/docs/Web/JavaScript/Reference/Global_Objects/ArrayBuffer/resize
+     *
+     * @param byteLength New length in bytes.
+     * @throws std::out_of_range If buffer is not resizable or new length exceeds maximal one.
+     */
+    void resize(size_t byteLength) {
+        if (!block_->resizable || byteLength > block_->maxByteLength) {
+            throw std::out_of_range("Can't resize ArrayBuffer to given length");
+        }
+
+        if (byteLength > block_->byteLength) {
+            std::memset(block_->data + block_->byteLength, 0, byteLength - block_->byteLength);
+        }
+        block_->byteLength = byteLength;
+    }
+
+    /**
+     * Copy bytes from begin to end (not including) to a new buffer.
+     * Negative indexes are counted from the end.
+     * @see https://developer.mozilla.org/en-US/docs/Web/JavaScript/Reference/Global_Objects/ArrayBuffer/slice
+     *
+     * @param begin Begin index.
+     * @param end End index.
+     * @returns New buffer.
+     */
+    ArrayBuffer slice(ssize_t begin = 0, ssize_t end = std::numeric_limits<ssize_t>::max()) const {
+        size_t from = relativeIndex(begin, byteLength()), to = std::max(from, relativeIndex(end, byteLength()));
+        ArrayBuffer result(to - from);
+
+        std::memcpy(result.data(), data() + from, to - from);
+
+        return result;
+    }
+
+    /**
+     * Get raw bytes.
+     *
+     * @returns Pointer to the first byte.
+     */
+    unsigned char * data() {
+        return block_->data;
+    }
+
+    /**
+     * Get raw bytes.
+     *
+     * @returns Pointer to the first byte.
+     */
+    const unsigned char * data() const {
+        return block_->data;
+    }
+
+    /**
+     * Check whether two buffers refer to the same bytes.
+     */
+    bool operator ==(const ArrayBuffer & other) const {
+        return block_ == other.block_;
+    }
+
+    bool operator !=(const ArrayBuffer & other) const {
+        return block_ != other.block_;
+    }
+
+private:
+    struct Block {
+        Block(size_t length, size_t capacity, bool isResizable) :
+            data(0), byteLength(length), maxByteLength(capacity), resizable(isResizable)
+        {
+            void * memory = 0;
+
+            if (posix_memalign(&memory, ALIGNMENT, std::max<size_t>(capacity, 1)) != 0) {
+                throw std::bad_alloc();
+            }
+            data = static_cast<unsigned char *>(memory);
+            std::memset(data, 0, length);
+            release = std::free;
+        }
+
+        Block(void * external, size_t length, const std::function<void(void *)> & releaseFn) :
+            data(static_cast<unsigned char *>(external)), byteLength(length), maxByteLength(length),
+            resizable(false), release(releaseFn) {}
+
+        ~Block() {
+            if (release) {
+                release(data);
+            }
+        }
+
+        unsigned char * data;
+        size_t byteLength;
+        size_t maxByteLength;
+        bool resizable;
+        std::function<void(void *)> release;
+
+    private:
+        Block(const Block &);
+        Block & operator =(const Block &);
+    };
+
+    explicit ArrayBuffer(const std::shared_ptr<Block> & block) : block_(block) {}
+
+    static size_t checkedMaxLength(size_t byteLength, size_t maxByteLength) {
+        if (maxByteLength < byteLength) {
+            throw std::out_of_range("ArrayBuffer length exceeds its maximal length");
+        }
+
+        return maxByteLength;
+    }
+
+    std::shared_ptr<Block> block_;
+};
+
+} // namespace js4cpp
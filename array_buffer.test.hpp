@@ -0,0 +1,93 @@
+#pragma once
+
+#include <cppunit/TestCaller.h>
+#include <cppunit/TestCase.h>
+#include <cppunit/TestSuite.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+#include "array_buffer.hpp"
+#include "typed_array.hpp"
+
+class ArrayBufferTest : public CppUnit::TestCase
+{
+public:
+    ArrayBufferTest() : CppUnit::TestCase("ArrayBuffer Test Case") {};
+
+    void testLength() {
+        js4cpp::ArrayBuffer buffer(16);
+
+        CPPUNIT_ASSERT( buffer.byteLength() == 16 && !buffer.resizable() );
+        CPPUNIT_ASSERT( buffer.data()[15] == 0 );
+        CPPUNIT_ASSERT( reinterpret_cast<size_t>(buffer.data()) % js4cpp::ArrayBuffer::ALIGNMENT == 0 );
+    }
+
+    void testResize() {
+        js4cpp::ArrayBuffer buffer(4, 16);
+        js4cpp::Uint8Array bytes(buffer, 0, 4);
+        const unsigned char * data = buffer.data();
+
+        bytes[0] = 1;
+        buffer.resize(16);
+        CPPUNIT_ASSERT( buffer.byteLength() == 16 && buffer.data() == data && bytes[0] == 1 );
+        CPPUNIT_ASSERT( buffer.data()[15] == 0 );
+
+        bool thrown = false;
+        try {
+            buffer.resize(17);
+        } catch (const std::out_of_range &) {
+            thrown = true;
+        }
+        CPPUNIT_ASSERT( thrown );
+    }
+
+    void testSlice() {
+        js4cpp::ArrayBuffer buffer(8);
+        buffer.data()[6] = 42;
+
+        js4cpp::ArrayBuffer copy = buffer.slice(-4, -1);
+        CPPUNIT_ASSERT( copy.byteLength() == 3 && copy.data()[2] == 42 && copy != buffer );
+    }
+
+    void testViews() {
+        js4cpp::ArrayBuffer buffer(16);
+        js4cpp::Uint32Array words(buffer);
+        js4cpp::Uint8Array bytes(buffer, 4, 4);
+
+        words[1] = 0x01010101;
+        CPPUNIT_ASSERT( words.length() == 4 && bytes[3] == 1 );
+        CPPUNIT_ASSERT( words.buffer() == bytes.buffer() );
+
+        bool thrown = false;
+        try {
+            js4cpp::Uint32Array misaligned(buffer, 2);
+        } catch (const std::out_of_range &) {
+            thrown = true;
+        }
+        CPPUNIT_ASSERT( thrown );
+    }
+
+    void testWrap() {
+        unsigned char packet[] = { 1, 2, 3, 4 };
+        bool released = false;
+
+        {
+            js4cpp::ArrayBuffer buffer = js4cpp::ArrayBuffer::wrap(packet, sizeof(packet),
+                [&released] (void *) { released = true; });
+            js4cpp::Uint8Array bytes(buffer);
+
+            bytes[0] = 9;
+            CPPUNIT_ASSERT( packet[0] == 9 && bytes.length() == 4 );
+        }
+        CPPUNIT_ASSERT( released );
+    }
+
+    CPPUNIT_TEST_SUITE( ArrayBufferTest );
+
+        CPPUNIT_TEST( testLength );
+        CPPUNIT_TEST( testResize );
+        CPPUNIT_TEST( testSlice );
+        CPPUNIT_TEST( testViews );
+        CPPUNIT_TEST( testWrap );
+
+    CPPUNIT_TEST_SUITE_END();
+};
@@ -0,0 +1,335 @@
+/* Copyright (c) 2012 Kirill Dmitrenko <kdmitrenko@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is furnished
+ * to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * @file array_view.hpp
+ * Read-only JS-style view over contiguous elements.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cstdlib>
+#include <functional>
+#include <limits>
+#include <string>
+#include <sys/types.h>
+
+#include "array.hpp"
+
+namespace js4cpp {
+
+/**
+ * Read-only view over contiguous elements someone else owns (a memory mapped
+ * file, a serialized buffer, a part of an Array etc.) exposing read side of
+ * js4cpp::Array's API with the same signatures and semantics. Methods
+ * producing new arrays return js4cpp::Array.
+ *
+ * @tparam T Elements type.
+ */
+template <typename T> class ArrayView
+{
+public:
+    typedef const T * iterator;
+    typedef const T * const_iterator;
+    typedef T value_type;
+
+    /**
+     * Create view over given elements.
+     *
+     * @param data First element.
+     * @param length Number of elements.
+     */
+    ArrayView(const T * data = 0, size_t length = 0) : data_(data), length_(length) {}
+
+    /**
+     * Create view over all elements of an array. The view is valid as long
+     * as the array is alive and not resized.
+     *
+     * @param array Array.
+     */
+    ArrayView(const Array<T> & array) : data_(array.begin()), length_(array.length()) {}
+
+    /**
+     * Get element under given index.
+     *
+     * @param i Index.
+     * @returns Element.
+     */
+    const T & operator [](size_t i) const {
+        return data_[i];
+    }
+
+    /**
+     * Get view's length.
+     *
+     * @returns Length.
+     */
+    size_t length() const {
+        return length_;
+    }
+
+    const T * data() const {
+        return data_;
+    }
+
+    const_iterator begin() const {
+        return data_;
+    }
+
+    const_iterator end() const {
+        return data_ + length_;
+    }
+
+    /**
+     * Get index of given item.
+     * @see https://developer.mozilla.org/en-US/docs/JavaScript/Reference/Global_Objects/Array/indexOf
+     *
+     * @param item Item.
+     * @param fromIndex The index at which to begin the search.
+     * @returns Item's index or -1.
+     */
+    ssize_t indexOf(const T & item, size_t fromIndex = 0) const {
+        const T * found = std::find(data_ + std::min(fromIndex, length_), end(), item);
+
+        return found != end() ? found - data_ : -1;
+    }
+
+    /**
+     * Get the last index of given item.
+     * @see https://developer.mozilla.org/en-US/docs/JavaScript/Reference/Global_Objects/Array/lastIndexOf
+     *
+     * @param item Item.
+     * @param fromIndex Number of elements at the end to skip.
+     * @returns Item's last index or -1.
+     */
+    ssize_t lastIndexOf(const T & item, size_t fromIndex = 0) const {
+        for (size_t i = length_ - std::min(fromIndex, length_); i-- > 0; ) {
+            if (data_[i] == item) {
+                return i;
+            }
+        }
+
+        return -1;
+    }
+
+    /**
+     * Call callback for every element.
+     * @see https://developer.mozilla.org/en-US/docs/JavaScript/Reference/Global_Objects/Array/forEach
+     *
+     * @param callback Callback accepting (element[, index[, view]]).
+     */
+    template <typename F>
+    void forEach(F callback) const {
+        for (size_t i = 0; i < length_; ++i) {
+            invokeCallback(callback, data_[i], i, *this);
+        }
+    }
+
+    /**
+     * Create array of callback's results.
+     * @see https://developer.mozilla.org/en-US/docs/JavaScript/Reference/Global_Objects/Array/map
+     *
+     * @param callback Callback accepting (element[, index[, view]]).
+     * @returns New array.
+     */
+    template <typename F>
+    Array<typename std::decay<decltype(invokeCallback(std::declval<F &>(), std::declval<const T &>(), size_t(), std::declval<const ArrayView<T> &>()))>::type>
+    map(F callback) const {
+        typedef typename std::decay<decltype(invokeCallback(callback, data_[0], 0, *this))>::type R;
+
+        return Array<R>::from(length_, [&] (size_t i) {
+            return invokeCallback(callback, data_[i], i, *this);
+        });
+    }
+
+    /**
+     * Create array of elements passed the test.
+     * @see https://developer.mozilla.org/en-US/docs/JavaScript/Reference/Global_Objects/Array/filter
+     *
+     * @param test Test accepting (element[, index[, view]]).
+     * @returns New array.
+     */
+    template <typename F>
+    Array<T> filter(F test) const {
+        Array<T> result;
+
+        for (size_t i = 0; i < length_; ++i) {
+            if (invokeCallback(test, data_[i], i, *this)) {
+                result.push(data_[i]);
+            }
+        }
+
+        return result;
+    }
+
+    /**
+     * Test whether all elements pass the test.
+     * @see https://developer.mozilla.org/en-US/docs/JavaScript/Reference/Global_Objects/Array/every
+     *
+     * @param condition Test accepting (element[, index[, view]]).
+     * @returns `true` if all elements passed.
+     */
+    template <typename F>
+    bool every(F condition) const {
+        for (size_t i = 0; i < length_; ++i) {
+            if (!invokeCallback(condition, data_[i], i, *this)) {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    /**
+     * Test whether any element passes the test.
+     * @see https://developer.mozilla.org/en-US/docs/JavaScript/Reference/Global_Objects/Array/some
+     *
+     * @param condition Test accepting (element[, index[, view]]).
+     * @returns `true` if at least one element passed.
+     */
+    template <typename F>
+    bool some(F condition) const {
+        for (size_t i = 0; i < length_; ++i) {
+            if (invokeCallback(condition, data_[i], i, *this)) {
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    /**
+     * Reduce elements to a single value (from left to right), using the
+     * first element as the initial value.
+     * @see https://developer.mozilla.org/en-US/docs/JavaScript/Reference/Global_Objects/Array/reduce
+     *
+     * @param callback Reducer accepting (accumulator, element[, index[, view]]).
+     * @returns Accumulated value.
+     */
+    template <typename F = std::plus<T> >
+    T reduce(F callback = F()) const {
+        return reduce(callback, data_[0], 1);
+    }
+
+    /**
+     * Reduce elements to a single value (from left to right).
+     * @see https://developer.mozilla.org/en-US/docs/JavaScript/Reference/Global_Objects/Array/reduce
+     *
+     * @param callback Reducer accepting (accumulator, element[, index[, view]]).
+     * @param initialValue Accumulator initial value.
+     * @param startFrom Index from which iteration will start.
+     * @returns Accumulated value.
+     */
+    template <typename F, typename R>
+    R reduce(F callback, R initialValue, size_t startFrom = 0) const {
+        R accumulator = initialValue;
+
+        for (size_t i = startFrom; i < length_; ++i) {
+            accumulator = invokeReducer(callback, accumulator, data_[i], i, *this);
+        }
+
+        return accumulator;
+    }
+
+    /**
+     * Join string forms of all elements, separated by a separator.
+     * @see https://developer.mozilla.org/en-US/docs/Web/JavaScript/Reference/Global_Objects/Array/join
+     *
+     * @param separator Separator.
+     * @returns Joined string.
+     */
+    std::string join(const std::string & separator = ",") const {
+        std::string result;
+
+        for (size_t i = 0; i < length_; ++i) {
+            if (i != 0) {
+                result += separator;
+            }
+            appendString(result, data_[i]);
+        }
+
+        return result;
+    }
+
+    /**
+     * Get range of the view's indexes.
+     * @see https://developer.mozilla.org/en-US/docs/JavaScript/Reference/Global_Objects/Array/keys
+     *
+     * @returns Range.
+     */
+    Range<KeyIterator> keys() const {
+        return Range<KeyIterator>(KeyIterator(0), KeyIterator(length_));
+    }
+
+    /**
+     * Get range of (index, element) pairs.
+     * @see https://developer.mozilla.org/en-US/docs/JavaScript/Reference/Global_Objects/Array/entries
+     *
+     * @returns Range.
+     */
+    Range<EntryIterator<const T> > entries() const {
+        return Range<EntryIterator<const T> >(EntryIterator<const T>(data_, 0), EntryIterator<const T>(data_, length_));
+    }
+
+    /**
+     * Create view over elements from begin to end (not including).
+     * Negative indexes are counted from the end.
+     *
+     * @param begin Begin index.
+     * @param end End index.
+     * @returns View.
+     */
+    ArrayView<T> subarray(ssize_t begin = 0, ssize_t end = std::numeric_limits<ssize_t>::max()) const {
+        size_t from = relativeIndex(begin, length_), to = std::max(from, relativeIndex(end, length_));
+
+        return ArrayView<T>(data_ + from, to - from);
+    }
+
+    /**
+     * Copy elements from begin to end (not including) to a new array.
+     * Negative indexes are counted from the end.
+     * @see https://developer.mozilla.org/en-US/docs/JavaScript/Reference/Global_Objects/Array/slice
+     *
+     * @param begin Begin index.
+     * @param end End index.
+     * @returns New array.
+     */
+    Array<T> slice(ssize_t begin = 0, ssize_t end = std::numeric_limits<ssize_t>::max()) const {
+        ArrayView<T> part = subarray(begin, end);
+
+        return Array<T>(part.begin(), part.end());
+    }
+
+    /**
+     * Copy all elements to a new array.
+     *
+     * @returns New array.
+     */
+    Array<T> toArray() const {
+        return Array<T>(begin(), end());
+    }
+
+protected:
+    const T * data_;
+    size_t length_;
+};
+
+} // namespace js4cpp
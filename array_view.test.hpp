@@ -0,0 +1,80 @@
+#pragma once
+
+#include <cppunit/TestCaller.h>
+#include <cppunit/TestCase.h>
+#include <cppunit/TestSuite.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+#include "array_view.hpp"
+
+class ArrayViewTest : public CppUnit::TestCase
+{
+public:
+    ArrayViewTest() : CppUnit::TestCase("ArrayView Test Case") {};
+
+    void setUp() {
+        arr = new js4cpp::Array<int>(js4cpp::Array<int>::from(10, [] (size_t i) { return int(i); }));
+        view = new js4cpp::ArrayView<int>(*arr);
+    }
+
+    void testLength() {
+        CPPUNIT_ASSERT( view->length() == 10 && (*view)[3] == 3 );
+        CPPUNIT_ASSERT( js4cpp::ArrayView<int>().length() == 0 );
+    }
+
+    void testSearch() {
+        CPPUNIT_ASSERT( view->indexOf(4) == 4 && view->indexOf(4, 5) == -1 && view->indexOf(4, 20) == -1 );
+        CPPUNIT_ASSERT( view->lastIndexOf(9) == 9 && view->lastIndexOf(10) == -1 );
+        CPPUNIT_ASSERT( view->lastIndexOf(9, 1) == -1 && view->lastIndexOf(8, 1) == 8 && view->lastIndexOf(0, 20) == -1 );
+    }
+
+    void testIteration() {
+        CPPUNIT_ASSERT( view->map([] (int x) { return x * 0.5; })[3] == 1.5 );
+        CPPUNIT_ASSERT( view->filter([] (int, size_t i) { return i < 3; }).length() == 3 );
+        CPPUNIT_ASSERT( view->every([] (int x) { return x >= 0; }) && !view->some([] (int x) { return x > 9; }) );
+        CPPUNIT_ASSERT( view->reduce() == 45 );
+        CPPUNIT_ASSERT( view->subarray(1, 4).reduce([] (int a, int b) { return a * b; }) == 6 );
+        CPPUNIT_ASSERT( view->reduce([] (double sum, int x) { return sum + x * 0.5; }, 0.0) == 22.5 );
+        CPPUNIT_ASSERT( view->reduce(std::plus<int>(), 100, 8) == 117 );
+        CPPUNIT_ASSERT( view->join() == "0,1,2,3,4,5,6,7,8,9" && view->subarray(0, 3).join("-") == "0-1-2" );
+
+        size_t keys = 0, entries = 0;
+        for (size_t key : view->keys()) {
+            keys += key;
+        }
+        for (auto entry : view->entries()) {
+            entries += entry.first == size_t(entry.second);
+        }
+        CPPUNIT_ASSERT( keys == 45 && entries == 10 && view->keys().size() == 10 );
+
+        size_t count = 0;
+        view->forEach([&count] (int) { ++count; });
+        CPPUNIT_ASSERT( count == 10 );
+    }
+
+    void testSubarraySlice() {
+        js4cpp::ArrayView<int> part = view->subarray(-3);
+        CPPUNIT_ASSERT( part.length() == 3 && part[0] == 7 && part.data() == arr->begin() + 7 );
+
+        js4cpp::Array<int> copy = view->slice(1, 3);
+        CPPUNIT_ASSERT( copy.length() == 2 && copy[1] == 2 );
+    }
+
+    void tearDown() {
+        delete view;
+        delete arr;
+    }
+
+    CPPUNIT_TEST_SUITE( ArrayViewTest );
+
+        CPPUNIT_TEST( testLength );
+        CPPUNIT_TEST( testSearch );
+        CPPUNIT_TEST( testIteration );
+        CPPUNIT_TEST( testSubarraySlice );
+
+    CPPUNIT_TEST_SUITE_END();
+
+private:
+    js4cpp::Array<int> * arr;
+    js4cpp::ArrayView<int> * view;
+};
@@ -0,0 +1,1127 @@
+/* Copyright (c) 2012 Kirill Dmitrenko <kdmitrenko@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is furnished
+ * to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * @file bit_array.hpp
+ * Packed Array<bool>, included from array.hpp.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "array.hpp"
+
+namespace js4cpp {
+
+/**
+ * JS-style array of booleans packed 64 per word. Scans (every, some,
+ * indexOf, count), fill and bitwise combination work on whole words with
+ * popcount and count-trailing-zeros builtins, i.e. 64 elements per step.
+ * Bits past the length are kept zero.
+ *
+ * Elements are read as bool values and written through a proxy
+ * reference; callbacks get elements by value.
+ * @see https://developer.mozilla.org/en-US/docs/JavaScript/Reference/Global_Objects/Array
+ */
+template <> class Array<bool>
+{
+    /**
+     * Type of keys given function generates for elements.
+     */
+    template <typename KeyFn> struct GroupKey {
+        typedef typename std::decay<decltype(invokeCallback(std::declval<KeyFn &>(),
+            std::declval<bool &>(), size_t(), std::declval<const Array<bool> &>()))>::type type;
+    };
+
+    template <typename U> friend class ParallelAlgorithms;
+
+public:
+    typedef uint64_t Word;
+
+    /**
+     * Number of elements per word.
+     */
+    static const size_t WORD_BITS = 64;
+
+    /**
+     * Writable reference to one element.
+     */
+    class reference
+    {
+    public:
+        reference(Word & word, Word bit) : word_(&word), bit_(bit) {}
+
+        operator bool() const {
+            return (*word_ & bit_) != 0;
+        }
+
+        reference & operator =(bool value) {
+            *word_ = value ? *word_ | bit_ : *word_ & ~bit_;
+            return *this;
+        }
+
+        reference & operator =(const reference & other) {
+            return *this = bool(other);
+        }
+
+    private:
+        Word * word_;
+        Word bit_;
+    };
+
+    /**
+     * Iterator over element values.
+     */
+    class const_iterator : public IndexedIterator<const_iterator, bool>
+    {
+    public:
+        const_iterator(const Array<bool> * array = 0, size_t index = 0) :
+            IndexedIterator<const_iterator, bool>(index), array_(array) {}
+
+        bool at(size_t index) const { return (*array_)[index]; }
+
+    private:
+        const Array<bool> * array_;
+    };
+
+    /**
+     * Iterator over (index, element value) pairs.
+     */
+    class const_entry_iterator : public IndexedIterator<const_entry_iterator, std::pair<size_t, bool> >
+    {
+    public:
+        const_entry_iterator(const Array<bool> * array = 0, size_t index = 0) :
+            IndexedIterator<const_entry_iterator, std::pair<size_t, bool> >(index), array_(array) {}
+
+        std::pair<size_t, bool> at(size_t index) const { return std::make_pair(index, (*array_)[index]); }
+
+    private:
+        const Array<bool> * array_;
+    };
+
+    typedef const_iterator iterator;
+    typedef bool value_type;
+    typedef bool const_reference;
+    typedef size_t size_type;
+
+    /**
+     * Create new array of given length.
+     *
+     * @param length Length.
+     * @param value Value of all elements.
+     */
+    explicit Array(size_t length = 0, bool value = false) : words_(wordsFor(length), value ? ~Word(0) : 0), length_(length) {
+        clearTail();
+    }
+
+    /**
+     * Create new array from iterators range.
+     */
+    template <class InputIterator>
+    Array(InputIterator begin, InputIterator end) : length_(0) {
+        for (; begin != end; ++begin) {
+            push(*begin);
+        }
+    }
+
+    /**
+     * Create new array from any iterable.
+     * @see https://developer.mozilla.org/en-US/docs/JavaScript/Reference/Global_Objects/Array/from
+     */
+    template <typename Iterable>
+    static Array<bool> from(const Iterable & iterable) {
+        return Array<bool>(std::begin(iterable), std::end(iterable));
+    }
+
+    /**
+     * Create new array of given length generating every element from its
+     * index. Elements are assembled into words before being stored.
+     * @see https://developer.mozilla.org/en-US/docs/JavaScript/Reference/Global_Objects/Array/from
+     */
+    template <typename Generator>
+    static Array<bool> from(size_t length, Generator generator) {
+        Array<bool> result(length);
+
+        for (size_t w = 0, i = 0; w < result.words_.size(); ++w) {
+            Word word = 0;
+
+            for (size_t bit = 0; bit < WORD_BITS && i < length; ++bit, ++i) {
+                word |= Word(generator(i) ? 1 : 0) << bit;
+            }
+            result.words_[w] = word;
+        }
+
+        return result;
+    }
+
+    /**
+     * Create new array from given elements.
+     * @see https://developer.mozilla.org/en-US/docs/JavaScript/Reference/Global_Objects/Array/of
+     */
+    template <typename... Args>
+    static Array<bool> of(Args... items) {
+        const bool values[] = { false, bool(items)... };
+
+        return Array<bool>(values + 1, values + 1 + sizeof...(items));
+    }
+
+    /**
+     * Get writable reference to element. Like in JS, writing past the end
+     * extends the array.
+     */
+    reference operator [](size_t i) {
+#ifndef INTOLERANT_TO_OUT_OF_RANGE_INDEXES
+        if (i >= length_) {
+            resize(i + 1);
+        }
+#endif
+        return reference(words_[i / WORD_BITS], Word(1) << (i % WORD_BITS));
+    }
+
+    bool operator [](size_t i) const {
+        return (words_[i / WORD_BITS] >> (i % WORD_BITS)) & 1;
+    }
+
+    /**
+     * Get array's length.
+     * @see https://developer.mozilla.org/en-US/docs/JavaScript/Reference/Global_Objects/Array/length
+     */
+    size_t length() const {
+        return length_;
+    }
+
+    const_iterator begin() const {
+        return const_iterator(this, 0);
+    }
+
+    const_iterator end() const {
+        return const_iterator(this, length_);
+    }
+
+    /**
+     * Get packed words, least significant bit first.
+     */
+    const Word * words() const {
+        return words_.data();
+    }
+
+    /**
+     * Get number of packed words.
+     */
+    size_t wordCount() const {
+        return words_.size();
+    }
+
+    /**
+     * Push value to the end of array.
+     * @see https://developer.mozilla.org/en-US/docs/JavaScript/Reference/Global_Objects/Array/push
+     */
+    void push(bool value) {
+        if (length_ % WORD_BITS == 0) {
+            words_.push_back(0);
+        }
+        words_.back() |= Word(value ? 1 : 0) << (length_ % WORD_BITS);
+        ++length_;
+    }
+
+    /**
+     * Remove one element from the end of the array.
+     * @see https://developer.mozilla.org/en-US/docs/JavaScript/Reference/Global_Objects/Array/pop
+     *
+     * @returns Removed element.
+     */
+    bool pop() {
+        bool result = (*this)[length_ - 1];
+        resize(length_ - 1);
+        return result;
+    }
+
+    /**
+     * Insert value just before the first element of the array. All words
+     * are shifted up by one bit.
+     * @see https://developer.mozilla.org/en-US/docs/JavaScript/Reference/Global_Objects/Array/unshift
+     *
+     * @param value Value to be inserted.
+     */
+    void unshift(bool value) {
+        resize(length_ + 1);
+
+        for (size_t w = words_.size() - 1; w > 0; --w) {
+            words_[w] = (words_[w] << 1) | (words_[w - 1] >> (WORD_BITS - 1));
+        }
+        words_[0] = (words_[0] << 1) | Word(value ? 1 : 0);
+    }
+
+    /**
+     * Remove the first element of the array. All words are shifted down by
+     * one bit.
+     * @see https://developer.mozilla.org/en-US/docs/JavaScript/Reference/Global_Objects/Array/shift
+     *
+     * @returns Removed element.
+     */
+    bool shift() {
+        bool result = (*this)[0];
+
+        shiftDown(1);
+        resize(length_ - 1);
+
+        return result;
+    }
+
+    /**
+     * Reverse order of elements in the array: words are swapped and
+     * bit-reversed, then the padding which ended up in front is shifted out.
+     * @see https://developer.mozilla.org/en-US/docs/JavaScript/Reference/Global_Objects/Array/reverse
+     */
+    void reverse() {
+        std::reverse(words_.begin(), words_.end());
+        for (size_t w = 0; w < words_.size(); ++w) {
+            words_[w] = reverseBits(words_[w]);
+        }
+        shiftDown(words_.size() * WORD_BITS - length_);
+    }
+
+    /**
+     * Count elements which are true (what `reduce((n, x) => n + x, 0)`
+     * computes), one popcount per 64 elements.
+     *
+     * @returns Number of true elements.
+     */
+    size_t count() const {
+        size_t result = 0;
+
+        for (size_t w = 0; w < words_.size(); ++w) {
+            result += __builtin_popcountll(words_[w]);
+        }
+
+        return result;
+    }
+
+    /**
+     * Check whether all elements are true.
+     * @see https://developer.mozilla.org/en-US/docs/JavaScript/Reference/Global_Objects/Array/every
+     */
+    bool every() const {
+        size_t full = length_ / WORD_BITS;
+
+        for (size_t w = 0; w < full; ++w) {
+            if (words_[w] != ~Word(0)) {
+                return false;
+            }
+        }
+
+        return full == words_.size() || words_[full] == tailMask();
+    }
+
+    /**
+     * Check whether any element is true.
+     * @see https://developer.mozilla.org/en-US/docs/JavaScript/Reference/Global_Objects/Array/some
+     */
+    bool some() const {
+        for (size_t w = 0; w < words_.size(); ++w) {
+            if (words_[w] != 0) {
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    /**
+     * Tests whether all elements pass the test.
+     * @see https://developer.mozilla.org/en-US/docs/JavaScript/Reference/Global_Objects/Array/every
+     */
+    template <typename F>
+    bool every(F condition) const {
+        for (size_t i = 0; i < length_; ++i) {
+            bool value = (*this)[i];
+            if (!invokeCallback(condition, value, i, *this)) {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    /**
+     * Tests whether any element passes the test.
+     * @see https://developer.mozilla.org/en-US/docs/JavaScript/Reference/Global_Objects/Array/some
+     */
+    template <typename F>
+    bool some(F condition) const {
+        for (size_t i = 0; i < length_; ++i) {
+            bool value = (*this)[i];
+            if (invokeCallback(condition, value, i, *this)) {
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    /**
+     * Get first index of given value.
+     * @see https://developer.mozilla.org/en-US/docs/JavaScript/Reference/Global_Objects/Array/indexOf
+     *
+     * @param item Value.
+     * @param fromIndex The index to start the search at.
+     * @returns Index or -1 if there is no such value.
+     */
+    ssize_t indexOf(bool item, size_t fromIndex = 0) const {
+        if (fromIndex >= length_) {
+            return -1;
+        }
+
+        Word flip = item ? 0 : ~Word(0);
+        size_t w = fromIndex / WORD_BITS;
+        Word word = (words_[w] ^ flip) & (~Word(0) << (fromIndex % WORD_BITS));
+
+        while (true) {
+            if (w + 1 == words_.size()) {
+                word &= tailMask();
+            }
+            if (word != 0) {
+                return w * WORD_BITS + __builtin_ctzll(word);
+            }
+            if (++w == words_.size()) {
+                return -1;
+            }
+            word = words_[w] ^ flip;
+        }
+    }
+
+    /**
+     * Get last index of given value.
+     * @see https://developer.mozilla.org/en-US/docs/JavaScript/Reference/Global_Objects/Array/lastIndexOf
+     *
+     * @param item Value.
+     * @param fromIndex Number of elements at the end to skip.
+     * @returns Index or -1 if there is no such value.
+     */
+    ssize_t lastIndexOf(bool item, size_t fromIndex = 0) const {
+        if (fromIndex >= length_) {
+            return -1;
+        }
+
+        Word flip = item ? 0 : ~Word(0);
+        size_t last = length_ - 1 - fromIndex, w = last / WORD_BITS;
+        Word word = (words_[w] ^ flip) & (~Word(0) >> (WORD_BITS - 1 - last % WORD_BITS));
+
+        while (true) {
+            if (word != 0) {
+                return w * WORD_BITS + WORD_BITS - 1 - __builtin_clzll(word);
+            }
+            if (w-- == 0) {
+                return -1;
+            }
+            word = words_[w] ^ flip;
+        }
+    }
+
+    /**
+     * Fill elements from start to end with a value, whole words at a time.
+     * @see https://developer.mozilla.org/en-US/docs/JavaScript/Reference/Global_Objects/Array/fill
+     *
+     * @param value Value.
+     * @param start Relative index of the first element.
+     * @param end Relative index after the last element.
+     */
+    void fill(bool value, ssize_t start = 0, ssize_t end = std::numeric_limits<ssize_t>::max()) {
+        size_t from = relativeIndex(start, length_), to = relativeIndex(end, length_);
+
+        if (from >= to) {
+            return;
+        }
+
+        size_t first = from / WORD_BITS, last = (to - 1) / WORD_BITS;
+        Word head = ~Word(0) << (from % WORD_BITS), tail = ~Word(0) >> (WORD_BITS - 1 - (to - 1) % WORD_BITS);
+
+        if (first == last) {
+            setBits(words_[first], head & tail, value);
+            return;
+        }
+
+        setBits(words_[first], head, value);
+        std::fill(words_.begin() + first + 1, words_.begin() + last, value ? ~Word(0) : 0);
+        setBits(words_[last], tail, value);
+    }
+
+    /**
+     * Copy elements from start to end to position starting at target, up to
+     * 64 elements per step. Length of the array stays the same.
+     * @see https://developer.mozilla.org/en-US/docs/JavaScript/Reference/Global_Objects/Array/copyWithin
+     *
+     * @param target Relative index to copy elements to.
+     * @param start Relative index of the first element to copy.
+     * @param end Relative index to stop copying at.
+     */
+    void copyWithin(ssize_t target, ssize_t start = 0, ssize_t end = std::numeric_limits<ssize_t>::max()) {
+        size_t to = relativeIndex(target, length_), from = relativeIndex(start, length_), last = relativeIndex(end, length_);
+
+        if (from >= last || to >= length_) {
+            return;
+        }
+
+        assign(to, range(from, from + std::min(last - from, length_ - to)));
+    }
+
+    /**
+     * Create subarray bounded by begin and end indexes.
+     * @see https://developer.mozilla.org/en-US/docs/JavaScript/Reference/Global_Objects/Array/slice
+     *
+     * @param begin Begin index.
+     * @param end End index. If not specified, subarray will be bounded at the end by length of original array.
+     * @returns Subarray.
+     */
+    Array<bool> slice(ssize_t begin, ssize_t end = 0) const {
+        ssize_t length = length_;
+
+        if (
+            begin >= length ||
+            begin < -length ||
+            end >= length ||
+            end < -length
+        ) {
+            return Array<bool>();
+        }
+
+        begin = (length + begin) % length;
+        end = (length + end) % length;
+
+        if (end < begin) {
+            return Array<bool>();
+        }
+
+        return range(begin, end);
+    }
+
+    /**
+     * Rearrange elements by given comparator. Only the order of false and
+     * true matters, so elements are counted and the array is refilled.
+     * @see https://developer.mozilla.org/en-US/docs/JavaScript/Reference/Global_Objects/Array/sort
+     *
+     * @param comparator Comparator.
+     */
+    void sort(std::tr1::function<bool(const bool &, const bool &)> comparator = std::less<bool>()) {
+        size_t trues = count();
+
+        if (comparator(false, true)) {
+            fill(false);
+            fill(true, length_ - trues);
+        } else if (comparator(true, false)) {
+            fill(true);
+            fill(false, trues);
+        }
+    }
+
+    /**
+     * Create sorted copy of the array.
+     * @see https://developer.mozilla.org/en-US/docs/JavaScript/Reference/Global_Objects/Array/toSorted
+     *
+     * @param comparator Comparator.
+     * @returns Sorted array.
+     */
+    Array<bool> toSorted(std::tr1::function<bool(const bool &, const bool &)> comparator = std::less<bool>()) const {
+        Array<bool> result(*this);
+        result.sort(comparator);
+        return result;
+    }
+
+    /**
+     * Create copy of the array with elements in reverse order.
+     * @see https://developer.mozilla.org/en-US/docs/JavaScript/Reference/Global_Objects/Array/toReversed
+     *
+     * @returns Reversed array.
+     */
+    Array<bool> toReversed() const {
+        Array<bool> result(*this);
+        result.reverse();
+        return result;
+    }
+
+    /**
+     * Remove repeated elements in place, keeping first occurrences in order.
+     * There are at most two distinct elements, found with indexOf.
+     */
+    void unique() {
+        ssize_t first = indexOf(true), second = indexOf(false);
+        Array<bool> result;
+
+        if (first >= 0 && (second < 0 || first < second)) {
+            result.push(true);
+        }
+        if (second >= 0) {
+            result.push(false);
+        }
+        if (first >= 0 && second >= 0 && second < first) {
+            result.push(true);
+        }
+
+        swap(result);
+    }
+
+    /**
+     * Create copy of the array without repeated elements.
+     *
+     * @returns Distinct elements in order of first occurrence.
+     */
+    Array<bool> toUnique() const {
+        Array<bool> result(*this);
+        result.unique();
+        return result;
+    }
+
+    /**
+     * Remove repeated adjacent elements in place, so a sorted array keeps
+     * one element per distinct value.
+     */
+    void uniqueSorted() {
+        Array<bool> result;
+
+        for (size_t i = 0; i < length_; ++i) {
+            bool value = (*this)[i];
+            if (i == 0 || value != (*this)[i - 1]) {
+                result.push(value);
+            }
+        }
+
+        swap(result);
+    }
+
+    /**
+     * Create copy of a sorted array without repeated elements.
+     *
+     * @returns Distinct elements.
+     */
+    Array<bool> toUniqueSorted() const {
+        Array<bool> result(*this);
+        result.uniqueSorted();
+        return result;
+    }
+
+    /**
+     * Create copy of the array with some elements removed and/or replaced
+     * by given items. Kept runs are copied a word at a time.
+     * @see https://developer.mozilla.org/en-US/docs/JavaScript/Reference/Global_Objects/Array/toSpliced
+     *
+     * @param start Index at which to start changing the array.
+     * @param skipCount Number of elements to remove.
+     * @param items Elements to insert at start.
+     * @returns New array.
+     */
+    template <typename... Args>
+    Array<bool> toSpliced(ssize_t start, size_t skipCount, Args... items) const {
+        size_t from = relativeIndex(start, length_), to = from + std::min(skipCount, length_ - from);
+        Array<bool> result = range(0, from);
+
+        result.append(Array<bool>::of(items...));
+        result.append(range(to, length_));
+
+        return result;
+    }
+
+    /**
+     * Create copy of the array with element under given index replaced.
+     * Negative index is counted from the end of the array.
+     * @see https://developer.mozilla.org/en-US/docs/JavaScript/Reference/Global_Objects/Array/with
+     *
+     * @param index Index.
+     * @param value New value.
+     * @returns New array.
+     * @throws std::out_of_range If index is out of the array's bounds.
+     */
+    Array<bool> with(ssize_t index, bool value) const {
+        ssize_t length = length_;
+
+        if (index < -length || index >= length) {
+            throw std::out_of_range("Array index out of range");
+        }
+
+        Array<bool> result(*this);
+        result[index < 0 ? index + length : index] = value;
+        return result;
+    }
+
+    /**
+     * Combine with another array of the same length, element-wise.
+     *
+     * @throws std::invalid_argument Lengths differ.
+     */
+    Array<bool> & operator &=(const Array<bool> & other) {
+        return combine(other, [] (Word a, Word b) { return a & b; });
+    }
+
+    Array<bool> & operator |=(const Array<bool> & other) {
+        return combine(other, [] (Word a, Word b) { return a | b; });
+    }
+
+    Array<bool> & operator ^=(const Array<bool> & other) {
+        return combine(other, [] (Word a, Word b) { return a ^ b; });
+    }
+
+    /**
+     * Negate all elements in place.
+     */
+    void flip() {
+        for (size_t w = 0; w < words_.size(); ++w) {
+            words_[w] = ~words_[w];
+        }
+        clearTail();
+    }
+
+    Array<bool> operator ~() const {
+        Array<bool> result(*this);
+        result.flip();
+        return result;
+    }
+
+    /**
+     * Execute a function for each element.
+     * @see https://developer.mozilla.org/en-US/docs/JavaScript/Reference/Global_Objects/Array/forEach
+     */
+    template <typename F>
+    void forEach(F callback) const {
+        for (size_t i = 0; i < length_; ++i) {
+            bool value = (*this)[i];
+            invokeCallback(callback, value, i, *this);
+        }
+    }
+
+    /**
+     * Create new array with callback's results for every element.
+     * @see https://developer.mozilla.org/en-US/docs/JavaScript/Reference/Global_Objects/Array/map
+     */
+    template <typename R = void, typename F>
+    Array<typename std::conditional<std::is_void<R>::value,
+        typename std::decay<decltype(invokeCallback(std::declval<F &>(), std::declval<bool &>(), size_t(), std::declval<const Array<bool> &>()))>::type, R>::type>
+    map(F callback) const {
+        typedef typename std::conditional<std::is_void<R>::value,
+            typename std::decay<decltype(invokeCallback(callback, std::declval<bool &>(), size_t(), *this))>::type, R>::type Result;
+
+        return Array<Result>::from(length_, [&] (size_t i) {
+            bool value = (*this)[i];
+            return invokeCallback(callback, value, i, *this);
+        });
+    }
+
+    /**
+     * Create new array of elements which pass the test.
+     * @see https://developer.mozilla.org/en-US/docs/JavaScript/Reference/Global_Objects/Array/filter
+     */
+    template <typename F>
+    typename std::enable_if<!std::is_same<F, Array<bool> >::value, Array<bool> >::type
+    filter(F test) const {
+        Array<bool> result;
+
+        for (size_t i = 0; i < length_; ++i) {
+            bool value = (*this)[i];
+            if (invokeCallback(test, value, i, *this)) {
+                result.push(value);
+            }
+        }
+
+        return result;
+    }
+
+    /**
+     * Select elements where mask is true.
+     *
+     * @param mask Mask; elements past its end are not selected.
+     * @returns Selected elements.
+     */
+    Array<bool> filter(const Array<bool> & mask) const {
+        size_t length = std::min(length_, mask.length_);
+        Array<bool> result;
+
+        for (size_t w = 0; w < wordsFor(length); ++w) {
+            Word bits = mask.words_[w];
+
+            if (length - w * WORD_BITS < WORD_BITS) {
+                bits &= (Word(1) << (length - w * WORD_BITS)) - 1;
+            }
+            for (; bits != 0; bits &= bits - 1) {
+                result.push((words_[w] >> __builtin_ctzll(bits)) & 1);
+            }
+        }
+
+        return result;
+    }
+
+    /**
+     * Same as filter(mask).
+     *
+     * @param mask Mask; elements past its end are not selected.
+     * @returns Selected elements.
+     */
+    Array<bool> select(const Array<bool> & mask) const {
+        return filter(mask);
+    }
+
+    /**
+     * Create new array of elements under given indexes, so that result[i] is
+     * this[indices[i]]. Result is assembled a word at a time.
+     *
+     * @tparam I Integral index type.
+     * @param indices Indexes to read.
+     * @returns New array of indices' length.
+     * @throws std::out_of_range If some index is out of the array's bounds.
+     */
+    template <typename I>
+    Array<bool> gather(const Array<I> & indices) const {
+        Array<bool> result(indices.length());
+
+        result.gatherWords(*this, indices.begin(), 0, result.words_.size());
+
+        return result;
+    }
+
+    /**
+     * Write values under given indexes, so that this[indices[i]] becomes
+     * values[i]. When an index repeats, the last value wins.
+     *
+     * @tparam I Integral index type.
+     * @param indices Indexes to write.
+     * @param values Values, one per index.
+     * @throws std::invalid_argument If lengths of indices and values differ.
+     * @throws std::out_of_range If some index is out of the array's bounds;
+     *         values before it are already written.
+     */
+    template <typename I>
+    void scatter(const Array<I> & indices, const Array<bool> & values) {
+        if (indices.length() != values.length()) {
+            throw std::invalid_argument("Scatter indices and values lengths differ");
+        }
+
+        const I * index = indices.begin();
+
+        for (size_t i = 0; i < values.length_; ++i) {
+            if (static_cast<size_t>(index[i]) >= length_) {
+                throw std::out_of_range("Scatter index out of range");
+            }
+            setBits(words_[index[i] / WORD_BITS], Word(1) << (index[i] % WORD_BITS), values[i]);
+        }
+    }
+
+    /**
+     * Reorder elements, so that this[i] becomes old this[order[i]].
+     *
+     * @tparam I Integral index type.
+     * @param order Permutation of the array's indexes.
+     * @throws std::invalid_argument If order is not a permutation of the
+     *         array's indexes; the array is left unchanged.
+     */
+    template <typename I>
+    void permute(const Array<I> & order) {
+        if (order.length() != length_) {
+            throw std::invalid_argument("Permutation length differs from array length");
+        }
+
+        const I * index = order.begin();
+        std::vector<bool> seen(length_);
+
+        for (size_t i = 0; i < length_; ++i) {
+            size_t j = index[i];
+
+            if (j >= length_ || seen[j]) {
+                throw std::invalid_argument("Order is not a permutation");
+            }
+            seen[j] = true;
+        }
+
+        Array<bool> result = gather(order);
+        swap(result);
+    }
+
+    /**
+     * Split the array into elements passed the test and the rest.
+     *
+     * @tparam Predicate Test implementation type.
+     * @param test Test implementation.
+     * @returns Pair of arrays: passed elements and failed ones.
+     */
+    template <typename Predicate>
+    std::pair<Array<bool>, Array<bool> > partition(Predicate test) const {
+        std::pair<Array<bool>, Array<bool> > result;
+
+        for (size_t i = 0; i < length_; ++i) {
+            bool value = (*this)[i];
+            (invokeCallback(test, value, i, *this) ? result.first : result.second).push(value);
+        }
+
+        return result;
+    }
+
+    /**
+     * Group elements by keys generated by given function. Order of elements
+     * inside every group is preserved.
+     * @see https://developer.mozilla.org/en-US/docs/Web/JavaScript/Reference/Global_Objects/Map/groupBy
+     *
+     * @tparam KeyFn Key function type.
+     * @param keyFn Function generating key for an element.
+     * @returns Map from keys to groups.
+     */
+    template <typename KeyFn>
+    std::unordered_map<typename GroupKey<KeyFn>::type, Array<bool> > groupBy(KeyFn keyFn) const {
+        return groupRange(0, length_, keyFn);
+    }
+
+    /**
+     * Apply a function against an accumulator and each element, using the
+     * first element as the initial value.
+     * @see https://developer.mozilla.org/en-US/docs/JavaScript/Reference/Global_Objects/Array/reduce
+     */
+    template <typename F = std::plus<bool> >
+    bool reduce(F callback = F()) const {
+        return reduce(callback, (*this)[0], 1);
+    }
+
+    /**
+     * Apply a function against an accumulator and each element, starting
+     * from given index.
+     * @see https://developer.mozilla.org/en-US/docs/JavaScript/Reference/Global_Objects/Array/reduce
+     */
+    template <typename F, typename R>
+    R reduce(F callback, R initialValue, size_t startFrom = 0) const {
+        for (size_t i = startFrom; i < length_; ++i) {
+            bool value = (*this)[i];
+            initialValue = invokeReducer(callback, initialValue, value, i, *this);
+        }
+
+        return initialValue;
+    }
+
+    /**
+     * Join elements as "true" and "false".
+     * @see https://developer.mozilla.org/en-US/docs/Web/JavaScript/Reference/Global_Objects/Array/join
+     */
+    std::string join(const std::string & separator = ",") const {
+        std::string result;
+
+        for (size_t i = 0; i < length_; ++i) {
+            if (i != 0) {
+                result += separator;
+            }
+            appendString(result, (*this)[i]);
+        }
+
+        return result;
+    }
+
+    /**
+     * Get range of the array's indexes.
+     * @see https://developer.mozilla.org/en-US/docs/JavaScript/Reference/Global_Objects/Array/keys
+     */
+    Range<KeyIterator> keys() const {
+        return Range<KeyIterator>(KeyIterator(0), KeyIterator(length_));
+    }
+
+    /**
+     * Get range of the array's elements.
+     * @see https://developer.mozilla.org/en-US/docs/JavaScript/Reference/Global_Objects/Array/values
+     */
+    Range<const_iterator> values() const {
+        return Range<const_iterator>(begin(), end());
+    }
+
+    /**
+     * Get range of (index, element) pairs; elements are given by value.
+     * @see https://developer.mozilla.org/en-US/docs/JavaScript/Reference/Global_Objects/Array/entries
+     */
+    Range<const_entry_iterator> entries() const {
+        return Range<const_entry_iterator>(const_entry_iterator(this, 0), const_entry_iterator(this, length_));
+    }
+
+private:
+    static size_t wordsFor(size_t length) {
+        return (length + WORD_BITS - 1) / WORD_BITS;
+    }
+
+    static void setBits(Word & word, Word mask, bool value) {
+        word = value ? word | mask : word & ~mask;
+    }
+
+    /**
+     * Get mask of bits of the last word which are within the length.
+     */
+    Word tailMask() const {
+        return length_ % WORD_BITS ? (Word(1) << (length_ % WORD_BITS)) - 1 : ~Word(0);
+    }
+
+    void clearTail() {
+        if (!words_.empty()) {
+            words_.back() &= tailMask();
+        }
+    }
+
+    void resize(size_t length) {
+        length_ = length;
+        words_.resize(wordsFor(length), 0);
+        clearTail();
+    }
+
+    static Word reverseBits(Word word) {
+        word = __builtin_bswap64(word);
+        word = ((word >> 4) & 0x0f0f0f0f0f0f0f0fULL) | ((word & 0x0f0f0f0f0f0f0f0fULL) << 4);
+        word = ((word >> 2) & 0x3333333333333333ULL) | ((word & 0x3333333333333333ULL) << 2);
+        return ((word >> 1) & 0x5555555555555555ULL) | ((word & 0x5555555555555555ULL) << 1);
+    }
+
+    /**
+     * Shift all words down by given number of bits, less than a word.
+     */
+    void shiftDown(size_t bits) {
+        if (bits == 0) {
+            return;
+        }
+        for (size_t w = 0; w < words_.size(); ++w) {
+            words_[w] = (words_[w] >> bits) | (w + 1 < words_.size() ? words_[w + 1] << (WORD_BITS - bits) : 0);
+        }
+    }
+
+    /**
+     * Get up to a word of elements starting at given index; elements past
+     * the end read as false.
+     */
+    Word extract(size_t index) const {
+        size_t w = index / WORD_BITS, offset = index % WORD_BITS;
+        Word result = w < words_.size() ? words_[w] >> offset : 0;
+
+        if (offset != 0 && w + 1 < words_.size()) {
+            result |= words_[w + 1] << (WORD_BITS - offset);
+        }
+
+        return result;
+    }
+
+    /**
+     * Copy elements in [from, to) to a new array, a word at a time.
+     */
+    Array<bool> range(size_t from, size_t to) const {
+        Array<bool> result(to - from);
+
+        for (size_t w = 0; w < result.words_.size(); ++w) {
+            result.words_[w] = extract(from + w * WORD_BITS);
+        }
+        result.clearTail();
+
+        return result;
+    }
+
+    /**
+     * Overwrite elements starting at given index with source's ones, a word
+     * at a time. Source must fit into the array.
+     */
+    void assign(size_t index, const Array<bool> & source) {
+        for (size_t i = 0; i < source.length_; i += WORD_BITS) {
+            size_t count = std::min(size_t(WORD_BITS), source.length_ - i), w = (index + i) / WORD_BITS, offset = (index + i) % WORD_BITS;
+            Word mask = count == WORD_BITS ? ~Word(0) : (Word(1) << count) - 1, value = source.words_[i / WORD_BITS] & mask;
+
+            words_[w] = (words_[w] & ~(mask << offset)) | (value << offset);
+            if (offset != 0 && offset + count > WORD_BITS) {
+                words_[w + 1] = (words_[w + 1] & ~(mask >> (WORD_BITS - offset))) | (value >> (WORD_BITS - offset));
+            }
+        }
+    }
+
+    void append(const Array<bool> & other) {
+        size_t index = length_;
+
+        resize(length_ + other.length_);
+        assign(index, other);
+    }
+
+    void swap(Array<bool> & other) {
+        words_.swap(other.words_);
+        std::swap(length_, other.length_);
+    }
+
+    /**
+     * Assemble result words [begin, end) from source's elements under given
+     * indexes.
+     */
+    template <typename I>
+    void gatherWords(const Array<bool> & source, const I * indices, size_t begin, size_t end) {
+        for (size_t w = begin; w < end; ++w) {
+            Word word = 0;
+
+            for (size_t bit = 0, i = w * WORD_BITS; bit < WORD_BITS && i < length_; ++bit, ++i) {
+                if (static_cast<size_t>(indices[i]) >= source.length_) {
+                    throw std::out_of_range("Gather index out of range");
+                }
+                word |= Word(source[indices[i]] ? 1 : 0) << bit;
+            }
+            words_[w] = word;
+        }
+    }
+
+    template <typename KeyFn>
+    std::unordered_map<typename GroupKey<KeyFn>::type, Array<bool> > groupRange(size_t begin, size_t end, KeyFn & keyFn) const {
+        std::unordered_map<typename GroupKey<KeyFn>::type, Array<bool> > result;
+
+        for (size_t i = begin; i < end; ++i) {
+            bool value = (*this)[i];
+            result[invokeCallback(keyFn, value, i, *this)].push(value);
+        }
+
+        return result;
+    }
+
+    template <typename Op>
+    Array<bool> & combine(const Array<bool> & other, Op op) {
+        if (other.length_ != length_) {
+            throw std::invalid_argument("Combined arrays must have the same length");
+        }
+
+        for (size_t w = 0; w < words_.size(); ++w) {
+            words_[w] = op(words_[w], other.words_[w]);
+        }
+
+        return *this;
+    }
+
+    std::vector<Word> words_;
+    size_t length_;
+};
+
+inline Array<bool> operator &(Array<bool> a, const Array<bool> & b) {
+    a &= b;
+    return a;
+}
+
+inline Array<bool> operator |(Array<bool> a, const Array<bool> & b) {
+    a |= b;
+    return a;
+}
+
+inline Array<bool> operator ^(Array<bool> a, const Array<bool> & b) {
+    a ^= b;
+    return a;
+}
+
+} // namespace js4cpp
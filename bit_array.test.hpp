@@ -0,0 +1,221 @@
+#pragma once
+
+#include <functional>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+#include <cppunit/TestCaller.h>
+#include <cppunit/TestCase.h>
+#include <cppunit/TestSuite.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+#include "array.hpp"
+#include "parallel.hpp"
+
+class BitArrayTest : public CppUnit::TestCase
+{
+public:
+    BitArrayTest() : CppUnit::TestCase("Array<bool> Test Case") {};
+
+    void testAccess() {
+        using js4cpp::Array;
+
+        CPPUNIT_ASSERT( bits->length() == 200 && bits->wordCount() == 4 && (*bits)[0] && !(*bits)[1] && (*bits)[198] );
+
+        Array<bool> flags;
+        flags[70] = true;
+        CPPUNIT_ASSERT( flags.length() == 71 && flags[70] && !flags[69] && flags.count() == 1 );
+
+        flags[3] = flags[70];
+        flags.push(true);
+        CPPUNIT_ASSERT( flags.length() == 72 && flags.count() == 3 && flags.pop() && flags.length() == 71 );
+        CPPUNIT_ASSERT( Array<bool>::of(true, false, true).join() == "true,false,true" );
+        CPPUNIT_ASSERT( Array<bool>(130, true).count() == 130 );
+    }
+
+    void testScans() {
+        using js4cpp::Array;
+
+        CPPUNIT_ASSERT( bits->count() == 67 );
+        CPPUNIT_ASSERT( !bits->every() && bits->some() );
+        CPPUNIT_ASSERT( Array<bool>(129, true).every() && Array<bool>(64, true).every() && Array<bool>().every() );
+        CPPUNIT_ASSERT( !Array<bool>(129).some() && !Array<bool>().some() );
+
+        CPPUNIT_ASSERT( bits->indexOf(true) == 0 && bits->indexOf(true, 1) == 3 && bits->indexOf(true, 190) == 192 );
+        CPPUNIT_ASSERT( bits->indexOf(false) == 1 && bits->indexOf(true, 199) == -1 && bits->indexOf(false, 500) == -1 );
+        CPPUNIT_ASSERT( Array<bool>(100, true).indexOf(false) == -1 && Array<bool>(100).indexOf(true) == -1 );
+        CPPUNIT_ASSERT( bits->lastIndexOf(true) == 198 && bits->lastIndexOf(false) == 199 && bits->lastIndexOf(true, 2) == 195 );
+        CPPUNIT_ASSERT( Array<bool>(100).lastIndexOf(true) == -1 );
+
+        CPPUNIT_ASSERT( bits->every([] (bool value, size_t index) { return value == (index % 3 == 0); }) );
+        CPPUNIT_ASSERT( bits->some([] (bool value, size_t index) { return value && index == 99; }) );
+        CPPUNIT_ASSERT( bits->reduce([] (int sum, bool value) { return sum + value; }, 0) == 67 );
+        CPPUNIT_ASSERT( bits->map([] (bool value) { return value ? 2 : 1; }).reduce(std::plus<int>(), 0) == 267 );
+        CPPUNIT_ASSERT( bits->filter([] (bool value) { return value; }).length() == 67 );
+    }
+
+    void testFill() {
+        using js4cpp::Array;
+
+        Array<bool> flags(300);
+        flags.fill(true, 10, 250);
+        CPPUNIT_ASSERT( flags.count() == 240 && !flags[9] && flags[10] && flags[249] && !flags[250] );
+
+        flags.fill(false, 60, 70);
+        CPPUNIT_ASSERT( flags.count() == 230 && flags.indexOf(false, 10) == 60 );
+
+        flags.fill(true, -1);
+        CPPUNIT_ASSERT( flags[299] && flags.count() == 231 );
+
+        flags.fill(true);
+        CPPUNIT_ASSERT( flags.every() && flags.count() == 300 );
+    }
+
+    void testBitwise() {
+        using js4cpp::Array;
+
+        Array<bool> evens = Array<bool>::from(200, [] (size_t i) { return i % 2 == 0; });
+        CPPUNIT_ASSERT( (*bits & evens).count() == 34 );
+        CPPUNIT_ASSERT( (*bits | evens).count() == 133 );
+        CPPUNIT_ASSERT( (*bits ^ evens).count() == 99 );
+        CPPUNIT_ASSERT( (~*bits).count() == 133 && (~*bits)[1] );
+
+        bool thrown = false;
+        try {
+            evens &= Array<bool>(3);
+        } catch (const std::invalid_argument &) {
+            thrown = true;
+        }
+        CPPUNIT_ASSERT( thrown );
+    }
+
+    void testFilterByMask() {
+        using js4cpp::Array;
+
+        Array<int> numbers = Array<int>::from(200, [] (size_t i) { return int(i); });
+        Array<int> selected = numbers.filter(*bits);
+        CPPUNIT_ASSERT( selected.length() == 67 && selected[1] == 3 && selected[66] == 198 );
+
+        CPPUNIT_ASSERT( Array<int>::of(1, 2, 3).filter(*bits).join() == "1" );
+        CPPUNIT_ASSERT( numbers.filter(Array<bool>::of(false, true)).join() == "1" );
+        CPPUNIT_ASSERT( bits->filter(*bits).every() && bits->filter(*bits).length() == 67 );
+    }
+
+    void testReorder() {
+        using js4cpp::Array;
+
+        Array<bool> flags(*bits);
+        flags.unshift(true);
+        CPPUNIT_ASSERT( flags.length() == 201 && flags.count() == 68 && flags[0] && flags[1] && !flags[2] && flags[4] && flags[199] );
+        CPPUNIT_ASSERT( flags.shift() && flags.length() == 200 && flags.join() == bits->join() );
+
+        Array<bool> reversed = bits->toReversed();
+        CPPUNIT_ASSERT( reversed.every([this] (bool value, size_t index) { return value == (*bits)[199 - index]; }) );
+        reversed.reverse();
+        CPPUNIT_ASSERT( reversed.join() == bits->join() && reversed.wordCount() == 4 );
+
+        Array<bool> part = bits->slice(3, 150);
+        CPPUNIT_ASSERT( part.length() == 147 && part.count() == 49 && part.every([] (bool value, size_t index) { return value == (index % 3 == 0); }) );
+        CPPUNIT_ASSERT( bits->slice(-5, -1).join() == "true,false,false,true" );
+
+        Array<bool> copied(*bits);
+        copied.copyWithin(70, 0, 100);
+        CPPUNIT_ASSERT( copied.every([this] (bool value, size_t index) {
+            return value == (*bits)[index >= 70 && index < 170 ? index - 70 : index];
+        }) );
+        copied = *bits;
+        copied.copyWithin(0, 1);
+        CPPUNIT_ASSERT( copied[2] && !copied[3] && copied[197] && !copied[199] && copied.count() == 66 );
+
+        Array<bool> sorted = bits->toSorted();
+        CPPUNIT_ASSERT( sorted.indexOf(true) == 133 && sorted.count() == 67 && sorted.lastIndexOf(false) == 132 );
+        sorted.sort([] (bool a, bool b) { return a > b; });
+        CPPUNIT_ASSERT( sorted.indexOf(false) == 67 && sorted.count() == 67 );
+
+        CPPUNIT_ASSERT( bits->toUnique().join() == "true,false" && Array<bool>::of(false, false, true).toUnique().join() == "false,true" );
+        CPPUNIT_ASSERT( Array<bool>(70, true).toUnique().join() == "true" && Array<bool>().toUnique().length() == 0 );
+        CPPUNIT_ASSERT( Array<bool>::of(true, true, false, false, true).toUniqueSorted().join() == "true,false,true" );
+
+        CPPUNIT_ASSERT( Array<bool>::of(true, false, true).toSpliced(1, 1, true, true).join() == "true,true,true,true" );
+        Array<bool> spliced = bits->toSpliced(100, 50, true);
+        CPPUNIT_ASSERT( spliced.length() == 151 && spliced[100] && spliced[101] && !spliced[102] && spliced[150] == (*bits)[199] );
+
+        CPPUNIT_ASSERT( bits->with(1, true)[1] && !bits->with(-2, true)[199] && bits->with(-2, true)[198] == (*bits)[198] );
+        bool thrown = false;
+        try {
+            bits->with(200, true);
+        } catch (const std::out_of_range &) {
+            thrown = true;
+        }
+        CPPUNIT_ASSERT( thrown );
+        CPPUNIT_ASSERT( (!std::is_convertible<size_t, Array<bool> >::value) );
+    }
+
+    void testIndexed() {
+        using js4cpp::Array;
+
+        Array<int> backwards = Array<int>::from(200, [] (size_t i) { return int(199 - i); });
+        CPPUNIT_ASSERT( bits->gather(backwards).join() == bits->toReversed().join() );
+        CPPUNIT_ASSERT( js4cpp::gatherParallel(*bits, backwards, 4).join() == bits->toReversed().join() );
+
+        Array<bool> permuted(*bits);
+        permuted.permute(backwards);
+        CPPUNIT_ASSERT( permuted.join() == bits->toReversed().join() );
+
+        bool thrown = false;
+        try {
+            permuted.permute(Array<int>(200));
+        } catch (const std::invalid_argument &) {
+            thrown = true;
+        }
+        CPPUNIT_ASSERT( thrown && permuted.join() == bits->toReversed().join() );
+
+        Array<bool> flags(100);
+        flags.scatter(Array<int>::of(3, 64, 99), Array<bool>::of(true, true, true));
+        CPPUNIT_ASSERT( flags.count() == 3 && flags[64] && flags.indexOf(true) == 3 && flags.lastIndexOf(true) == 99 );
+        CPPUNIT_ASSERT( bits->select(*bits).length() == 67 );
+
+        CPPUNIT_ASSERT( Array<bool>::of(false, true).reduce() && !bits->reduce(std::logical_and<bool>()) );
+        CPPUNIT_ASSERT( bits->reduce([] (int sum, bool value) { return sum + value; }, 0, 100) == 33 );
+
+        std::pair<Array<bool>, Array<bool> > parts = bits->partition([] (bool value) { return value; });
+        CPPUNIT_ASSERT( parts.first.length() == 67 && parts.first.every() && parts.second.length() == 133 && !parts.second.some() );
+
+        auto groups = bits->groupBy([] (bool, size_t index) { return index % 2; });
+        auto parallelGroups = js4cpp::groupByParallel(*bits, [] (bool, size_t index) { return index % 2; }, 4);
+        CPPUNIT_ASSERT( groups.size() == 2 && groups[0].length() == 100 && groups[0].count() == 34 && groups[1].count() == 33 );
+        CPPUNIT_ASSERT( parallelGroups[0].join() == groups[0].join() && parallelGroups[1].join() == groups[1].join() );
+
+        size_t keys = 0, trues = 0;
+        for (size_t key : bits->keys()) {
+            keys += key;
+        }
+        for (auto entry : bits->entries()) {
+            trues += entry.second && entry.first % 3 == 0;
+        }
+        CPPUNIT_ASSERT( keys == 19900 && trues == 67 && bits->values().size() == 200 );
+    }
+
+    void setUp() {
+        bits = new js4cpp::Array<bool>(js4cpp::Array<bool>::from(200, [] (size_t i) { return i % 3 == 0; }));
+    }
+
+    void tearDown() {
+        delete bits;
+    }
+
+    CPPUNIT_TEST_SUITE( BitArrayTest );
+    CPPUNIT_TEST( testAccess );
+    CPPUNIT_TEST( testScans );
+    CPPUNIT_TEST( testFill );
+    CPPUNIT_TEST( testBitwise );
+    CPPUNIT_TEST( testFilterByMask );
+    CPPUNIT_TEST( testReorder );
+    CPPUNIT_TEST( testIndexed );
+    CPPUNIT_TEST_SUITE_END();
+
+private:
+    js4cpp::Array<bool> * bits;
+};
@@ -0,0 +1,263 @@
+/* Copyright (c) 2012 Kirill Dmitrenko <kdmitrenko@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is furnished
+ * to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * @file concurrent_array.hpp
+ * Append-only Array safe to push to from many threads.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+#include "array.hpp"
+
+namespace js4cpp {
+
+/**
+ * Append-only array which many threads can push to and read from at once,
+ * without locks.
+ *
+ * Elements live in segments of doubling sizes (64, 128, 256, ...), so they
+ * are never relocated: pushing reserves an index with a single atomic
+ * increment, constructs the element in its slot and then publishes it.
+ * Readers only see published elements, which are immutable. If the
+ * element's constructor throws, its slot is marked as failed instead: the
+ * index stays taken but never gets an element.
+ *
+ * @tparam T Elements type.
+ */
+template <typename T> class ConcurrentArray
+{
+    enum {
+        EMPTY,
+        PUBLISHED,
+        FAILED
+    };
+
+    struct Slot {
+        std::atomic<unsigned char> state;
+        typename std::aligned_storage<sizeof(T), std::alignment_of<T>::value>::type storage;
+
+        T * element() {
+            return reinterpret_cast<T *>(&storage);
+        }
+
+        const T * element() const {
+            return reinterpret_cast<const T *>(&storage);
+        }
+    };
+
+public:
+    /**
+     * Create empty array.
+     */
+    ConcurrentArray() : length_(0) {
+        for (size_t k = 0; k < SEGMENTS; ++k) {
+            segments_[k].store(0, std::memory_order_relaxed);
+        }
+    }
+
+    ~ConcurrentArray() {
+        for (size_t k = 0; k < SEGMENTS; ++k) {
+            Slot * segment = segments_[k].load(std::memory_order_relaxed);
+
+            if (!segment) {
+                continue;
+            }
+            for (size_t i = 0; i < segmentLength(k); ++i) {
+                if (segment[i].state.load(std::memory_order_relaxed) == PUBLISHED) {
+                    segment[i].element()->~T();
+                }
+            }
+            delete [] segment;
+        }
+    }
+
+    ConcurrentArray(const ConcurrentArray &) = delete;
+    ConcurrentArray & operator =(const ConcurrentArray &) = delete;
+
+    /**
+     * Get number of reserved elements: published ones and those being pushed
+     * right now.
+     *
+     * @returns Length.
+     */
+    size_t length() const {
+        return length_.load(std::memory_order_acquire);
+    }
+
+    /**
+     * Add an element to the end of the array. Safe to call concurrently.
+     * @see https://developer.mozilla.org/en-US/docs/Web/JavaScript/Reference/Global_Objects/Array/push
+     *
+     * @param args Element's constructor arguments.
+     * @returns Element's index.
+     * @throws Whatever element's constructor throws; the index is then
+     *         marked as failed and is never published.
+     */
+    template <typename... Args>
+    size_t push(Args &&... args) {
+        size_t index = length_.fetch_add(1, std::memory_order_relaxed);
+        Slot & slot = slotAt(index);
+
+        try {
+            ::new (static_cast<void *>(&slot.storage)) T(std::forward<Args>(args)...);
+        } catch (...) {
+            slot.state.store(FAILED, std::memory_order_release);
+            throw;
+        }
+        slot.state.store(PUBLISHED, std::memory_order_release);
+
+        return index;
+    }
+
+    /**
+     * Check whether element under given index is published, i.e. can be
+     * read.
+     *
+     * @param index Index.
+     */
+    bool published(size_t index) const {
+        const Slot * slot = findSlot(index);
+
+        return slot && slot->state.load(std::memory_order_acquire) == PUBLISHED;
+    }
+
+    /**
+     * Get published element under given index.
+     *
+     * @param index Index.
+     * @returns Element.
+     * @throws std::out_of_range If element is not published (yet) or failed
+     *         to construct.
+     */
+    const T & operator [](size_t index) const {
+        if (!published(index)) {
+            throw std::out_of_range("ConcurrentArray element is not published");
+        }
+
+        return *findSlot(index)->element();
+    }
+
+    /**
+     * Copy published elements into a regular Array. Copying stops at the
+     * first element which is not published yet, so the snapshot is always
+     * a prefix of the array without gaps. Failed elements are skipped, so
+     * after a failed push indexes in the snapshot differ from push's ones.
+     *
+     * @returns Array of elements.
+     */
+    Array<T> snapshot() const {
+        size_t length = this->length(), count = 0, failed = 0;
+
+        for (; count < length; ++count) {
+            const Slot * slot = findSlot(count);
+            unsigned char state = slot ? slot->state.load(std::memory_order_acquire) : static_cast<unsigned char>(EMPTY);
+
+            if (state == EMPTY) {
+                break;
+            }
+            failed += state == FAILED;
+        }
+
+        if (failed == 0) {
+            return Array<T>::from(count, [this] (size_t index) -> const T & {
+                return *findSlot(index)->element();
+            });
+        }
+
+        Array<T> result;
+
+        for (size_t index = 0; index < count; ++index) {
+            const Slot * slot = findSlot(index);
+
+            if (slot->state.load(std::memory_order_relaxed) == PUBLISHED) {
+                result.push(*slot->element());
+            }
+        }
+
+        return result;
+    }
+
+private:
+    /**
+     * Binary logarithm of the first segment's length.
+     */
+    static const size_t FIRST_SEGMENT_BITS = 6;
+
+    static const size_t SEGMENTS = 64 - FIRST_SEGMENT_BITS;
+
+    static size_t segmentLength(size_t k) {
+        return size_t(1) << (k + FIRST_SEGMENT_BITS);
+    }
+
+    /**
+     * Get segment and offset of an index. Segment k starts at index
+     * 2^(k + b) - 2^b, so index + 2^b has its highest bit at k + b.
+     */
+    static void locate(size_t index, size_t & k, size_t & offset) {
+        uint64_t position = uint64_t(index) + (uint64_t(1) << FIRST_SEGMENT_BITS);
+        size_t high = 63 - __builtin_clzll(position);
+
+        k = high - FIRST_SEGMENT_BITS;
+        offset = position - (uint64_t(1) << high);
+    }
+
+    const Slot * findSlot(size_t index) const {
+        size_t k, offset;
+
+        locate(index, k, offset);
+        const Slot * segment = segments_[k].load(std::memory_order_acquire);
+
+        return segment ? segment + offset : 0;
+    }
+
+    Slot & slotAt(size_t index) {
+        size_t k, offset;
+
+        locate(index, k, offset);
+        Slot * segment = segments_[k].load(std::memory_order_acquire);
+
+        if (!segment) {
+            // Every pusher into a missing segment races to install it; the
+            // losers free their copies.
+            Slot * fresh = new Slot[segmentLength(k)]();
+
+            if (segments_[k].compare_exchange_strong(segment, fresh, std::memory_order_acq_rel, std::memory_order_acquire)) {
+                segment = fresh;
+            } else {
+                delete [] fresh;
+            }
+        }
+
+        return segment[offset];
+    }
+
+    std::atomic<size_t> length_;
+    std::atomic<Slot *> segments_[SEGMENTS];
+};
+
+} // namespace js4cpp
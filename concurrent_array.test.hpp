@@ -0,0 +1,103 @@
+#pragma once
+
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <cppunit/TestCaller.h>
+#include <cppunit/TestCase.h>
+#include <cppunit/TestSuite.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+#include "concurrent_array.hpp"
+
+class ConcurrentArrayTest : public CppUnit::TestCase
+{
+public:
+    ConcurrentArrayTest() : CppUnit::TestCase("ConcurrentArray Test Case") {};
+
+    void testPush() {
+        js4cpp::ConcurrentArray<std::string> words;
+
+        CPPUNIT_ASSERT( words.length() == 0 && !words.published(0) );
+        CPPUNIT_ASSERT( words.push("a") == 0 && words.push(3, 'b') == 1 );
+        CPPUNIT_ASSERT( words.length() == 2 && words.published(1) && words[1] == "bbb" );
+        CPPUNIT_ASSERT( words.snapshot().join() == "a,bbb" );
+
+        for (int i = 0; i < 1000; ++i) {
+            words.push(std::to_string(i));
+        }
+        CPPUNIT_ASSERT( words.length() == 1002 && words[1001] == "999" && words[64] == "62" );
+
+        bool thrown = false;
+        try {
+            words[1002];
+        } catch (const std::out_of_range &) {
+            thrown = true;
+        }
+        CPPUNIT_ASSERT( thrown );
+    }
+
+    void testConcurrentPush() {
+        const int producers = 4, count = 20000;
+        js4cpp::ConcurrentArray<int> numbers;
+        std::vector<std::thread> threads;
+
+        for (int p = 0; p < producers; ++p) {
+            threads.push_back(std::thread([&numbers, p, count] {
+                for (int i = 0; i < count; ++i) {
+                    numbers.push(p * count + i);
+                }
+            }));
+        }
+        for (size_t p = 0; p < threads.size(); ++p) {
+            threads[p].join();
+        }
+
+        js4cpp::Array<int> snapshot = numbers.snapshot();
+        CPPUNIT_ASSERT( snapshot.length() == size_t(producers * count) );
+
+        std::vector<char> seen(producers * count);
+        for (size_t i = 0; i < snapshot.length(); ++i) {
+            seen[snapshot[i]] = 1;
+        }
+        CPPUNIT_ASSERT( std::count(seen.begin(), seen.end(), 1) == producers * count );
+    }
+
+    void testFailedPush() {
+        js4cpp::ConcurrentArray<std::string> words;
+
+        words.push("a");
+        bool thrown = false;
+        try {
+            words.push(std::string::npos, 'x');
+        } catch (const std::length_error &) {
+            thrown = true;
+        }
+        CPPUNIT_ASSERT( thrown && words.push("c") == 2 );
+        CPPUNIT_ASSERT( words.length() == 3 && !words.published(1) && words.published(2) );
+        CPPUNIT_ASSERT( words.snapshot().join() == "a,c" );
+
+        thrown = false;
+        try {
+            words[1];
+        } catch (const std::out_of_range &) {
+            thrown = true;
+        }
+        CPPUNIT_ASSERT( thrown );
+    }
+
+    void setUp() {}
+
+    void tearDown() {}
+
+    CPPUNIT_TEST_SUITE( ConcurrentArrayTest );
+
+        CPPUNIT_TEST( testPush );
+        CPPUNIT_TEST( testConcurrentPush );
+        CPPUNIT_TEST( testFailedPush );
+
+    CPPUNIT_TEST_SUITE_END();
+};
@@ -0,0 +1,387 @@
+/* Copyright (c) 2012 Kirill Dmitrenko <kdmitrenko@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is furnished
+ * to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * @file coroutine.hpp
+ * C++20 coroutines over Promise: async functions and async generators.
+ * Empty unless the compiler supports coroutines.
+ */
+
+#pragma once
+
+#if defined(__cpp_impl_coroutine) && __cpp_impl_coroutine >= 201902L
+
+#include <coroutine>
+#include <cstddef>
+#include <exception>
+#include <new>
+#include <stdexcept>
+#include <utility>
+
+#include "array.hpp"
+#include "promise.hpp"
+
+namespace js4cpp {
+
+/**
+ * Per-thread pool of coroutine frames. Frames are grouped into 64-byte size
+ * classes up to 4 KiB; freed frames are kept for reuse, up to a limit per
+ * class, and bigger ones go straight to the heap.
+ */
+class FramePool
+{
+public:
+    static void * allocate(size_t size) {
+        size_t index = classOf(size);
+
+        if (index >= CLASSES || closed()) {
+            return ::operator new(size);
+        }
+
+        Lists & lists = local();
+        Frame * frame = lists.heads[index];
+
+        if (!frame) {
+            return ::operator new((index + 1) * GRANULARITY);
+        }
+        lists.heads[index] = frame->next;
+        --lists.lengths[index];
+
+        return frame;
+    }
+
+    static void deallocate(void * memory, size_t size) {
+        size_t index = classOf(size);
+
+        if (index >= CLASSES || closed() || local().lengths[index] >= MAX_FREE) {
+            ::operator delete(memory);
+            return;
+        }
+
+        Lists & lists = local();
+        Frame * frame = static_cast<Frame *>(memory);
+
+        frame->next = lists.heads[index];
+        lists.heads[index] = frame;
+        ++lists.lengths[index];
+    }
+
+private:
+    static const size_t GRANULARITY = 64;
+    static const size_t CLASSES = 64;
+    static const size_t MAX_FREE = 256;
+
+    struct Frame {
+        Frame * next;
+    };
+
+    struct Lists {
+        Lists() : heads(), lengths() {}
+
+        ~Lists() {
+            closed() = true;
+            for (size_t i = 0; i < CLASSES; ++i) {
+                while (heads[i]) {
+                    Frame * next = heads[i]->next;
+                    ::operator delete(heads[i]);
+                    heads[i] = next;
+                }
+            }
+        }
+
+        Frame * heads[CLASSES];
+        size_t lengths[CLASSES];
+    };
+
+    static size_t classOf(size_t size) {
+        return size == 0 ? 0 : (size - 1) / GRANULARITY;
+    }
+
+    /**
+     * Whether the thread's lists are destroyed already, so that frames
+     * freed later, by other thread-local destructors, bypass the pool.
+     */
+    static bool & closed() {
+        static thread_local bool closed = false;
+
+        return closed;
+    }
+
+    static Lists & local() {
+        static thread_local Lists lists;
+
+        return lists;
+    }
+};
+
+/**
+ * Base of coroutine promise types allocating frames from FramePool.
+ */
+struct PooledFrame {
+    static void * operator new(size_t size) {
+        return FramePool::allocate(size);
+    }
+
+    static void operator delete(void * memory, size_t size) {
+        FramePool::deallocate(memory, size);
+    }
+};
+
+/**
+ * Awaiter of a Promise: resumes the coroutine in a microtask once the
+ * promise settles, like `await` does, and returns its value or throws its
+ * reason.
+ *
+ * @tparam T Value type.
+ */
+template <typename T> struct PromiseAwaiter {
+    bool await_ready() const noexcept {
+        return false;
+    }
+
+    void await_suspend(std::coroutine_handle<> handle) const {
+        promise.subscribe([handle] (const T &) {
+            handle.resume();
+        }, [handle] (std::exception_ptr) {
+            handle.resume();
+        });
+    }
+
+    T await_resume() const {
+        if (promise.status() == Rejected) {
+            std::rethrow_exception(promise.reason());
+        }
+
+        return promise.value();
+    }
+
+    Promise<T> promise;
+};
+
+/**
+ * Await promise in a coroutine.
+ * @see https://developer.mozilla.org/en-US/docs/Web/JavaScript/Reference/Operators/await
+ */
+template <typename T>
+PromiseAwaiter<T> operator co_await(Promise<T> promise) {
+    return PromiseAwaiter<T>{std::move(promise)};
+}
+
+template <typename T> struct AsyncFunctionBase : PooledFrame {
+    AsyncFunctionBase() : resolvers(Promise<T>::withResolvers()) {}
+
+    Promise<T> get_return_object() {
+        return resolvers.promise;
+    }
+
+    std::suspend_never initial_suspend() noexcept {
+        return {};
+    }
+
+    std::suspend_never final_suspend() noexcept {
+        return {};
+    }
+
+    void unhandled_exception() {
+        resolvers.reject(std::current_exception());
+    }
+
+    typename Promise<T>::WithResolvers resolvers;
+};
+
+/**
+ * Promise type of coroutines returning Promise<T>, which work like JS async
+ * functions: they run synchronously up to the first co_await, and co_return
+ * fulfills (an escaping exception rejects) the returned promise.
+ * @see https://developer.mozilla.org/en-US/docs/Web/JavaScript/Reference/Statements/async_function
+ *
+ * @tparam T Value type.
+ */
+template <typename T> struct AsyncFunction : AsyncFunctionBase<T> {
+    void return_value(T value) {
+        this->resolvers.resolve(std::move(value));
+    }
+};
+
+template <> struct AsyncFunction<Undefined> : AsyncFunctionBase<Undefined> {
+    void return_void() {
+        this->resolvers.resolve();
+    }
+};
+
+/**
+ * Async generator producing Array batches, like JS `async function*`. It
+ * starts on the first call of next and runs until it yields a batch with
+ * co_yield, returns or throws; it may co_await promises meanwhile. The
+ * generator must outlive its pending next() call.
+ * @see https://developer.mozilla.org/en-US/docs/Web/JavaScript/Reference/Statements/async_function*
+ *
+ * @tparam T Elements type.
+ */
+template <typename T> class AsyncGenerator
+{
+public:
+    struct promise_type : PooledFrame {
+        promise_type() : pending(Promise<bool>::withResolvers()), waiting(false), done(false) {}
+
+        AsyncGenerator get_return_object() {
+            return AsyncGenerator(std::coroutine_handle<promise_type>::from_promise(*this));
+        }
+
+        std::suspend_always initial_suspend() noexcept {
+            return {};
+        }
+
+        std::suspend_always final_suspend() noexcept {
+            return {};
+        }
+
+        std::suspend_always yield_value(Array<T> value) {
+            batch = std::move(value);
+            waiting = false;
+            pending.resolve(true);
+            return {};
+        }
+
+        void return_void() {
+            done = true;
+            waiting = false;
+            pending.resolve(false);
+        }
+
+        void unhandled_exception() {
+            done = true;
+            waiting = false;
+            pending.reject(std::current_exception());
+        }
+
+        Array<T> batch;
+        Promise<bool>::WithResolvers pending;
+        bool waiting;
+        bool done;
+    };
+
+    AsyncGenerator(AsyncGenerator && other) : handle_(other.handle_) {
+        other.handle_ = nullptr;
+    }
+
+    AsyncGenerator & operator =(AsyncGenerator && other) {
+        std::swap(handle_, other.handle_);
+        return *this;
+    }
+
+    ~AsyncGenerator() {
+        if (handle_) {
+            handle_.destroy();
+        }
+    }
+
+    /**
+     * Resume generator until its next batch.
+     * @see https://developer.mozilla.org/en-US/docs/Web/JavaScript/Reference/Global_Objects/AsyncGenerator/next
+     *
+     * @returns Promise fulfilled with true once a batch is available through
+     *          batch(), with false once the generator is done, or rejected
+     *          with the exception the generator threw.
+     * @throws std::logic_error If the previous call is still pending.
+     */
+    Promise<bool> next() {
+        promise_type & promise = handle_.promise();
+
+        if (promise.waiting) {
+            throw std::logic_error("AsyncGenerator::next called before the previous batch arrived");
+        }
+        if (promise.done) {
+            return Promise<bool>::resolve(false);
+        }
+        promise.pending = Promise<bool>::withResolvers();
+        promise.waiting = true;
+
+        Promise<bool> result = promise.pending.promise;
+
+        handle_.resume();
+
+        return result;
+    }
+
+    /**
+     * Get the last yielded batch.
+     */
+    Array<T> & batch() {
+        return handle_.promise().batch;
+    }
+
+    /**
+     * Call function for every batch, like JS `for await`.
+     *
+     * @tparam F Callable as f(Array<T> &).
+     * @param f Function.
+     * @returns Promise fulfilled when the generator is done.
+     */
+    template <typename F>
+    Promise<> forEach(F f) {
+        // Awaiting inside the loop's condition is miscompiled by GCC 12.
+        for (;;) {
+            bool more = co_await next();
+
+            if (!more) {
+                break;
+            }
+            f(batch());
+        }
+    }
+
+    /**
+     * Concatenate all batches.
+     * @see https://developer.mozilla.org/en-US/docs/Web/JavaScript/Reference/Global_Objects/Array/fromAsync
+     *
+     * @returns Promise of all elements.
+     */
+    Promise<Array<T> > toArray() {
+        Array<T> result;
+
+        for (;;) {
+            bool more = co_await next();
+
+            if (!more) {
+                break;
+            }
+            for (T & element : batch()) {
+                result.push(std::move(element));
+            }
+        }
+
+        co_return result;
+    }
+
+private:
+    explicit AsyncGenerator(std::coroutine_handle<promise_type> handle) : handle_(handle) {}
+
+    std::coroutine_handle<promise_type> handle_;
+};
+
+} // namespace js4cpp
+
+template <typename T, typename... Args>
+struct std::coroutine_traits<js4cpp::Promise<T>, Args...> {
+    typedef js4cpp::AsyncFunction<T> promise_type;
+};
+
+#endif
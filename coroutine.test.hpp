@@ -0,0 +1,109 @@
+#pragma once
+
+#if defined(__cpp_impl_coroutine) && __cpp_impl_coroutine >= 201902L
+
+#include <stdexcept>
+#include <string>
+
+#include <cppunit/TestCaller.h>
+#include <cppunit/TestCase.h>
+#include <cppunit/TestSuite.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+#include "coroutine.hpp"
+
+class CoroutineTest : public CppUnit::TestCase
+{
+public:
+    CoroutineTest() : CppUnit::TestCase("Coroutine Test Case") {};
+
+    static js4cpp::Promise<int> delayed(int value, int delay) {
+        return js4cpp::Promise<int>([value, delay] (js4cpp::Promise<int>::Resolver resolve, js4cpp::Promise<int>::Rejecter) {
+            js4cpp::EventLoop::current().setTimeout([resolve, value] { resolve(value); }, delay);
+        });
+    }
+
+    static js4cpp::Promise<int> sum(std::string & log) {
+        log += "start,";
+        int a = co_await delayed(1, 2);
+        log += "a,";
+        int b = co_await js4cpp::Promise<int>::resolve(2);
+        co_return a + b;
+    }
+
+    static js4cpp::Promise<> fail() {
+        co_await delayed(0, 1);
+        throw std::runtime_error("failed");
+    }
+
+    static js4cpp::Promise<std::string> recover() {
+        try {
+            co_await fail();
+        } catch (const std::runtime_error & error) {
+            co_return error.what();
+        }
+        co_return "";
+    }
+
+    static js4cpp::AsyncGenerator<int> batches(int count) {
+        for (int i = 0; i < count; ++i) {
+            int first = co_await delayed(i * 10, 1);
+            co_yield js4cpp::Array<int>::of(first, first + 1);
+        }
+        if (count < 0) {
+            throw std::invalid_argument("count");
+        }
+    }
+
+    void testAsyncFunction() {
+        std::string log;
+        js4cpp::Promise<int> result = sum(log);
+
+        CPPUNIT_ASSERT( log == "start," && result.status() == js4cpp::Pending );
+        loop().run();
+        CPPUNIT_ASSERT( log == "start,a," && result.value() == 3 );
+
+        js4cpp::Promise<std::string> recovered = recover();
+        loop().run();
+        CPPUNIT_ASSERT( recovered.value() == "failed" );
+    }
+
+    void testAsyncGenerator() {
+        js4cpp::AsyncGenerator<int> generator = batches(3);
+        js4cpp::Promise<js4cpp::Array<int> > all = generator.toArray();
+
+        loop().run();
+        CPPUNIT_ASSERT( all.value().join() == "0,1,10,11,20,21" );
+
+        int total = 0;
+        js4cpp::AsyncGenerator<int> counted = batches(2);
+        js4cpp::Promise<> done = counted.forEach([&total] (js4cpp::Array<int> & batch) {
+            total += batch.length();
+        });
+        loop().run();
+        CPPUNIT_ASSERT( done.status() == js4cpp::Fulfilled && total == 4 );
+
+        js4cpp::AsyncGenerator<int> failing = batches(-1);
+        js4cpp::Promise<bool> next = failing.next();
+        loop().run();
+        CPPUNIT_ASSERT( next.status() == js4cpp::Rejected );
+    }
+
+    void setUp() {}
+
+    void tearDown() {}
+
+    CPPUNIT_TEST_SUITE( CoroutineTest );
+
+        CPPUNIT_TEST( testAsyncFunction );
+        CPPUNIT_TEST( testAsyncGenerator );
+
+    CPPUNIT_TEST_SUITE_END();
+
+private:
+    static js4cpp::EventLoop & loop() {
+        return js4cpp::EventLoop::current();
+    }
+};
+
+#endif
@@ -0,0 +1,251 @@
+/* Copyright (c) 2012 Kirill Dmitrenko <kdmitrenko@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is furnished
+ * to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * @file data_view.hpp
+ * JS-style DataView.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+#include <type_traits>
+
+#include "array_buffer.hpp"
+
+namespace js4cpp {
+
+/**
+ * Reverse byte order of an unsigned integer.
+ */
+inline uint8_t byteSwap(uint8_t value) {
+    return value;
+}
+
+inline uint16_t byteSwap(uint16_t value) {
+#if defined(__GNUC__)
+    return __builtin_bswap16(value);
+#else
+    return static_cast<uint16_t>((value >> 8) | (value << 8));
+#endif
+}
+
+inline uint32_t byteSwap(uint32_t value) {
+#if defined(__GNUC__)
+    return __builtin_bswap32(value);
+#else
+    return (value >> 24) | ((value >> 8) & 0xff00) | ((value << 8) & 0xff0000) | (value << 24);
+#endif
+}
+
+inline uint64_t byteSwap(uint64_t value) {
+#if defined(__GNUC__)
+    return __builtin_bswap64(value);
+#else
+    return (static_cast<uint64_t>(byteSwap(static_cast<uint32_t>(value))) << 32) | byteSwap(static_cast<uint32_t>(value >> 32));
+#endif
+}
+
+/**
+ * Check whether host stores numbers in little-endian byte order.
+ *
+ * @returns `true` on little-endian hosts.
+ */
+inline bool hostIsLittleEndian() {
+#if defined(__BYTE_ORDER__) && defined(__ORDER_LITTLE_ENDIAN__)
+    return __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__;
+#else
+    const uint16_t probe = 1;
+    return *reinterpret_cast<const unsigned char *>(&probe) == 1;
+#endif
+}
+
+/**
+ * Load number of given type from possibly unaligned memory.
+ *
+ * @tparam T Number type.
+ * @param bytes Memory.
+ * @param littleEndian Whether the number is stored in little-endian byte order.
+ * @returns Number.
+ */
+template <typename T>
+T loadNumber(const void * bytes, bool littleEndian) {
+    typedef typename std::conditional<sizeof(T) == 1, uint8_t,
+        typename std::conditional<sizeof(T) == 2, uint16_t,
+        typename std::conditional<sizeof(T) == 4, uint32_t, uint64_t>::type>::type>::type Bits;
+
+    Bits bits;
+    T value;
+
+    std::memcpy(&bits, bytes, sizeof(bits));
+    if (littleEndian != hostIsLittleEndian()) {
+        bits = byteSwap(bits);
+    }
+    std::memcpy(&value, &bits, sizeof(value));
+
+    return value;
+}
+
+/**
+ * Store number of given type to possibly unaligned memory.
+ *
+ * @tparam T Number type.
+ * @param bytes Memory.
+ * @param value Number.
+ * @param littleEndian Whether to store the number in little-endian byte order.
+ */
+template <typename T>
+void storeNumber(void * bytes, T value, bool littleEndian) {
+    typedef typename std::conditional<sizeof(T) == 1, uint8_t,
+        typename std::conditional<sizeof(T) == 2, uint16_t,
+        typename std::conditional<sizeof(T) == 4, uint32_t, uint64_t>::type>::type>::type Bits;
+
+    Bits bits;
+
+    std::memcpy(&bits, &value, sizeof(bits));
+    if (littleEndian != hostIsLittleEndian()) {
+        bits = byteSwap(bits);
+    }
+    std::memcpy(bytes, &bits, sizeof(bits));
+}
+
+/**
+ * JS-style view reading and writing numbers of different types at arbitrary
+ * (possibly unaligned) byte offsets of an ArrayBuffer, in either byte order.
+ * Like in JS, big-endian is the default.
+ * @see https://developer.mozilla.org/en-US/docs/Web/JavaScript/Reference/Global_Objects/DataView
+ */
+class DataView
+{
+public:
+    /**
+     * Create view over a part of given buffer.
+     *
+     * @param buffer Buffer.
+     * @param byteOffset Offset of the view in the buffer.
+     * @param byteLength Length of the view. Defaults to the rest of the buffer.
+     * @throws std::out_of_range If view does not fit the buffer.
+     */
+    explicit DataView(const ArrayBuffer & buffer, size_t byteOffset = 0, size_t byteLength = std::numeric_limits<size_t>::max()) :
+        buffer_(buffer), byteOffset_(byteOffset), byteLength_(byteLength)
+    {
+        if (byteOffset > buffer.byteLength()) {
+            throw std::out_of_range("DataView offset is outside of the buffer");
+        }
+        if (byteLength == std::numeric_limits<size_t>::max()) {
+            byteLength_ = buffer.byteLength() - byteOffset;
+        } else if (byteLength > buffer.byteLength() - byteOffset) {
+            throw std::out_of_range("DataView length is outside of the buffer");
+        }
+    }
+
+    /**
+     * Get the buffer the view refers to.
+     *
+     * @returns Buffer.
+     */
+    const ArrayBuffer & buffer() const {
+        return buffer_;
+    }
+
+    size_t byteOffset() const {
+        return byteOffset_;
+    }
+
+    size_t byteLength() const {
+        return byteLength_;
+    }
+
+    /**
+     * Read number of given type.
+     *
+     * @tparam T Number type.
+     * @param byteOffset Offset in the view.
+     * @param littleEndian Whether the number is stored in little-endian byte order.
+     * @returns Number.
+     * @throws std::out_of_range If number does not fit the view.
+     */
+    template <typename T>
+    T get(size_t byteOffset, bool littleEndian = false) const {
+        return loadNumber<T>(at(byteOffset, sizeof(T)), littleEndian);
+    }
+
+    /**
+     * Write number of given type.
+     *
+     * @tparam T Number type.
+     * @param byteOffset Offset in the view.
+     * @param value Number.
+     * @param littleEndian Whether to store the number in little-endian byte order.
+     * @throws std::out_of_range If number does not fit the view.
+     */
+    template <typename T>
+    void set(size_t byteOffset, T value, bool littleEndian = false) {
+        storeNumber<T>(at(byteOffset, sizeof(T)), value, littleEndian);
+    }
+
+    int8_t getInt8(size_t byteOffset) const { return get<int8_t>(byteOffset); }
+    uint8_t getUint8(size_t byteOffset) const { return get<uint8_t>(byteOffset); }
+    int16_t getInt16(size_t byteOffset, bool littleEndian = false) const { return get<int16_t>(byteOffset, littleEndian); }
+    uint16_t getUint16(size_t byteOffset, bool littleEndian = false) const { return get<uint16_t>(byteOffset, littleEndian); }
+    int32_t getInt32(size_t byteOffset, bool littleEndian = false) const { return get<int32_t>(byteOffset, littleEndian); }
+    uint32_t getUint32(size_t byteOffset, bool littleEndian = false) const { return get<uint32_t>(byteOffset, littleEndian); }
+    int64_t getBigInt64(size_t byteOffset, bool littleEndian = false) const { return get<int64_t>(byteOffset, littleEndian); }
+    uint64_t getBigUint64(size_t byteOffset, bool littleEndian = false) const { return get<uint64_t>(byteOffset, littleEndian); }
+    float getFloat32(size_t byteOffset, bool littleEndian = false) const { return get<float>(byteOffset, littleEndian); }
+    double getFloat64(size_t byteOffset, bool littleEndian = false) const { return get<double>(byteOffset, littleEndian); }
+
+    void setInt8(size_t byteOffset, int8_t value) { set(byteOffset, value); }
+    void setUint8(size_t byteOffset, uint8_t value) { set(byteOffset, value); }
+    void setInt16(size_t byteOffset, int16_t value, bool littleEndian = false) { set(byteOffset, value, littleEndian); }
+    void setUint16(size_t byteOffset, uint16_t value, bool littleEndian = false) { set(byteOffset, value, littleEndian); }
+    void setInt32(size_t byteOffset, int32_t value, bool littleEndian = false) { set(byteOffset, value, littleEndian); }
+    void setUint32(size_t byteOffset, uint32_t value, bool littleEndian = false) { set(byteOffset, value, littleEndian); }
+    void setBigInt64(size_t byteOffset, int64_t value, bool littleEndian = false) { set(byteOffset, value, littleEndian); }
+    void setBigUint64(size_t byteOffset, uint64_t value, bool littleEndian = false) { set(byteOffset, value, littleEndian); }
+    void setFloat32(size_t byteOffset, float value, bool littleEndian = false) { set(byteOffset, value, littleEndian); }
+    void setFloat64(size_t byteOffset, double value, bool littleEndian = false) { set(byteOffset, value, littleEndian); }
+
+private:
+    void check(size_t byteOffset, size_t size) const {
+        if (byteOffset > byteLength_ || size > byteLength_ - byteOffset) {
+            throw std::out_of_range("Offset is outside the bounds of the DataView");
+        }
+    }
+
+    const unsigned char * at(size_t byteOffset, size_t size) const {
+        check(byteOffset, size);
+        return buffer_.data() + byteOffset_ + byteOffset;
+    }
+
+    unsigned char * at(size_t byteOffset, size_t size) {
+        check(byteOffset, size);
+        return buffer_.data() + byteOffset_ + byteOffset;
+    }
+
+    ArrayBuffer buffer_;
+    size_t byteOffset_;
+    size_t byteLength_;
+};
+
+} // namespace js4cpp
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <cppunit/TestCaller.h>
+#include <cppunit/TestCase.h>
+#include <cppunit/TestSuite.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+#include "data_view.hpp"
+
+class DataViewTest : public CppUnit::TestCase
+{
+public:
+    DataViewTest() : CppUnit::TestCase("DataView Test Case") {};
+
+    void setUp() {
+        buffer = new js4cpp::ArrayBuffer(16);
+        view = new js4cpp::DataView(*buffer);
+    }
+
+    void testEndianness() {
+        view->setUint16(0, 0x0102);
+        CPPUNIT_ASSERT( buffer->data()[0] == 1 && buffer->data()[1] == 2 );
+        CPPUNIT_ASSERT( view->getUint16(0, true) == 0x0201 );
+
+        view->setUint32(4, 0x01020304, true);
+        CPPUNIT_ASSERT( buffer->data()[4] == 4 && view->getUint32(4) == 0x04030201 );
+    }
+
+    void testUnaligned() {
+        view->setFloat64(3, 1.5);
+        CPPUNIT_ASSERT( view->getFloat64(3) == 1.5 );
+
+        view->setInt32(1, -2, true);
+        CPPUNIT_ASSERT( view->getInt32(1, true) == -2 );
+
+        view->setBigUint64(7, 0x0102030405060708ULL, true);
+        CPPUNIT_ASSERT( view->getUint8(7) == 8 && view->getBigUint64(7, true) == 0x0102030405060708ULL );
+    }
+
+    void testBounds() {
+        js4cpp::DataView part(*buffer, 8, 4);
+
+        part.setInt8(3, -1);
+        CPPUNIT_ASSERT( buffer->data()[11] == 0xff && part.byteLength() == 4 );
+
+        bool thrown = false;
+        try {
+            part.getUint16(3);
+        } catch (const std::out_of_range &) {
+            thrown = true;
+        }
+        CPPUNIT_ASSERT( thrown );
+    }
+
+    void tearDown() {
+        delete view;
+        delete buffer;
+    }
+
+    CPPUNIT_TEST_SUITE( DataViewTest );
+
+        CPPUNIT_TEST( testEndianness );
+        CPPUNIT_TEST( testUnaligned );
+        CPPUNIT_TEST( testBounds );
+
+    CPPUNIT_TEST_SUITE_END();
+
+private:
+    js4cpp::ArrayBuffer * buffer;
+    js4cpp::DataView * view;
+};
@@ -0,0 +1,560 @@
+/* Copyright (c) 2012 Kirill Dmitrenko <kdmitrenko@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is furnished
+ * to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * @file event_loop.hpp
+ * Single-threaded event loop with microtasks and timers.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <thread>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+
+namespace js4cpp {
+
+/**
+ * Hierarchical timing wheel: four levels of 256 slots each, the first one
+ * ticking every millisecond. Inserting and removing a timer is O(1); timers
+ * in upper levels move down a level when their slot comes up.
+ */
+class TimerWheel
+{
+public:
+    /**
+     * Timer as stored in a slot; embedded into the owner's timer records.
+     */
+    struct Timer {
+        uint64_t due;
+        Timer * prev;
+        Timer * next;
+    };
+
+    TimerWheel() : now_(0), size_(0) {
+        for (unsigned level = 0; level < LEVELS; ++level) {
+            for (unsigned slot = 0; slot < SLOTS; ++slot) {
+                slots_[level][slot].prev = slots_[level][slot].next = &slots_[level][slot];
+            }
+        }
+    }
+
+    /**
+     * Get current tick.
+     */
+    uint64_t now() const {
+        return now_;
+    }
+
+    /**
+     * Get number of timers.
+     */
+    size_t size() const {
+        return size_;
+    }
+
+    /**
+     * Add timer. Timers due now or in the past expire on the next tick.
+     */
+    void insert(Timer * timer) {
+        place(timer, now_ + 1);
+        ++size_;
+    }
+
+    /**
+     * Remove timer which has not expired yet.
+     */
+    void remove(Timer * timer) {
+        unlink(timer);
+        --size_;
+    }
+
+    /**
+     * Get the earliest tick advancing to which may expire a timer: the
+     * first non-empty slot of level 0 in its current window or, failing
+     * that, the start of the first non-empty slot of the levels above,
+     * where its timers are cascaded down.
+     */
+    uint64_t next() const {
+        for (unsigned level = 0; level < LEVELS; ++level) {
+            unsigned shift = SLOT_BITS * level;
+            uint64_t index = now_ >> shift;
+            // The top level wraps around: its next slot holds timers beyond the wheel.
+            uint64_t last = level + 1 < LEVELS ? index | (SLOTS - 1) : index + SLOTS - 1;
+
+            for (uint64_t i = index + 1; i <= last; ++i) {
+                const Timer & slot = slots_[level][i & (SLOTS - 1)];
+
+                if (slot.next != &slot) {
+                    return i << shift;
+                }
+            }
+        }
+
+        return now_ + 1;
+    }
+
+    /**
+     * Advance to given tick, expiring timers one by one in due order.
+     * Ticks before the one next() reports have nothing to expire or
+     * cascade, so they are skipped at once.
+     *
+     * @tparam F Callable as f(Timer *); the timer is already removed.
+     * @param tick Tick.
+     * @param expire Function called for every expired timer.
+     */
+    template <typename F>
+    void advance(uint64_t tick, F expire) {
+        while (now_ < tick) {
+            if (size_ == 0) {
+                now_ = tick;
+                return;
+            }
+            now_ = std::min(next(), tick);
+            if ((now_ & 0xff) == 0) {
+                if ((now_ & 0xffff) == 0) {
+                    if ((now_ & 0xffffff) == 0) {
+                        cascade(3);
+                    }
+                    cascade(2);
+                }
+                cascade(1);
+            }
+
+            Timer & slot = slots_[0][now_ & (SLOTS - 1)];
+
+            // Timers are taken one at a time, so that expiring one may
+            // remove others from the same slot.
+            while (slot.next != &slot) {
+                Timer * timer = slot.next;
+
+                remove(timer);
+                expire(timer);
+            }
+        }
+    }
+
+private:
+    static const unsigned LEVELS = 4;
+    static const unsigned SLOT_BITS = 8;
+    static const unsigned SLOTS = 1 << SLOT_BITS;
+
+    /**
+     * Put timer into the lowest level whose window covers its due tick.
+     * Timers beyond the top level's window wait in its next slot and are
+     * placed again when it comes up.
+     *
+     * @param earliest First tick whose slot is not visited yet.
+     */
+    void place(Timer * timer, uint64_t earliest) {
+        uint64_t due = std::max(timer->due, earliest);
+        Timer * slot = &slots_[LEVELS - 1][((now_ >> (SLOT_BITS * (LEVELS - 1))) + 1) & (SLOTS - 1)];
+
+        for (unsigned level = 0; level < LEVELS; ++level) {
+            unsigned shift = SLOT_BITS * (level + 1);
+
+            if ((due >> shift) == (now_ >> shift)) {
+                slot = &slots_[level][(due >> (shift - SLOT_BITS)) & (SLOTS - 1)];
+                break;
+            }
+        }
+
+        timer->prev = slot->prev;
+        timer->next = slot;
+        slot->prev->next = timer;
+        slot->prev = timer;
+    }
+
+    static void unlink(Timer * timer) {
+        timer->prev->next = timer->next;
+        timer->next->prev = timer->prev;
+    }
+
+    void cascade(unsigned level) {
+        Timer & slot = slots_[level][(now_ >> (SLOT_BITS * level)) & (SLOTS - 1)];
+
+        while (slot.next != &slot) {
+            Timer * timer = slot.next;
+
+            unlink(timer);
+            place(timer, now_);
+        }
+    }
+
+    uint64_t now_;
+    size_t size_;
+    Timer slots_[LEVELS][SLOTS];
+};
+
+/**
+ * Single-threaded event loop: a queue of microtasks, drained completely
+ * after every task, and timers. Callbacks are stored in pooled jobs, so a
+ * running loop allocates only for callables too big to fit into one.
+ * @see https://developer.mozilla.org/en-US/docs/Web/API/HTML_DOM_API/Microtask_guide
+ */
+class EventLoop
+{
+public:
+    typedef size_t TimerId;
+
+    /**
+     * Type-erased callable, called as f(argument).
+     */
+    class Job
+    {
+    public:
+        void call(void * argument) {
+            call_(this, argument);
+        }
+
+    private:
+        friend class EventLoop;
+
+        static const size_t STORAGE = 48;
+
+        void (*call_)(Job *, void *);
+        void (*destroy_)(Job *);
+        Job * next_;
+        std::aligned_storage<STORAGE, std::alignment_of<std::max_align_t>::value>::type storage_;
+    };
+
+    /**
+     * FIFO list of jobs.
+     */
+    class JobList
+    {
+    public:
+        JobList() : head_(0), tail_(0) {}
+
+        bool empty() const {
+            return head_ == 0;
+        }
+
+        void push(Job * job) {
+            job->next_ = 0;
+            (tail_ ? tail_->next_ : head_) = job;
+            tail_ = job;
+        }
+
+        Job * shift() {
+            Job * job = head_;
+
+            head_ = job->next_;
+            if (!head_) {
+                tail_ = 0;
+            }
+
+            return job;
+        }
+
+    private:
+        Job * head_;
+        Job * tail_;
+    };
+
+    EventLoop() : start_(std::chrono::steady_clock::now()), nextTimerId_(1), free_(0) {}
+
+    /**
+     * Destroy pending microtasks and timers without running them.
+     */
+    ~EventLoop() {
+        while (!microtasks_.empty()) {
+            release(microtasks_.shift());
+        }
+        for (auto it = timers_.begin(); it != timers_.end(); ++it) {
+            release(it->second->callback);
+            delete it->second;
+        }
+        while (free_) {
+            Job * next = free_->next_;
+            ::operator delete(free_);
+            free_ = next;
+        }
+    }
+
+    EventLoop(const EventLoop &) = delete;
+    EventLoop & operator =(const EventLoop &) = delete;
+
+    /**
+     * Get the calling thread's loop.
+     */
+    static EventLoop & current() {
+        static thread_local EventLoop loop;
+
+        return loop;
+    }
+
+    /**
+     * Get milliseconds elapsed since the loop was created.
+     */
+    uint64_t now() const {
+        return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start_).count();
+    }
+
+    /**
+     * Queue a microtask.
+     * @see https://developer.mozilla.org/en-US/docs/Web/API/queueMicrotask
+     *
+     * @tparam F Callable as f().
+     * @param f Function.
+     */
+    template <typename F>
+    void queueMicrotask(F f) {
+        microtasks_.push(job(IgnoreArgument<F>(std::move(f))));
+    }
+
+    /**
+     * Call function once after given delay.
+     * @see https://developer.mozilla.org/en-US/docs/Web/API/setTimeout
+     *
+     * @tparam F Callable as f().
+     * @param f Function.
+     * @param delay Delay in milliseconds.
+     * @returns Timer's identifier.
+     */
+    template <typename F>
+    TimerId setTimeout(F f, uint64_t delay = 0) {
+        return addTimer(job(IgnoreArgument<F>(std::move(f))), delay, 0);
+    }
+
+    /**
+     * Call function repeatedly with given interval.
+     * @see https://developer.mozilla.org/en-US/docs/Web/API/setInterval
+     *
+     * @tparam F Callable as f().
+     * @param f Function.
+     * @param interval Interval in milliseconds.
+     * @returns Timer's identifier.
+     */
+    template <typename F>
+    TimerId setInterval(F f, uint64_t interval) {
+        return addTimer(job(IgnoreArgument<F>(std::move(f))), interval, interval ? interval : 1);
+    }
+
+    /**
+     * Cancel timer set with setTimeout. Unknown identifiers are ignored.
+     * @see https://developer.mozilla.org/en-US/docs/Web/API/clearTimeout
+     *
+     * @param id Timer's identifier.
+     */
+    void clearTimeout(TimerId id) {
+        auto it = timers_.find(id);
+
+        if (it == timers_.end()) {
+            return;
+        }
+
+        Timer * timer = it->second;
+
+        if (timer->running) {
+            // Freed once its callback returns.
+            timer->interval = 0;
+            return;
+        }
+        wheel_.remove(timer);
+        timers_.erase(it);
+        release(timer->callback);
+        delete timer;
+    }
+
+    /**
+     * Cancel timer set with setInterval.
+     * @see https://developer.mozilla.org/en-US/docs/Web/API/clearInterval
+     *
+     * @param id Timer's identifier.
+     */
+    void clearInterval(TimerId id) {
+        clearTimeout(id);
+    }
+
+    /**
+     * Run all microtasks queued.
+     */
+    void runMicrotasks() {
+        while (!microtasks_.empty()) {
+            Releaser releaser(*this, microtasks_.shift());
+            releaser.job->call(0);
+        }
+    }
+
+    /**
+     * Run microtasks and timers until there are none left. Exceptions
+     * escaping callbacks propagate from here; the loop may be run again.
+     */
+    void run() {
+        for (;;) {
+            runMicrotasks();
+            if (timers_.empty()) {
+                return;
+            }
+
+            uint64_t time = now();
+
+            if (time <= wheel_.now()) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(wheel_.next() - time));
+                time = now();
+            }
+            wheel_.advance(time, [this] (TimerWheel::Timer * timer) {
+                fire(static_cast<Timer *>(timer));
+            });
+        }
+    }
+
+    /**
+     * Wrap callable into a pooled job.
+     *
+     * @tparam F Callable as f(void *).
+     * @param f Function.
+     * @returns Job, to be given back with release.
+     */
+    template <typename F>
+    Job * job(F f) {
+        typedef std::integral_constant<bool,
+            sizeof(F) <= Job::STORAGE && std::alignment_of<F>::value <= std::alignment_of<std::max_align_t>::value> Inline;
+        Job * job = free_;
+
+        if (job) {
+            free_ = job->next_;
+        } else {
+            job = static_cast<Job *>(::operator new(sizeof(Job)));
+        }
+        store(job, std::move(f), Inline());
+
+        return job;
+    }
+
+    /**
+     * Destroy job's callable and give the job back to the pool.
+     */
+    void release(Job * job) {
+        job->destroy_(job);
+        job->next_ = free_;
+        free_ = job;
+    }
+
+private:
+    struct Timer : TimerWheel::Timer {
+        TimerId id;
+        uint64_t interval;
+        bool running;
+        Job * callback;
+    };
+
+    template <typename F> struct IgnoreArgument {
+        explicit IgnoreArgument(F && f) : f(std::move(f)) {}
+
+        void operator ()(void *) {
+            f();
+        }
+
+        F f;
+    };
+
+    /**
+     * Releases a job even if it throws.
+     */
+    struct Releaser {
+        Releaser(EventLoop & loop, Job * job) : loop(loop), job(job) {}
+
+        ~Releaser() {
+            loop.release(job);
+        }
+
+        EventLoop & loop;
+        Job * job;
+    };
+
+    template <typename F>
+    static void store(Job * job, F && f, std::true_type) {
+        ::new (static_cast<void *>(&job->storage_)) F(std::move(f));
+        job->call_ = [] (Job * self, void * argument) {
+            (*reinterpret_cast<F *>(&self->storage_))(argument);
+        };
+        job->destroy_ = [] (Job * self) {
+            reinterpret_cast<F *>(&self->storage_)->~F();
+        };
+    }
+
+    template <typename F>
+    static void store(Job * job, F && f, std::false_type) {
+        *reinterpret_cast<F **>(&job->storage_) = new F(std::move(f));
+        job->call_ = [] (Job * self, void * argument) {
+            (**reinterpret_cast<F **>(&self->storage_))(argument);
+        };
+        job->destroy_ = [] (Job * self) {
+            delete *reinterpret_cast<F **>(&self->storage_);
+        };
+    }
+
+    TimerId addTimer(Job * callback, uint64_t delay, uint64_t interval) {
+        Timer * timer = new Timer();
+
+        timer->due = now() + delay;
+        timer->id = nextTimerId_++;
+        timer->interval = interval;
+        timer->running = false;
+        timer->callback = callback;
+        timers_[timer->id] = timer;
+        wheel_.insert(timer);
+
+        return timer->id;
+    }
+
+    void fire(Timer * timer) {
+        struct Done {
+            Done(EventLoop & loop, Timer * timer) : loop(loop), timer(timer) {}
+
+            // Re-arm interval or free the timer, even if the callback throws.
+            ~Done() {
+                timer->running = false;
+                if (timer->interval) {
+                    timer->due = loop.wheel_.now() + timer->interval;
+                    loop.wheel_.insert(timer);
+                } else {
+                    loop.timers_.erase(timer->id);
+                    loop.release(timer->callback);
+                    delete timer;
+                }
+            }
+
+            EventLoop & loop;
+            Timer * timer;
+        } done(*this, timer);
+
+        timer->running = true;
+        timer->callback->call(0);
+        runMicrotasks();
+    }
+
+    std::chrono::steady_clock::time_point start_;
+    TimerWheel wheel_;
+    std::unordered_map<TimerId, Timer *> timers_;
+    TimerId nextTimerId_;
+    JobList microtasks_;
+    Job * free_;
+};
+
+} // namespace js4cpp
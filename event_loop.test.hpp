@@ -0,0 +1,112 @@
+#pragma once
+
+#include <string>
+
+#include <cppunit/TestCaller.h>
+#include <cppunit/TestCase.h>
+#include <cppunit/TestSuite.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+#include "event_loop.hpp"
+
+class EventLoopTest : public CppUnit::TestCase
+{
+public:
+    EventLoopTest() : CppUnit::TestCase("EventLoop Test Case") {};
+
+    void testMicrotasks() {
+        js4cpp::EventLoop loop;
+        std::string log;
+
+        loop.queueMicrotask([&] {
+            log += "a";
+            loop.queueMicrotask([&] { log += "c"; });
+        });
+        loop.queueMicrotask([&] { log += "b"; });
+        CPPUNIT_ASSERT( log.empty() );
+
+        loop.run();
+        CPPUNIT_ASSERT( log == "abc" );
+
+        std::string big(100, 'x');
+        loop.queueMicrotask([&log, big] { log += big; });
+        loop.run();
+        CPPUNIT_ASSERT( log.length() == 103 );
+    }
+
+    void testTimers() {
+        js4cpp::EventLoop loop;
+        std::string log;
+        int ticks = 0;
+
+        loop.setTimeout([&] { log += "0"; });
+        loop.setTimeout([&] { log += "3"; }, 3);
+        loop.setTimeout([&] {
+            log += "1";
+            loop.queueMicrotask([&] { log += "m"; });
+        }, 1);
+        js4cpp::EventLoop::TimerId cancelled = loop.setTimeout([&] { log += "x"; }, 2);
+        js4cpp::EventLoop::TimerId interval = loop.setInterval([&] {
+            if (++ticks == 3) {
+                loop.clearInterval(interval);
+            }
+        }, 2);
+        loop.clearTimeout(cancelled);
+        loop.clearTimeout(12345);
+
+        loop.run();
+        CPPUNIT_ASSERT( log == "01m3" );
+        CPPUNIT_ASSERT( ticks == 3 );
+    }
+
+    void testTimerWheel() {
+        js4cpp::TimerWheel wheel;
+        js4cpp::TimerWheel::Timer timers[5];
+        uint64_t dues[5] = {5, 256, 70000, 1ull << 24, (1ull << 32) + 3};
+        uint64_t expired[5] = {0, 0, 0, 0, 0};
+
+        for (int i = 0; i < 5; ++i) {
+            timers[i].due = dues[i];
+            wheel.insert(&timers[i]);
+        }
+        CPPUNIT_ASSERT( wheel.size() == 5 && wheel.next() == 5 );
+
+        wheel.remove(&timers[1]);
+        wheel.advance(5, [&] (js4cpp::TimerWheel::Timer * timer) {
+            expired[timer - timers] = wheel.now();
+        });
+        CPPUNIT_ASSERT( expired[0] == 5 && wheel.next() == 65536 );
+
+        // Empty windows are skipped, so far timers take a few hundred steps.
+        size_t steps = 0;
+        while (wheel.size() != 0) {
+            wheel.advance(wheel.next(), [&] (js4cpp::TimerWheel::Timer * timer) {
+                expired[timer - timers] = wheel.now();
+            });
+            ++steps;
+        }
+        CPPUNIT_ASSERT( expired[1] == 0 && expired[2] == 70000 && steps < 300 );
+        CPPUNIT_ASSERT( expired[3] == 1ull << 24 && expired[4] == (1ull << 32) + 3 );
+
+        js4cpp::TimerWheel::Timer late = {(1ull << 33) + 7, 0, 0};
+        wheel.insert(&late);
+        wheel.advance((1ull << 33) + 6, [&] (js4cpp::TimerWheel::Timer *) {});
+        CPPUNIT_ASSERT( wheel.size() == 1 && wheel.now() == (1ull << 33) + 6 && wheel.next() == (1ull << 33) + 7 );
+        wheel.advance(1ull << 40, [&] (js4cpp::TimerWheel::Timer * timer) {
+            CPPUNIT_ASSERT( timer == &late && wheel.now() == (1ull << 33) + 7 );
+        });
+        CPPUNIT_ASSERT( wheel.size() == 0 && wheel.now() == 1ull << 40 );
+    }
+
+    void setUp() {}
+
+    void tearDown() {}
+
+    CPPUNIT_TEST_SUITE( EventLoopTest );
+
+        CPPUNIT_TEST( testMicrotasks );
+        CPPUNIT_TEST( testTimers );
+        CPPUNIT_TEST( testTimerWheel );
+
+    CPPUNIT_TEST_SUITE_END();
+};
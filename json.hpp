@@ -0,0 +1,727 @@
+/* Copyright (c) 2012 Kirill Dmitrenko <kdmitrenko@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is furnished
+ * to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * @file json.hpp
+ * JS-style JSON.
+ */
+
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+
+#include "array.hpp"
+
+namespace js4cpp {
+
+/**
+ * Error thrown when JSON text is malformed or does not match the type it
+ * is parsed into.
+ */
+class SyntaxError : public std::runtime_error
+{
+public:
+    SyntaxError(const std::string & message, size_t position) :
+        std::runtime_error(message + " at position " + std::to_string(position)), position_(position) {}
+
+    /**
+     * Get offset in the text where error was found.
+     *
+     * @returns Offset.
+     */
+    size_t position() const {
+        return position_;
+    }
+
+private:
+    size_t position_;
+};
+
+/**
+ * Cursor over JSON text with scanners for its tokens.
+ */
+class JSONParser
+{
+public:
+    JSONParser(const char * begin, const char * end) : begin_(begin), p_(begin), end_(end) {}
+
+    /**
+     * Skip whitespace and get next character without consuming it.
+     *
+     * @returns Next character or '\0' at the end of text.
+     */
+    char peek() {
+        while (p_ != end_ && (*p_ == ' ' || *p_ == '\n' || *p_ == '\r' || *p_ == '\t')) {
+            ++p_;
+        }
+
+        return p_ != end_ ? *p_ : '\0';
+    }
+
+    /**
+     * Consume given character (after whitespace).
+     *
+     * @throws SyntaxError If next character is different.
+     */
+    void expect(char c) {
+        if (peek() != c) {
+            fail(std::string("Expected '") + c + "'");
+        }
+        ++p_;
+    }
+
+    /**
+     * Consume given character (after whitespace) if it is next.
+     *
+     * @returns `true` if character was consumed.
+     */
+    bool consume(char c) {
+        if (peek() == c) {
+            ++p_;
+            return true;
+        }
+
+        return false;
+    }
+
+    /**
+     * Consume given literal (after whitespace) if it is next.
+     *
+     * @returns `true` if literal was consumed.
+     */
+    bool consumeLiteral(const char * literal) {
+        size_t length = std::strlen(literal);
+
+        if (peek() == literal[0] && size_t(end_ - p_) >= length && std::memcmp(p_, literal, length) == 0) {
+            p_ += length;
+            return true;
+        }
+
+        return false;
+    }
+
+    /**
+     * Make sure nothing but whitespace is left.
+     *
+     * @throws SyntaxError If there is anything else.
+     */
+    void finish() {
+        if (peek() != '\0' || p_ != end_) {
+            fail("Unexpected token");
+        }
+    }
+
+    /**
+     * Parse string literal appending its value to given string.
+     *
+     * @param out Output.
+     * @throws SyntaxError If literal is malformed.
+     */
+    void parseString(std::string & out) {
+        expect('"');
+
+        for (;;) {
+            const char * special = findSpecial(p_, end_);
+
+            out.append(p_, special);
+            p_ = special;
+
+            if (p_ == end_) {
+                fail("Unterminated string");
+            }
+            if (*p_ == '"') {
+                ++p_;
+                return;
+            }
+            if (*p_ != '\\') {
+                fail("Control character in string");
+            }
+            parseEscape(out);
+        }
+    }
+
+    /**
+     * Parse number literal.
+     *
+     * @tparam T Arithmetic type to parse number into.
+     * @returns Number.
+     * @throws SyntaxError If literal is malformed or does not fit T.
+     */
+    template <typename T>
+    T parseNumber() {
+        peek();
+
+        const char * start = p_;
+        bool negative = p_ != end_ && *p_ == '-';
+        uint64_t mantissa = 0;
+        int digits = 0, exponent = 0;
+        bool exact = true;
+
+        if (negative) {
+            ++p_;
+        }
+        if (p_ == end_ || !isDigit(*p_)) {
+            fail("Expected number");
+        }
+        if (*p_ == '0') {
+            ++p_;
+        } else {
+            exact = scanDigits(mantissa, digits, 0);
+        }
+
+        bool integral = true;
+
+        if (p_ != end_ && *p_ == '.') {
+            ++p_;
+            integral = false;
+            if (p_ == end_ || !isDigit(*p_)) {
+                fail("Expected digit");
+            }
+            scanDigits(mantissa, digits, &exponent);
+        }
+        if (p_ != end_ && (*p_ == 'e' || *p_ == 'E')) {
+            ++p_;
+            integral = false;
+
+            bool negativeExponent = false;
+            int explicitExponent = 0;
+
+            if (p_ != end_ && (*p_ == '+' || *p_ == '-')) {
+                negativeExponent = *p_++ == '-';
+            }
+            if (p_ == end_ || !isDigit(*p_)) {
+                fail("Expected digit");
+            }
+            while (p_ != end_ && isDigit(*p_)) {
+                explicitExponent = std::min(explicitExponent * 10 + (*p_++ - '0'), 100000);
+            }
+            exponent += negativeExponent ? -explicitExponent : explicitExponent;
+        }
+
+        // Integers which did not fit the mantissa take the floating point path
+        // and fail its range check.
+        return toNumber<T>(start, negative, mantissa, digits, exponent, integral && exact, std::is_integral<T>());
+    }
+
+    /**
+     * Skip any JSON value.
+     *
+     * @throws SyntaxError If value is malformed.
+     */
+    void skipValue() {
+        std::string scratch;
+
+        switch (peek()) {
+        case '"':
+            parseString(scratch);
+            break;
+        case '[':
+            ++p_;
+            if (!consume(']')) {
+                do {
+                    skipValue();
+                } while (consume(','));
+                expect(']');
+            }
+            break;
+        case '{':
+            ++p_;
+            if (!consume('}')) {
+                do {
+                    parseString(scratch);
+                    expect(':');
+                    skipValue();
+                } while (consume(','));
+                expect('}');
+            }
+            break;
+        default:
+            if (!consumeLiteral("true") && !consumeLiteral("false") && !consumeLiteral("null")) {
+                parseNumber<double>();
+            }
+        }
+    }
+
+    /**
+     * Throw SyntaxError pointing at current position.
+     */
+    void fail(const std::string & message) const {
+        throw SyntaxError(message, p_ - begin_);
+    }
+
+    /**
+     * Get current position in the text.
+     *
+     * @returns Position.
+     */
+    const char * position() const {
+        return p_;
+    }
+
+private:
+    static bool isDigit(char c) {
+        return c >= '0' && c <= '9';
+    }
+
+    /**
+     * Find first '"', '\\' or control character. Scans eight bytes at a time
+     * with SWAR bit tricks where the text allows it.
+     */
+    static const char * findSpecial(const char * p, const char * end) {
+        const uint64_t ones = 0x0101010101010101ULL, highs = 0x8080808080808080ULL;
+
+        while (end - p >= 8) {
+            uint64_t word;
+            std::memcpy(&word, p, 8);
+
+            uint64_t quote = word ^ (ones * '"'), backslash = word ^ (ones * '\\');
+            uint64_t found = ((quote - ones) & ~quote) | ((backslash - ones) & ~backslash) | (word - ones * 0x20);
+
+            // Bytes >= 0x80 (UTF-8) set high bits of `word - 0x20` too; mask them out.
+            if ((found & ~word & highs) != 0) {
+                break;
+            }
+            p += 8;
+        }
+        while (p != end && *p != '"' && *p != '\\' && static_cast<unsigned char>(*p) >= 0x20) {
+            ++p;
+        }
+
+        return p;
+    }
+
+    void parseEscape(std::string & out) {
+        if (++p_ == end_) {
+            fail("Unterminated string");
+        }
+
+        switch (*p_++) {
+        case '"': out += '"'; break;
+        case '\\': out += '\\'; break;
+        case '/': out += '/'; break;
+        case 'b': out += '\b'; break;
+        case 'f': out += '\f'; break;
+        case 'n': out += '\n'; break;
+        case 'r': out += '\r'; break;
+        case 't': out += '\t'; break;
+        case 'u': {
+            uint32_t code = parseHex();
+
+            if (code >= 0xd800 && code < 0xdc00 && end_ - p_ >= 6 && p_[0] == '\\' && p_[1] == 'u') {
+                const char * save = p_;
+
+                p_ += 2;
+                uint32_t low = parseHex();
+                if (low >= 0xdc00 && low < 0xe000) {
+                    code = 0x10000 + ((code - 0xd800) << 10) + (low - 0xdc00);
+                } else {
+                    p_ = save;
+                }
+            }
+            appendUtf8(out, code);
+            break;
+        }
+        default:
+            --p_;
+            fail("Invalid escape");
+        }
+    }
+
+    uint32_t parseHex() {
+        uint32_t code = 0;
+
+        for (int i = 0; i < 4; ++i, ++p_) {
+            char c = p_ != end_ ? *p_ : '\0';
+
+            code <<= 4;
+            if (c >= '0' && c <= '9') {
+                code |= c - '0';
+            } else if (c >= 'a' && c <= 'f') {
+                code |= c - 'a' + 10;
+            } else if (c >= 'A' && c <= 'F') {
+                code |= c - 'A' + 10;
+            } else {
+                fail("Invalid unicode escape");
+            }
+        }
+
+        return code;
+    }
+
+    static void appendUtf8(std::string & out, uint32_t code) {
+        if (code < 0x80) {
+            out += char(code);
+        } else if (code < 0x800) {
+            out += char(0xc0 | (code >> 6));
+            out += char(0x80 | (code & 0x3f));
+        } else if (code < 0x10000) {
+            out += char(0xe0 | (code >> 12));
+            out += char(0x80 | ((code >> 6) & 0x3f));
+            out += char(0x80 | (code & 0x3f));
+        } else {
+            out += char(0xf0 | (code >> 18));
+            out += char(0x80 | ((code >> 12) & 0x3f));
+            out += char(0x80 | ((code >> 6) & 0x3f));
+            out += char(0x80 | (code & 0x3f));
+        }
+    }
+
+    /**
+     * Accumulate significant digits into mantissa for as long as it does not
+     * overflow (19 digits always fit, the 20th one may); further digits only
+     * shift the exponent.
+     *
+     * @returns Whether all digits were accumulated.
+     */
+    bool scanDigits(uint64_t & mantissa, int & digits, int * fractionExponent) {
+        bool exact = true;
+
+        while (p_ != end_ && isDigit(*p_)) {
+            unsigned digit = *p_ - '0';
+
+            if (exact && (digits < 19 || mantissa <= (std::numeric_limits<uint64_t>::max() - digit) / 10)) {
+                mantissa = mantissa * 10 + digit;
+                if (mantissa != 0) {
+                    ++digits;
+                }
+                if (fractionExponent) {
+                    --*fractionExponent;
+                }
+            } else {
+                exact = false;
+                if (!fractionExponent) {
+                    ++digits;
+                }
+            }
+            ++p_;
+        }
+
+        return exact;
+    }
+
+    template <typename T>
+    T toNumber(const char * start, bool negative, uint64_t mantissa, int digits, int exponent, bool integral, std::true_type) {
+        if (!integral) {
+            double value = toNumber<double>(start, negative, mantissa, digits, exponent, integral, std::false_type());
+
+            // Bounds are powers of two, so they are exact doubles; the upper
+            // one is exclusive since double(max) rounds up to it.
+            if (value != std::trunc(value) || value < double(std::numeric_limits<T>::min()) ||
+                value >= std::ldexp(1.0, std::numeric_limits<T>::digits)) {
+                fail("Number does not fit integer type");
+            }
+
+            return static_cast<T>(value);
+        }
+
+        typedef typename std::make_unsigned<T>::type Unsigned;
+        uint64_t limit = negative ? uint64_t(Unsigned(std::numeric_limits<T>::max())) + (std::is_signed<T>::value ? 1 : 0)
+                                  : uint64_t(std::numeric_limits<T>::max());
+
+        if (mantissa > limit || (negative && !std::is_signed<T>::value && mantissa != 0)) {
+            fail("Number does not fit integer type");
+        }
+
+        return negative ? static_cast<T>(0 - mantissa) : static_cast<T>(mantissa);
+    }
+
+    template <typename T>
+    T toNumber(const char * start, bool negative, uint64_t mantissa, int digits, int exponent, bool, std::false_type) {
+        static const double powers[] = {
+            1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+            1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+        };
+
+        // Clinger's fast path: both mantissa and power of ten are exact doubles.
+        if (digits <= 15 && exponent >= -22 && exponent <= 22) {
+            double value = double(mantissa);
+
+            value = exponent < 0 ? value / powers[-exponent] : value * powers[exponent];
+            return static_cast<T>(negative ? -value : value);
+        }
+
+        std::string token(start, p_);
+        return static_cast<T>(std::strtod(token.c_str(), 0));
+    }
+
+    const char * begin_;
+    const char * p_;
+    const char * end_;
+};
+
+/**
+ * Appends JSON representation of values to a string.
+ */
+class JSONWriter
+{
+public:
+    explicit JSONWriter(std::string & out) : out_(out) {}
+
+    void writeBool(bool value) {
+        out_ += value ? "true" : "false";
+    }
+
+    /**
+     * Write integer digits directly, without going through printf.
+     */
+    template <typename T>
+    void writeInteger(T value) {
+        appendInteger(out_, value);
+    }
+
+    /**
+     * Write number in its shortest form which reads back to the same value.
+     * NaN and infinities become null, like in JS.
+     */
+    void writeDouble(double value) {
+        if (!std::isfinite(value)) {
+            out_ += "null";
+            return;
+        }
+
+        appendNumber(out_, value);
+    }
+
+    void writeString(const std::string & value) {
+        static const char hex[] = "0123456789abcdef";
+        const char * p = value.data(), * end = p + value.size(), * run = p;
+
+        out_ += '"';
+        for (; p != end; ++p) {
+            unsigned char c = *p;
+
+            if (c >= 0x20 && c != '"' && c != '\\') {
+                continue;
+            }
+
+            out_.append(run, p);
+            run = p + 1;
+            switch (c) {
+            case '"': out_ += "\\\""; break;
+            case '\\': out_ += "\\\\"; break;
+            case '\b': out_ += "\\b"; break;
+            case '\f': out_ += "\\f"; break;
+            case '\n': out_ += "\\n"; break;
+            case '\r': out_ += "\\r"; break;
+            case '\t': out_ += "\\t"; break;
+            default:
+                out_ += "\\u00";
+                out_ += hex[c >> 4];
+                out_ += hex[c & 0xf];
+            }
+        }
+        out_.append(run, end);
+        out_ += '"';
+    }
+
+    void write(char c) {
+        out_ += c;
+    }
+
+    void write(const char * text) {
+        out_ += text;
+    }
+
+private:
+    std::string & out_;
+};
+
+/**
+ * How values of type T are parsed from and written to JSON. Specializations
+ * cover numbers, bool, std::string and Arrays of those; value.hpp adds Value.
+ */
+template <typename T, typename Enable = void> struct JSONCodec;
+
+template <> struct JSONCodec<bool> {
+    static bool parse(JSONParser & parser) {
+        if (parser.consumeLiteral("true")) {
+            return true;
+        }
+        if (parser.consumeLiteral("false")) {
+            return false;
+        }
+        parser.fail("Expected boolean");
+        return false;
+    }
+
+    static void write(JSONWriter & writer, bool value) {
+        writer.writeBool(value);
+    }
+
+    static size_t estimate(bool) {
+        return 5;
+    }
+};
+
+template <typename T> struct JSONCodec<T, typename std::enable_if<std::is_integral<T>::value && !std::is_same<T, bool>::value>::type> {
+    static T parse(JSONParser & parser) {
+        return parser.parseNumber<T>();
+    }
+
+    static void write(JSONWriter & writer, T value) {
+        writer.writeInteger(value);
+    }
+
+    static size_t estimate(T) {
+        return std::numeric_limits<T>::digits10 + 3;
+    }
+};
+
+template <typename T> struct JSONCodec<T, typename std::enable_if<std::is_floating_point<T>::value>::type> {
+    static T parse(JSONParser & parser) {
+        if (parser.consumeLiteral("null")) {
+            return std::numeric_limits<T>::quiet_NaN();
+        }
+
+        return parser.parseNumber<T>();
+    }
+
+    static void write(JSONWriter & writer, T value) {
+        writer.writeDouble(value);
+    }
+
+    static size_t estimate(T) {
+        return 24;
+    }
+};
+
+template <> struct JSONCodec<std::string> {
+    static std::string parse(JSONParser & parser) {
+        std::string result;
+        parser.parseString(result);
+        return result;
+    }
+
+    static void write(JSONWriter & writer, const std::string & value) {
+        writer.writeString(value);
+    }
+
+    static size_t estimate(const std::string & value) {
+        return value.size() + 2;
+    }
+};
+
+template <typename T> struct JSONCodec<Array<T> > {
+    static Array<T> parse(JSONParser & parser) {
+        Array<T> result;
+
+        parser.expect('[');
+        if (parser.consume(']')) {
+            return result;
+        }
+        do {
+            result.push(JSONCodec<T>::parse(parser));
+        } while (parser.consume(','));
+        parser.expect(']');
+
+        return result;
+    }
+
+    static void write(JSONWriter & writer, const Array<T> & value) {
+        writer.write('[');
+        for (size_t i = 0; i < value.length(); ++i) {
+            if (i != 0) {
+                writer.write(',');
+            }
+            JSONCodec<T>::write(writer, value.begin()[i]);
+        }
+        writer.write(']');
+    }
+
+    static size_t estimate(const Array<T> & value) {
+        size_t total = 2 + value.length();
+
+        for (const T & item : value) {
+            total += JSONCodec<T>::estimate(item);
+        }
+
+        return total;
+    }
+};
+
+/**
+ * JS-style JSON parsing and serialization into and from typed values.
+ * @see https://developer.mozilla.org/en-US/docs/Web/JavaScript/Reference/Global_Objects/JSON
+ */
+class JSON
+{
+public:
+    /**
+     * Parse JSON text directly into a value of given type.
+     * @see https://developer.mozilla.org/en-US/docs/Web/JavaScript/Reference/Global_Objects/JSON/parse
+     *
+     * @tparam T Number, bool, std::string or (nested) Array of those.
+     * @param text JSON text.
+     * @returns Parsed value.
+     * @throws SyntaxError If text is malformed or does not match T.
+     */
+    template <typename T>
+    static T parse(const std::string & text) {
+        return parse<T>(text.data(), text.size());
+    }
+
+    /**
+     * Parse JSON text directly into a value of given type.
+     *
+     * @tparam T Number, bool, std::string or (nested) Array of those.
+     * @param data JSON text.
+     * @param size Length of the text.
+     * @returns Parsed value.
+     * @throws SyntaxError If text is malformed or does not match T.
+     */
+    template <typename T>
+    static T parse(const char * data, size_t size) {
+        JSONParser parser(data, data + size);
+        T result = JSONCodec<T>::parse(parser);
+
+        parser.finish();
+
+        return result;
+    }
+
+    /**
+     * Convert value to JSON text. Output is reserved upfront from an
+     * estimate of its size.
+     * @see https://developer.mozilla.org/en-US/docs/Web/JavaScript/Reference/Global_Objects/JSON/stringify
+     *
+     * @tparam T Number, bool, std::string or (nested) Array of those.
+     * @param value Value.
+     * @returns JSON text.
+     */
+    template <typename T>
+    static std::string stringify(const T & value) {
+        std::string result;
+        JSONWriter writer(result);
+
+        result.reserve(JSONCodec<T>::estimate(value));
+        JSONCodec<T>::write(writer, value);
+
+        return result;
+    }
+};
+
+} // namespace js4cpp
@@ -0,0 +1,126 @@
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+#include <string>
+
+#include <cppunit/TestCaller.h>
+#include <cppunit/TestCase.h>
+#include <cppunit/TestSuite.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+#include "json.hpp"
+
+class JSONTest : public CppUnit::TestCase
+{
+public:
+    JSONTest() : CppUnit::TestCase("JSON Test Case") {};
+
+    void testParseNumbers() {
+        using js4cpp::JSON;
+
+        CPPUNIT_ASSERT( JSON::parse<int>(" -42 ") == -42 );
+        CPPUNIT_ASSERT( JSON::parse<double>("1.5e3") == 1500 );
+        CPPUNIT_ASSERT( JSON::parse<double>("0.1") == 0.1 );
+        CPPUNIT_ASSERT( JSON::parse<double>("123456789012345678901234567890") == 123456789012345678901234567890.0 );
+        CPPUNIT_ASSERT( JSON::parse<double>("1.7976931348623157e308") == 1.7976931348623157e308 );
+        CPPUNIT_ASSERT( JSON::parse<int64_t>("-9223372036854775808") == INT64_MIN );
+        CPPUNIT_ASSERT( JSON::parse<uint8_t>("2e2") == 200 );
+        CPPUNIT_ASSERT( std::isnan(JSON::parse<double>("null")) );
+
+        CPPUNIT_ASSERT( fails<uint8_t>("256") );
+        CPPUNIT_ASSERT( fails<unsigned>("-1") );
+        CPPUNIT_ASSERT( fails<int>("1.5") );
+        CPPUNIT_ASSERT( fails<double>("01") );
+        CPPUNIT_ASSERT( fails<double>("1.") );
+        CPPUNIT_ASSERT( fails<double>("-") );
+
+        CPPUNIT_ASSERT( JSON::parse<uint64_t>("18446744073709551615") == UINT64_MAX );
+        CPPUNIT_ASSERT( JSON::parse<uint64_t>("10000000000000000000") == 10000000000000000000ULL );
+        CPPUNIT_ASSERT( JSON::parse<int64_t>("9223372036854775807") == INT64_MAX );
+        CPPUNIT_ASSERT( JSON::parse<int64_t>("-9.2233720368547758e18") == INT64_MIN );
+        CPPUNIT_ASSERT( JSON::parse<uint64_t>("1.8446744073709550e19") == 18446744073709549568ULL );
+        CPPUNIT_ASSERT( fails<uint64_t>("18446744073709551616") );
+        CPPUNIT_ASSERT( fails<uint64_t>("100000000000000000000") );
+        CPPUNIT_ASSERT( fails<int64_t>("9223372036854775808") );
+        CPPUNIT_ASSERT( fails<int64_t>("9.2233720368547758e18") );
+        CPPUNIT_ASSERT( fails<uint64_t>("1.8446744073709552e19") );
+        CPPUNIT_ASSERT( fails<int>("2147483648.0") );
+    }
+
+    void testParseStrings() {
+        using js4cpp::JSON;
+
+        CPPUNIT_ASSERT( JSON::parse<std::string>("\"plain text long enough for words\"") == "plain text long enough for words" );
+        CPPUNIT_ASSERT( JSON::parse<std::string>("\"a\\\"b\\\\c\\n\\u0041\"") == "a\"b\\c\nA" );
+        CPPUNIT_ASSERT( JSON::parse<std::string>("\"\\u00e9\\ud83d\\ude00\"") == "\xc3\xa9\xf0\x9f\x98\x80" );
+        CPPUNIT_ASSERT( JSON::parse<std::string>("\"\xc3\xa9t\xc3\xa9 \xc3\xa9t\xc3\xa9\"") == "\xc3\xa9t\xc3\xa9 \xc3\xa9t\xc3\xa9" );
+        CPPUNIT_ASSERT( JSON::parse<bool>("true") && !JSON::parse<bool>("false") );
+
+        CPPUNIT_ASSERT( fails<std::string>("\"unterminated") );
+        CPPUNIT_ASSERT( fails<std::string>("\"control\ncharacter\"") );
+        CPPUNIT_ASSERT( fails<std::string>("\"\\x\"") );
+    }
+
+    void testParseArrays() {
+        using js4cpp::Array;
+        using js4cpp::JSON;
+
+        Array<int> numbers = JSON::parse<Array<int> >("[1, 2 ,3]");
+        CPPUNIT_ASSERT( numbers.length() == 3 && numbers[2] == 3 );
+
+        Array<Array<std::string> > nested = JSON::parse<Array<Array<std::string> > >("[[], [\"a\", \"b\"]]");
+        CPPUNIT_ASSERT( nested.length() == 2 && nested[0].length() == 0 && nested[1][1] == "b" );
+
+        CPPUNIT_ASSERT( fails<Array<int> >("[1, 2") );
+        CPPUNIT_ASSERT( fails<Array<int> >("[1,]") );
+        CPPUNIT_ASSERT( fails<Array<int> >("[1] x") );
+        CPPUNIT_ASSERT( fails<Array<int> >("[\"1\"]") );
+    }
+
+    void testStringify() {
+        using js4cpp::Array;
+        using js4cpp::JSON;
+
+        CPPUNIT_ASSERT( JSON::stringify(Array<int>::of(1, -2, 30)) == "[1,-2,30]" );
+        CPPUNIT_ASSERT( JSON::stringify(Array<double>::of(0.1, 1.5, 1e-7, 1e21, 1e20, NAN)) == "[0.1,1.5,1e-7,1e+21,100000000000000000000,null]" );
+        CPPUNIT_ASSERT( JSON::stringify(true) == "true" && JSON::stringify(uint8_t(255)) == "255" );
+        CPPUNIT_ASSERT( JSON::stringify(std::string("a\"\\\n\x01")) == "\"a\\\"\\\\\\n\\u0001\"" );
+        CPPUNIT_ASSERT( JSON::stringify(Array<Array<int> >::of(Array<int>(), Array<int>::of(1))) == "[[],[1]]" );
+        CPPUNIT_ASSERT( JSON::stringify(Array<bool>::of(true, false)) == "[true,false]" );
+        CPPUNIT_ASSERT( JSON::parse<Array<bool> >("[false, true]")[1] );
+    }
+
+    void testRoundTrip() {
+        using js4cpp::Array;
+        using js4cpp::JSON;
+
+        Array<double> numbers = Array<double>::from(1000, [] (size_t i) { return std::sin(double(i)) * 1e5; });
+        Array<double> parsed = JSON::parse<Array<double> >(JSON::stringify(numbers));
+
+        CPPUNIT_ASSERT( parsed.length() == 1000 );
+        CPPUNIT_ASSERT( parsed.every([&numbers] (double x, size_t i) { return x == numbers[i]; }) );
+    }
+
+    CPPUNIT_TEST_SUITE( JSONTest );
+
+        CPPUNIT_TEST( testParseNumbers );
+        CPPUNIT_TEST( testParseStrings );
+        CPPUNIT_TEST( testParseArrays );
+        CPPUNIT_TEST( testStringify );
+        CPPUNIT_TEST( testRoundTrip );
+
+    CPPUNIT_TEST_SUITE_END();
+
+private:
+    template <typename T>
+    static bool fails(const std::string & text) {
+        try {
+            js4cpp::JSON::parse<T>(text);
+        } catch (const js4cpp::SyntaxError &) {
+            return true;
+        }
+
+        return false;
+    }
+};
@@ -0,0 +1,261 @@
+/* Copyright (c) 2012 Kirill Dmitrenko <kdmitrenko@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is furnished
+ * to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * @file json_stream.hpp
+ * Incremental reader of huge JSON arrays.
+ */
+
+#pragma once
+
+#include <functional>
+#include <istream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "array.hpp"
+#include "json.hpp"
+
+namespace js4cpp {
+
+/**
+ * Incremental parser of a top-level JSON array. Text is fed in chunks of
+ * any size (e.g. as it arrives from a pipe); elements are parsed as soon as
+ * they are complete and handed over in batches of fixed size.
+ *
+ * Memory is bounded by one batch plus one element's text: elements lying
+ * entirely inside a chunk are parsed in place, only elements split between
+ * chunks are buffered. Batch callback is invoked synchronously from write(),
+ * so a slow consumer throttles the producer.
+ *
+ * @tparam T Elements type, anything JSON::parse accepts.
+ */
+template <typename T> class JSONArrayReader
+{
+public:
+    /**
+     * Batch consumer. It may take the batch away (e.g. std::move it).
+     */
+    typedef std::function<void(Array<T> &)> BatchCallback;
+
+    /**
+     * Create reader.
+     *
+     * @param batchSize Number of elements in every batch but the last one.
+     * @param onBatch Batch consumer.
+     * @param maxElementSize Maximal length of a single element's text in bytes.
+     */
+    JSONArrayReader(size_t batchSize, BatchCallback onBatch, size_t maxElementSize = 16 << 20) :
+        batchSize_(batchSize ? batchSize : 1), onBatch_(onBatch), maxElementSize_(maxElementSize),
+        state_(BeforeArray), depth_(0), inString_(false), escaped_(false), offset_(0), elementOffset_(0) {}
+
+    /**
+     * Feed next chunk of text.
+     *
+     * @param data Chunk.
+     * @param size Chunk's length.
+     * @throws SyntaxError If text is malformed.
+     * @throws std::length_error If an element is longer than allowed.
+     */
+    void write(const char * data, size_t size) {
+        const char * p = data, * end = data + size;
+        const char * elementStart = state_ == InElement ? data : 0;
+
+        for (; p != end; ++p) {
+            char c = *p;
+
+            switch (state_) {
+            case BeforeArray:
+                if (c == '[') {
+                    state_ = BeforeFirstElement;
+                } else if (!isSpace(c)) {
+                    fail("Expected '['", p - data);
+                }
+                break;
+
+            case BeforeFirstElement:
+            case BeforeElement:
+                if (c == ']' && state_ == BeforeFirstElement) {
+                    state_ = Done;
+                    break;
+                } else if (isSpace(c)) {
+                    break;
+                } else if (c == ',' || c == ']') {
+                    fail("Expected array element", p - data);
+                }
+
+                state_ = InElement;
+                elementStart = p;
+                elementOffset_ = offset_ + (p - data);
+                depth_ = 0;
+                inString_ = escaped_ = false;
+                // fall through
+
+            case InElement:
+                if (inString_) {
+                    if (escaped_) {
+                        escaped_ = false;
+                    } else if (c == '\\') {
+                        escaped_ = true;
+                    } else if (c == '"') {
+                        inString_ = false;
+                    }
+                } else if (c == '"') {
+                    inString_ = true;
+                } else if (c == '[' || c == '{') {
+                    ++depth_;
+                } else if ((c == ']' || c == '}') && depth_ != 0) {
+                    --depth_;
+                } else if ((c == ',' || c == ']') && depth_ == 0) {
+                    completeElement(elementStart, p);
+                    elementStart = 0;
+                    state_ = c == ',' ? BeforeElement : Done;
+                }
+                break;
+
+            case Done:
+                if (!isSpace(c)) {
+                    fail("Unexpected token after array", p - data);
+                }
+                break;
+            }
+        }
+
+        if (state_ == InElement) {
+            if (pending_.size() + (end - elementStart) > maxElementSize_) {
+                throw std::length_error("JSON array element is too long");
+            }
+            pending_.append(elementStart, end);
+        }
+        offset_ += size;
+    }
+
+    /**
+     * Signal end of text and hand over the last (incomplete) batch.
+     *
+     * @throws SyntaxError If the array is not closed.
+     */
+    void end() {
+        if (state_ != Done) {
+            throw SyntaxError("Unexpected end of JSON input", offset_);
+        }
+        flush();
+    }
+
+    /**
+     * Check whether the closing bracket was seen.
+     *
+     * @returns `true` if the whole array was read.
+     */
+    bool done() const {
+        return state_ == Done;
+    }
+
+private:
+    enum State {
+        BeforeArray,
+        BeforeFirstElement,
+        BeforeElement,
+        InElement,
+        Done
+    };
+
+    static bool isSpace(char c) {
+        return c == ' ' || c == '\n' || c == '\r' || c == '\t';
+    }
+
+    void fail(const char * message, size_t chunkOffset) const {
+        throw SyntaxError(message, offset_ + chunkOffset);
+    }
+
+    void completeElement(const char * begin, const char * end) {
+        if (pending_.size() + (end - begin) > maxElementSize_) {
+            throw std::length_error("JSON array element is too long");
+        }
+
+        if (pending_.empty()) {
+            parseElement(begin, end);
+        } else {
+            pending_.append(begin, end);
+            parseElement(pending_.data(), pending_.data() + pending_.size());
+            pending_.clear();
+        }
+
+        if (batch_.length() == batchSize_) {
+            flush();
+        }
+    }
+
+    void parseElement(const char * begin, const char * end) {
+        JSONParser parser(begin, end);
+
+        try {
+            batch_.push(JSONCodec<T>::parse(parser));
+            parser.finish();
+        } catch (const SyntaxError & error) {
+            throw SyntaxError("Invalid array element", elementOffset_ + error.position());
+        }
+    }
+
+    void flush() {
+        if (batch_.length() != 0) {
+            onBatch_(batch_);
+            batch_ = Array<T>();
+        }
+    }
+
+    size_t batchSize_;
+    BatchCallback onBatch_;
+    size_t maxElementSize_;
+
+    State state_;
+    size_t depth_;
+    bool inString_;
+    bool escaped_;
+
+    size_t offset_;
+    size_t elementOffset_;
+    std::string pending_;
+    Array<T> batch_;
+};
+
+/**
+ * Read top-level JSON array from a stream in batches.
+ *
+ * @tparam T Elements type, anything JSON::parse accepts.
+ * @param input Stream.
+ * @param batchSize Number of elements in every batch but the last one.
+ * @param onBatch Batch consumer.
+ * @param chunkSize Number of bytes read from the stream at once.
+ * @throws SyntaxError If text is malformed.
+ */
+template <typename T>
+void readJSONArray(std::istream & input, size_t batchSize, typename JSONArrayReader<T>::BatchCallback onBatch, size_t chunkSize = 64 << 10) {
+    JSONArrayReader<T> reader(batchSize, onBatch);
+    std::vector<char> chunk(chunkSize);
+
+    while (input.read(chunk.data(), chunk.size()) || input.gcount() > 0) {
+        reader.write(chunk.data(), input.gcount());
+    }
+    reader.end();
+}
+
+} // namespace js4cpp
@@ -0,0 +1,118 @@
+#pragma once
+
+#include <sstream>
+#include <stdexcept>
+#include <string>
+
+#include <cppunit/TestCaller.h>
+#include <cppunit/TestCase.h>
+#include <cppunit/TestSuite.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+#include "json_stream.hpp"
+
+class JSONStreamTest : public CppUnit::TestCase
+{
+public:
+    JSONStreamTest() : CppUnit::TestCase("JSON Stream Test Case") {};
+
+    void testBatches() {
+        using js4cpp::Array;
+
+        Array<size_t> sizes;
+        int sum = 0;
+        js4cpp::JSONArrayReader<int> reader(3, [&] (Array<int> & batch) {
+            sizes.push(batch.length());
+            sum += batch.reduce();
+        });
+
+        std::string text = " [1, 2, 3, 4,\n 5, 6, 7] ";
+        for (size_t i = 0; i < text.size(); ++i) {
+            reader.write(&text[i], 1);
+        }
+        reader.end();
+
+        CPPUNIT_ASSERT( reader.done() && sum == 28 );
+        CPPUNIT_ASSERT( sizes.length() == 3 && sizes[0] == 3 && sizes[2] == 1 );
+    }
+
+    void testNestedElements() {
+        using js4cpp::Array;
+
+        Array<Array<std::string> > all;
+        js4cpp::JSONArrayReader<Array<std::string> > reader(2, [&all] (Array<Array<std::string> > & batch) {
+            for (auto & item : batch) {
+                all.push(item);
+            }
+        });
+
+        std::string text = "[[\"a,]\", \"b\\\"]\"], [], [\"c\"]]";
+        reader.write(text.data(), 7);
+        reader.write(text.data() + 7, text.size() - 7);
+        reader.end();
+
+        CPPUNIT_ASSERT( all.length() == 3 && all[0][0] == "a,]" && all[0][1] == "b\"]" && all[2][0] == "c" );
+    }
+
+    void testStream() {
+        std::ostringstream json;
+        json << '[';
+        for (int i = 0; i < 10000; ++i) {
+            json << (i ? "," : "") << i * 0.5;
+        }
+        json << ']';
+
+        std::istringstream input(json.str());
+        double sum = 0;
+        size_t batches = 0;
+
+        js4cpp::readJSONArray<double>(input, 1000, [&] (js4cpp::Array<double> & batch) {
+            sum += batch.reduce();
+            ++batches;
+        }, 4096);
+
+        CPPUNIT_ASSERT( batches == 10 && sum == 24997500 );
+    }
+
+    void testErrors() {
+        CPPUNIT_ASSERT( fails("{}") );
+        CPPUNIT_ASSERT( fails("[1,,2]") );
+        CPPUNIT_ASSERT( fails("[1, x]") );
+        CPPUNIT_ASSERT( fails("[1, 2") );
+        CPPUNIT_ASSERT( fails("[1] 2") );
+        CPPUNIT_ASSERT( !fails("[]") );
+
+        js4cpp::JSONArrayReader<std::string> reader(1, [] (js4cpp::Array<std::string> &) {}, 8);
+        bool thrown = false;
+        try {
+            reader.write("[\"0123", 6);
+            reader.write("456789\"]", 8);
+        } catch (const std::length_error &) {
+            thrown = true;
+        }
+        CPPUNIT_ASSERT( thrown );
+    }
+
+    CPPUNIT_TEST_SUITE( JSONStreamTest );
+
+        CPPUNIT_TEST( testBatches );
+        CPPUNIT_TEST( testNestedElements );
+        CPPUNIT_TEST( testStream );
+        CPPUNIT_TEST( testErrors );
+
+    CPPUNIT_TEST_SUITE_END();
+
+private:
+    static bool fails(const std::string & text) {
+        js4cpp::JSONArrayReader<int> reader(10, [] (js4cpp::Array<int> &) {});
+
+        try {
+            reader.write(text.data(), text.size());
+            reader.end();
+        } catch (const js4cpp::SyntaxError &) {
+            return true;
+        }
+
+        return false;
+    }
+};
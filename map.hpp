@@ -0,0 +1,202 @@
+/* Copyright (c) 2012 Kirill Dmitrenko <kdmitrenko@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is furnished
+ * to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * @file map.hpp
+ * JS-style Map.
+ */
+
+#pragma once
+
+#include <utility>
+
+#include "array.hpp"
+#include "ordered_table.hpp"
+
+namespace js4cpp {
+
+/**
+ * JS-style map: keys are compared with SameValueZero and entries are
+ * iterated in insertion order.
+ * @see https://developer.mozilla.org/en-US/docs/Web/JavaScript/Reference/Global_Objects/Map
+ *
+ * @tparam K Keys type.
+ * @tparam V Values type.
+ */
+template <typename K, typename V> class Map
+{
+    struct KeyOf {
+        const K & operator ()(const std::pair<K, V> & entry) const {
+            return entry.first;
+        }
+    };
+
+    typedef OrderedTable<std::pair<K, V>, KeyOf> Table;
+
+public:
+    typedef typename Table::const_iterator iterator;
+    typedef typename Table::const_iterator const_iterator;
+    typedef std::pair<K, V> value_type;
+
+    /**
+     * Create empty map.
+     */
+    Map() {}
+
+    /**
+     * Create map from array of [key, value] pairs; later pairs win.
+     * @see https://developer.mozilla.org/en-US/docs/Web/JavaScript/Reference/Global_Objects/Map/Map
+     *
+     * @param entries Entries.
+     */
+    explicit Map(const Array<std::pair<K, V> > & entries) {
+        for (const std::pair<K, V> & entry : entries) {
+            set(entry.first, entry.second);
+        }
+    }
+
+    /**
+     * Get number of entries.
+     * @see https://developer.mozilla.org/en-US/docs/Web/JavaScript/Reference/Global_Objects/Map/size
+     *
+     * @returns Size.
+     */
+    size_t size() const {
+        return table_.size();
+    }
+
+    /**
+     * Get value by key.
+     * @see https://developer.mozilla.org/en-US/docs/Web/JavaScript/Reference/Global_Objects/Map/get
+     *
+     * @param key Key.
+     * @param fallback Value returned when there is no such key (JS returns undefined).
+     * @returns Value.
+     */
+    V get(const K & key, const V & fallback = V()) const {
+        const std::pair<K, V> * entry = table_.find(key);
+
+        return entry ? entry->second : fallback;
+    }
+
+    /**
+     * Check whether map has a key.
+     * @see https://developer.mozilla.org/en-US/docs/Web/JavaScript/Reference/Global_Objects/Map/has
+     *
+     * @param key Key.
+     * @returns True if it has.
+     */
+    bool has(const K & key) const {
+        return table_.find(key) != 0;
+    }
+
+    /**
+     * Set value of a key. Keys already present keep their position.
+     * @see https://developer.mozilla.org/en-US/docs/Web/JavaScript/Reference/Global_Objects/Map/set
+     *
+     * @param key Key.
+     * @param value Value.
+     * @returns Map itself.
+     */
+    Map & set(const K & key, const V & value) {
+        std::pair<std::pair<K, V> *, bool> result = table_.insert(key, std::make_pair(key, value));
+
+        if (!result.second) {
+            result.first->second = value;
+        }
+
+        return *this;
+    }
+
+    /**
+     * Remove entry (`delete` in JS, which is reserved in C++).
+     * @see https://developer.mozilla.org/en-US/docs/Web/JavaScript/Reference/Global_Objects/Map/delete
+     *
+     * @param key Key.
+     * @returns True if there was such entry.
+     */
+    bool remove(const K & key) {
+        return table_.remove(key);
+    }
+
+    /**
+     * Remove all entries.
+     * @see https://developer.mozilla.org/en-US/docs/Web/JavaScript/Reference/Global_Objects/Map/clear
+     */
+    void clear() {
+        table_.clear();
+    }
+
+    /**
+     * Execute a function for each entry in insertion order.
+     * @see https://developer.mozilla.org/en-US/docs/Web/JavaScript/Reference/Global_Objects/Map/forEach
+     *
+     * @param callback Function called as callback(value, key, map), taking as many arguments as it needs.
+     */
+    template <typename F>
+    void forEach(F callback) {
+        table_.forEach([&] (std::pair<K, V> & entry) {
+            invokeCallback(callback, entry.second, entry.first, *this);
+        });
+    }
+
+    /**
+     * Get keys in insertion order.
+     * @see https://developer.mozilla.org/en-US/docs/Web/JavaScript/Reference/Global_Objects/Map/keys
+     *
+     * @returns Array of keys.
+     */
+    Array<K> keys() const {
+        return Array<K>::from(*this, [] (const std::pair<K, V> & entry) { return entry.first; });
+    }
+
+    /**
+     * Get values in insertion order.
+     * @see https://developer.mozilla.org/en-US/docs/Web/JavaScript/Reference/Global_Objects/Map/values
+     *
+     * @returns Array of values.
+     */
+    Array<V> values() const {
+        return Array<V>::from(*this, [] (const std::pair<K, V> & entry) { return entry.second; });
+    }
+
+    /**
+     * Get [key, value] pairs in insertion order.
+     * @see https://developer.mozilla.org/en-US/docs/Web/JavaScript/Reference/Global_Objects/Map/entries
+     *
+     * @returns Array of pairs.
+     */
+    Array<std::pair<K, V> > entries() const {
+        return Array<std::pair<K, V> >::from(*this);
+    }
+
+    const_iterator begin() const {
+        return table_.begin();
+    }
+
+    const_iterator end() const {
+        return table_.end();
+    }
+
+private:
+    Table table_;
+};
+
+} // namespace js4cpp
@@ -0,0 +1,142 @@
+#pragma once
+
+#include <cmath>
+#include <string>
+#include <utility>
+
+#include <cppunit/TestCaller.h>
+#include <cppunit/TestCase.h>
+#include <cppunit/TestSuite.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+#include "map.hpp"
+#include "string.hpp"
+#include "value.hpp"
+
+class MapTest : public CppUnit::TestCase
+{
+public:
+    MapTest() : CppUnit::TestCase("Map Test Case") {};
+
+    void testSetGet() {
+        map->set("b", 2).set("a", 1).set("c", 3);
+        CPPUNIT_ASSERT( map->size() == 3 && map->get("a") == 1 && map->get("missing") == 0 && map->get("missing", -1) == -1 );
+        CPPUNIT_ASSERT( map->has("c") && !map->has("d") );
+
+        map->set("b", 20);
+        CPPUNIT_ASSERT( map->size() == 3 && map->get("b") == 20 && map->keys().join() == "b,a,c" );
+    }
+
+    void testRemove() {
+        map->set("a", 1).set("b", 2).set("c", 3);
+        CPPUNIT_ASSERT( map->remove("b") && !map->remove("b") && !map->has("b") );
+        CPPUNIT_ASSERT( map->size() == 2 && map->keys().join() == "a,c" );
+
+        map->set("b", 4);
+        CPPUNIT_ASSERT( map->keys().join() == "a,c,b" && map->values().join() == "1,3,4" );
+
+        map->clear();
+        CPPUNIT_ASSERT( map->size() == 0 && !map->has("a") && map->begin() == map->end() );
+    }
+
+    void testGrowth() {
+        using js4cpp::Map;
+
+        Map<int, int> squares;
+        for (int i = 0; i < 10000; ++i) {
+            squares.set(i * 1024, i * i);
+        }
+        for (int i = 0; i < 10000; i += 2) {
+            squares.remove(i * 1024);
+        }
+        for (int i = 10000; i < 12000; ++i) {
+            squares.set(i * 1024, i * i);
+        }
+        CPPUNIT_ASSERT( squares.size() == 7000 && squares.get(9999 * 1024) == 9999 * 9999 && !squares.has(0) );
+        CPPUNIT_ASSERT( squares.keys()[0] == 1024 && squares.keys()[6999] == 11999 * 1024 );
+    }
+
+    void testSameValueZero() {
+        using js4cpp::Array;
+        using js4cpp::Map;
+        using js4cpp::Value;
+
+        Map<double, int> numbers;
+        numbers.set(NAN, 1).set(-0.0, 2).set(0.0, 3);
+        CPPUNIT_ASSERT( numbers.size() == 2 && numbers.get(-NAN) == 1 && numbers.get(0.0) == 3 );
+
+        Map<Value, int> values;
+        Value array = Array<Value>::of(1);
+        values.set(1, 1).set("1", 2).set(array, 3).set(Array<Value>::of(1), 4).set(NAN, 5);
+        CPPUNIT_ASSERT( values.size() == 5 && values.get(1.0) == 1 && values.get(std::string("1")) == 2 );
+        CPPUNIT_ASSERT( values.get(array) == 3 && values.get(Value(NAN)) == 5 && !values.has(Value()) );
+    }
+
+    void testIteration() {
+        using js4cpp::Array;
+        using js4cpp::Map;
+
+        Map<js4cpp::String, int> counts(Array<std::pair<js4cpp::String, int> >::of(
+            std::make_pair(js4cpp::String("x"), 1), std::make_pair(js4cpp::String("y"), 2), std::make_pair(js4cpp::String("x"), 3)));
+        CPPUNIT_ASSERT( counts.size() == 2 && counts.get("x") == 3 );
+
+        counts.forEach([] (int & value) { value *= 10; });
+        std::string visited;
+        counts.forEach([&] (int value, const js4cpp::String & key, Map<js4cpp::String, int> & self) {
+            visited += key.str() + "=" + std::to_string(value) + ";";
+            if (key == "x") {
+                self.remove("y");
+                self.set("z", 0);
+            }
+        });
+        CPPUNIT_ASSERT( visited == "x=30;z=0;" );
+
+        int total = 0;
+        for (const std::pair<js4cpp::String, int> & entry : counts) {
+            total += entry.second;
+        }
+        CPPUNIT_ASSERT( total == 30 && counts.entries().length() == 2 && counts.entries()[1].first == "z" );
+    }
+
+    void testInsertDuringForEach() {
+        using js4cpp::Map;
+
+        Map<std::string, std::string> names;
+        names.set("a", "first");
+        names.set("b", "second");
+
+        size_t visited = 0;
+        names.forEach([&] (std::string & value, const std::string & key, Map<std::string, std::string> & self) {
+            if (key == "a") {
+                for (int i = 0; i < 1000; ++i) {
+                    self.set("key " + std::to_string(i), "value");
+                }
+            }
+            // Entry references stay valid while the table grows under them.
+            value = key + ":" + value;
+            ++visited;
+        });
+        CPPUNIT_ASSERT( visited == 1002 && names.size() == 1002 );
+        CPPUNIT_ASSERT( names.get("a") == "a:first" && names.get("b") == "b:second" && names.get("key 999") == "key 999:value" );
+    }
+
+    void setUp() {
+        map = new js4cpp::Map<std::string, int>();
+    }
+
+    void tearDown() {
+        delete map;
+    }
+
+    CPPUNIT_TEST_SUITE( MapTest );
+    CPPUNIT_TEST( testSetGet );
+    CPPUNIT_TEST( testRemove );
+    CPPUNIT_TEST( testGrowth );
+    CPPUNIT_TEST( testSameValueZero );
+    CPPUNIT_TEST( testIteration );
+    CPPUNIT_TEST( testInsertDuringForEach );
+    CPPUNIT_TEST_SUITE_END();
+
+private:
+    js4cpp::Map<std::string, int> * map;
+};
@@ -0,0 +1,239 @@
+/* Copyright (c) 2012 Kirill Dmitrenko <kdmitrenko@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is furnished
+ * to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * @file mapped_array.hpp
+ * Arrays backed by memory mapped files.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <type_traits>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "array.hpp"
+#include "array_buffer.hpp"
+#include "array_view.hpp"
+
+namespace js4cpp {
+
+/**
+ * Read side of js4cpp::Array's API over a memory mapped file holding packed
+ * elements (exactly what MappedArray::save writes), so datasets larger than
+ * RAM are paged in on demand instead of being read upfront. Copies share the
+ * mapping; the file is unmapped when the last copy is gone.
+ *
+ * @tparam T Elements type.
+ */
+template <typename T> class MappedArray : public ArrayView<T>
+{
+    static_assert(std::is_trivially_copyable<T>::value, "Only trivially copyable elements can be mapped");
+
+public:
+    /**
+     * How the file is mapped.
+     */
+    enum Mode {
+        /** Elements are read-only. */
+        ReadOnly,
+        /** Elements are writable, changes are private and never reach the file. */
+        CopyOnWrite
+    };
+
+    /**
+     * Expected access pattern, see madvise(2).
+     */
+    enum Advice {
+        Normal = MADV_NORMAL,
+        Sequential = MADV_SEQUENTIAL,
+        Random = MADV_RANDOM,
+        WillNeed = MADV_WILLNEED,
+        DontNeed = MADV_DONTNEED
+    };
+
+    /**
+     * Map given file.
+     *
+     * @param path Path to the file.
+     * @param mode Mapping mode.
+     * @throws std::system_error If file can't be opened or mapped.
+     * @throws std::runtime_error If file size is not a multiple of element size.
+     */
+    explicit MappedArray(const std::string & path, Mode mode = ReadOnly) : mode_(mode) {
+        int fd = ::open(path.c_str(), O_RDONLY);
+
+        if (fd == -1) {
+            throw std::system_error(errno, std::generic_category(), "Can't open " + path);
+        }
+
+        struct stat info;
+        if (::fstat(fd, &info) == -1) {
+            int error = errno;
+            ::close(fd);
+            throw std::system_error(error, std::generic_category(), "Can't stat " + path);
+        }
+
+        size_t size = info.st_size;
+        if (size % sizeof(T) != 0) {
+            ::close(fd);
+            throw std::runtime_error("Size of " + path + " is not a multiple of element size");
+        }
+
+        void * memory = 0;
+        if (size != 0) {
+            memory = ::mmap(0, size, mode == ReadOnly ? PROT_READ : PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+        }
+
+        int error = errno;
+        ::close(fd);
+        if (memory == MAP_FAILED) {
+            throw std::system_error(error, std::generic_category(), "Can't map " + path);
+        }
+
+        buffer_ = ArrayBuffer::wrap(memory, size, [size] (void * data) {
+            if (data) {
+                ::munmap(data, size);
+            }
+        });
+        this->data_ = static_cast<const T *>(memory);
+        this->length_ = size / sizeof(T);
+    }
+
+    /**
+     * Get mapping mode.
+     *
+     * @returns Mode.
+     */
+    Mode mode() const {
+        return mode_;
+    }
+
+    /**
+     * Get the buffer holding copy-on-write mapping, e.g. to create typed
+     * arrays or data views over it. Read-only mappings don't give the buffer
+     * out, since views over it would be writable and writing through them
+     * would crash; the mapped array itself is their read-only view.
+     *
+     * @returns Buffer.
+     * @throws std::logic_error If the file is mapped read-only.
+     */
+    const ArrayBuffer & buffer() const {
+        if (mode_ != CopyOnWrite) {
+            throw std::logic_error("Buffer of read-only mapping can't be shared");
+        }
+
+        return buffer_;
+    }
+
+    /**
+     * Get writable element of copy-on-write mapping.
+     *
+     * @param i Index.
+     * @returns Element.
+     * @throws std::logic_error If the file is mapped read-only.
+     */
+    T & at(size_t i) {
+        if (mode_ != CopyOnWrite) {
+            throw std::logic_error("Elements of read-only mapping can't be changed");
+        }
+
+        return const_cast<T *>(this->data_)[i];
+    }
+
+    /**
+     * Hint the kernel how elements are going to be accessed.
+     *
+     * @param advice Access pattern.
+     * @param begin Index of the first element the hint applies to.
+     * @param end Index past the last element the hint applies to. Defaults to the end.
+     */
+    void advise(Advice advice, size_t begin = 0, size_t end = size_t(-1)) const {
+        end = std::min(end, this->length_);
+        if (begin >= end) {
+            return;
+        }
+
+        // madvise wants page aligned address.
+        const size_t page = ::sysconf(_SC_PAGESIZE);
+        uintptr_t from = reinterpret_cast<uintptr_t>(this->data_ + begin) / page * page;
+        uintptr_t to = reinterpret_cast<uintptr_t>(this->data_ + end);
+
+        ::madvise(reinterpret_cast<void *>(from), to - from, advice);
+    }
+
+    /**
+     * Write elements to a file in the format MappedArray maps: packed
+     * elements without any header.
+     *
+     * @tparam Source Array, ArrayView, MappedArray or any other container whose begin() and end() are pointers.
+     * @param source Elements.
+     * @param path Path to the file; it is truncated if it exists.
+     * @throws std::system_error If writing fails.
+     */
+    template <typename Source>
+    static void save(const Source & source, const std::string & path) {
+        int fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+
+        if (fd == -1) {
+            throw std::system_error(errno, std::generic_category(), "Can't open " + path);
+        }
+
+        const T * first = source.begin();
+        const char * bytes = reinterpret_cast<const char *>(first);
+        size_t left = (source.end() - first) * sizeof(T);
+
+        while (left != 0) {
+            ssize_t written = ::write(fd, bytes, left);
+
+            if (written == -1) {
+                if (errno == EINTR) {
+                    continue;
+                }
+
+                int error = errno;
+                ::close(fd);
+                throw std::system_error(error, std::generic_category(), "Can't write " + path);
+            }
+
+            bytes += written;
+            left -= written;
+        }
+
+        if (::close(fd) == -1) {
+            throw std::system_error(errno, std::generic_category(), "Can't write " + path);
+        }
+    }
+
+private:
+    Mode mode_;
+    ArrayBuffer buffer_;
+};
+
+} // namespace js4cpp
@@ -0,0 +1,110 @@
+#pragma once
+
+#include <cstdlib>
+#include <string>
+
+#include <unistd.h>
+
+#include <cppunit/TestCaller.h>
+#include <cppunit/TestCase.h>
+#include <cppunit/TestSuite.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+#include "mapped_array.hpp"
+
+class MappedArrayTest : public CppUnit::TestCase
+{
+public:
+    MappedArrayTest() : CppUnit::TestCase("MappedArray Test Case") {};
+
+    void setUp() {
+        char name[] = "/tmp/js4cpp-mapped-XXXXXX";
+        ::close(::mkstemp(name));
+        path = name;
+
+        js4cpp::MappedArray<double>::save(
+            js4cpp::Array<double>::from(1000, [] (size_t i) { return i * 0.5; }), path);
+    }
+
+    void testReadOnly() {
+        js4cpp::MappedArray<double> mapped(path);
+
+        mapped.advise(js4cpp::MappedArray<double>::Sequential);
+        CPPUNIT_ASSERT( mapped.length() == 1000 && mapped[999] == 499.5 );
+        CPPUNIT_ASSERT( mapped.indexOf(10) == 20 );
+        CPPUNIT_ASSERT( mapped.filter([] (double x) { return x < 5; }).length() == 10 );
+
+        bool thrown = false;
+        try {
+            mapped.at(0) = 1;
+        } catch (const std::logic_error &) {
+            thrown = true;
+        }
+        CPPUNIT_ASSERT( thrown );
+
+        thrown = false;
+        try {
+            mapped.buffer();
+        } catch (const std::logic_error &) {
+            thrown = true;
+        }
+        CPPUNIT_ASSERT( thrown );
+    }
+
+    void testCopyOnWrite() {
+        {
+            js4cpp::MappedArray<double> mapped(path, js4cpp::MappedArray<double>::CopyOnWrite);
+
+            mapped.at(0) = 42;
+            CPPUNIT_ASSERT( mapped[0] == 42 && mapped.buffer().byteLength() == 8000 );
+        }
+
+        CPPUNIT_ASSERT( js4cpp::MappedArray<double>(path)[0] == 0 );
+    }
+
+    void testSave() {
+        js4cpp::MappedArray<double> mapped(path);
+        std::string copyPath = path + ".copy";
+
+        js4cpp::MappedArray<double>::save(mapped.subarray(10, 20), copyPath);
+        js4cpp::MappedArray<double> copy(copyPath);
+        CPPUNIT_ASSERT( copy.length() == 10 && copy[0] == 5 );
+
+        ::unlink(copyPath.c_str());
+    }
+
+    void testErrors() {
+        bool thrown = false;
+        try {
+            js4cpp::MappedArray<double> missing(path + ".missing");
+        } catch (const std::system_error &) {
+            thrown = true;
+        }
+        CPPUNIT_ASSERT( thrown );
+
+        js4cpp::MappedArray<char>::save(js4cpp::Array<char>::of('x'), path);
+        thrown = false;
+        try {
+            js4cpp::MappedArray<double> odd(path);
+        } catch (const std::runtime_error &) {
+            thrown = true;
+        }
+        CPPUNIT_ASSERT( thrown );
+    }
+
+    void tearDown() {
+        ::unlink(path.c_str());
+    }
+
+    CPPUNIT_TEST_SUITE( MappedArrayTest );
+
+        CPPUNIT_TEST( testReadOnly );
+        CPPUNIT_TEST( testCopyOnWrite );
+        CPPUNIT_TEST( testSave );
+        CPPUNIT_TEST( testErrors );
+
+    CPPUNIT_TEST_SUITE_END();
+
+private:
+    std::string path;
+};
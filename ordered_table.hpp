@@ -0,0 +1,373 @@
+/* Copyright (c) 2012 Kirill Dmitrenko <kdmitrenko@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is furnished
+ * to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * @file ordered_table.hpp
+ * Insertion-ordered hash table shared by Map and Set.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <iterator>
+#include <limits>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace js4cpp {
+
+/**
+ * Hash consistent with SameValueZero: for floating point keys all NaNs
+ * hash alike, as do 0 and -0. Other types use std::hash.
+ */
+template <typename T, typename Enable = void> struct SameValueZeroHash : std::hash<T> {};
+
+template <typename T> struct SameValueZeroHash<T, typename std::enable_if<std::is_floating_point<T>::value>::type> {
+    size_t operator ()(T value) const {
+        if (value != value) {
+            return 0x7ff8;
+        }
+
+        return std::hash<T>()(value == 0 ? T(0) : value);
+    }
+};
+
+/**
+ * Compare keys with SameValueZero: like `==` (so 0 equals -0), except
+ * that NaN equals itself.
+ * @see https://developer.mozilla.org/en-US/docs/Web/JavaScript/Equality_comparisons_and_sameness#same-value-zero_equality
+ */
+template <typename T>
+bool sameValueZero(const T & a, const T & b) {
+    return a == b || (!(a == a) && !(b == b));
+}
+
+/**
+ * Hash table which keeps items in insertion order, after V8's ordered hash
+ * tables and CPython's compact dict: items live in a dense array in the
+ * order they were added, and an open-addressing index of 32-bit slots
+ * (linear probing) maps hashes to positions in that array. Iteration is a
+ * linear scan of the dense array and the index costs only 4 bytes per slot.
+ * The dense array is a deque, so appending never moves items and
+ * references to them (e.g. the one forEach passes) stay valid.
+ *
+ * Removed items stay in place, marked as deleted, until the table is
+ * compacted while growing, so removing items during forEach is safe and
+ * items added during forEach are visited.
+ *
+ * @tparam Item Stored item.
+ * @tparam KeyOf Callable extracting key from an item.
+ */
+template <typename Item, typename KeyOf> class OrderedTable
+{
+public:
+    typedef typename std::decay<decltype(KeyOf()(std::declval<const Item &>()))>::type Key;
+
+    /**
+     * Item with its cached hash.
+     */
+    struct Entry {
+        Item item;
+        uint32_t hash;
+        bool deleted;
+    };
+
+private:
+    typedef typename std::deque<Entry>::const_iterator Position;
+
+public:
+    /**
+     * Iterator over items which are not deleted.
+     */
+    class const_iterator
+    {
+    public:
+        typedef std::forward_iterator_tag iterator_category;
+        typedef Item value_type;
+        typedef ptrdiff_t difference_type;
+        typedef const Item & reference;
+        typedef const Item * pointer;
+
+        const_iterator(Position entry, Position end) : entry_(entry), end_(end) {
+            skipDeleted();
+        }
+
+        const Item & operator *() const {
+            return entry_->item;
+        }
+
+        const Item * operator ->() const {
+            return &entry_->item;
+        }
+
+        const_iterator & operator ++() {
+            ++entry_;
+            skipDeleted();
+            return *this;
+        }
+
+        const_iterator operator ++(int) {
+            const_iterator result = *this;
+            ++*this;
+            return result;
+        }
+
+        bool operator ==(const const_iterator & other) const {
+            return entry_ == other.entry_;
+        }
+
+        bool operator !=(const const_iterator & other) const {
+            return entry_ != other.entry_;
+        }
+
+    private:
+        void skipDeleted() {
+            while (entry_ != end_ && entry_->deleted) {
+                ++entry_;
+            }
+        }
+
+        Position entry_;
+        Position end_;
+    };
+
+    OrderedTable() : deleted_(0), shift_(64), iterating_(0) {}
+
+    /**
+     * Get number of items.
+     */
+    size_t size() const {
+        return entries_.size() - deleted_;
+    }
+
+    /**
+     * Find item by key.
+     *
+     * @param key Key.
+     * @returns Item or null if there is none.
+     */
+    const Item * find(const Key & key) const {
+        size_t position = lookup(key, hashOf(key));
+
+        return position == NOT_FOUND ? 0 : &entries_[position].item;
+    }
+
+    Item * find(const Key & key) {
+        size_t position = lookup(key, hashOf(key));
+
+        return position == NOT_FOUND ? 0 : &entries_[position].item;
+    }
+
+    /**
+     * Find item by key or append a new one.
+     *
+     * @param key Key.
+     * @param item Item to append if none has the key.
+     * @returns Item with the key and whether it was appended.
+     */
+    template <typename I>
+    std::pair<Item *, bool> insert(const Key & key, I && item) {
+        uint64_t hash = hashOf(key);
+        size_t position = lookup(key, hash);
+
+        if (position != NOT_FOUND) {
+            return std::make_pair(&entries_[position].item, false);
+        }
+        if ((entries_.size() + 1) * 4 > index_.size() * 3) {
+            rehash();
+        }
+
+        Entry entry = { std::forward<I>(item), static_cast<uint32_t>(hash), false };
+        entries_.push_back(std::move(entry));
+        place(hash, entries_.size());
+
+        return std::make_pair(&entries_.back().item, true);
+    }
+
+    /**
+     * Remove item by key.
+     *
+     * @param key Key.
+     * @returns True if there was such item.
+     */
+    bool remove(const Key & key) {
+        size_t position = lookup(key, hashOf(key));
+
+        if (position == NOT_FOUND) {
+            return false;
+        }
+
+        // Release what the item holds; its slot stays taken until compaction.
+        entries_[position].item = Item();
+        entries_[position].deleted = true;
+        ++deleted_;
+
+        return true;
+    }
+
+    /**
+     * Remove all items.
+     */
+    void clear() {
+        if (iterating_ != 0) {
+            for (size_t i = 0; i < entries_.size(); ++i) {
+                if (!entries_[i].deleted) {
+                    entries_[i].item = Item();
+                    entries_[i].deleted = true;
+                    ++deleted_;
+                }
+            }
+            return;
+        }
+
+        entries_.clear();
+        index_.clear();
+        deleted_ = 0;
+        shift_ = 64;
+    }
+
+    /**
+     * Call function for every item in insertion order, including items
+     * added meanwhile.
+     *
+     * @param callback Function called as callback(item).
+     */
+    template <typename F>
+    void forEach(F callback) {
+        ++iterating_;
+        try {
+            for (size_t i = 0; i < entries_.size(); ++i) {
+                if (!entries_[i].deleted) {
+                    callback(entries_[i].item);
+                }
+            }
+        } catch (...) {
+            --iterating_;
+            throw;
+        }
+        --iterating_;
+    }
+
+    const_iterator begin() const {
+        return const_iterator(entries_.begin(), entries_.end());
+    }
+
+    const_iterator end() const {
+        return const_iterator(entries_.end(), entries_.end());
+    }
+
+private:
+    static const size_t NOT_FOUND = ~size_t(0);
+    static const size_t MIN_CAPACITY = 8;
+
+    static uint64_t hashOf(const Key & key) {
+        return SameValueZeroHash<Key>()(key);
+    }
+
+    /**
+     * Get first slot to probe: Fibonacci hashing takes the top bits of the
+     * product, so weak hashes (std::hash of integers is the identity) are
+     * spread across the index too.
+     */
+    size_t slotOf(uint64_t hash) const {
+        return static_cast<size_t>((static_cast<uint32_t>(hash) * 0x9e3779b97f4a7c15ULL) >> shift_);
+    }
+
+    size_t lookup(const Key & key, uint64_t hash) const {
+        if (index_.empty()) {
+            return NOT_FOUND;
+        }
+
+        size_t mask = index_.size() - 1;
+        uint32_t shortHash = static_cast<uint32_t>(hash);
+
+        for (size_t slot = slotOf(hash);; slot = (slot + 1) & mask) {
+            uint32_t position = index_[slot];
+
+            if (position == 0) {
+                return NOT_FOUND;
+            }
+
+            const Entry & entry = entries_[position - 1];
+            if (entry.hash == shortHash && !entry.deleted && sameValueZero(KeyOf()(entry.item), key)) {
+                return position - 1;
+            }
+        }
+    }
+
+    void place(uint64_t hash, size_t position) {
+        size_t mask = index_.size() - 1;
+        size_t slot = slotOf(hash);
+
+        while (index_[slot] != 0) {
+            slot = (slot + 1) & mask;
+        }
+        index_[slot] = static_cast<uint32_t>(position);
+    }
+
+    /**
+     * Make room for one more entry: drop deleted entries if they take at
+     * least half of the table (unless forEach is running, since that would
+     * move entries under it), otherwise grow the index.
+     */
+    void rehash() {
+        if (iterating_ == 0 && deleted_ * 2 >= entries_.size() && deleted_ != 0) {
+            size_t live = 0;
+
+            for (size_t i = 0; i < entries_.size(); ++i) {
+                if (!entries_[i].deleted) {
+                    if (live != i) {
+                        entries_[live] = std::move(entries_[i]);
+                    }
+                    ++live;
+                }
+            }
+            entries_.resize(live);
+            deleted_ = 0;
+        }
+
+        size_t capacity = MIN_CAPACITY;
+        while ((entries_.size() + 1) * 4 > capacity * 3) {
+            capacity *= 2;
+        }
+        if (entries_.size() + 1 > std::numeric_limits<uint32_t>::max()) {
+            throw std::length_error("Too many entries in a hash table");
+        }
+
+        index_.assign(capacity, 0);
+        for (shift_ = 64; (size_t(1) << (64 - shift_)) < capacity; --shift_) {}
+        for (size_t i = 0; i < entries_.size(); ++i) {
+            place(entries_[i].hash, i + 1);
+        }
+    }
+
+    std::deque<Entry> entries_;
+    std::vector<uint32_t> index_;
+    size_t deleted_;
+    unsigned shift_;
+    unsigned iterating_;
+};
+
+} // namespace js4cpp
@@ -0,0 +1,266 @@
+/* Copyright (c) 2012 Kirill Dmitrenko <kdmitrenko@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is furnished
+ * to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * @file parallel.hpp
+ * Helpers shared by parallel algorithms, and parallel variants of %Array
+ * methods. They live here rather than in array.hpp, so that arrays alone
+ * don't pull in threads.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cstdlib>
+#include <iterator>
+#include <thread>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+#include "array.hpp"
+#include "thread_pool.hpp"
+
+namespace js4cpp {
+
+/**
+ * Get number of workers parallel algorithms use when none is given.
+ *
+ * @returns Number of hardware threads (at least one).
+ */
+inline size_t defaultConcurrency() {
+    size_t concurrency = std::thread::hardware_concurrency();
+
+    return concurrency ? concurrency : 1;
+}
+
+/**
+ * Get number of chunks worth splitting given number of items into.
+ *
+ * @param length Number of items.
+ * @param concurrency Desired number of workers, zero means default.
+ * @param minChunk Minimal number of items per chunk.
+ * @returns Number of chunks (at least one).
+ */
+inline size_t chunksFor(size_t length, size_t concurrency, size_t minChunk) {
+    size_t chunks = std::min(concurrency ? concurrency : defaultConcurrency(), length / std::max<size_t>(minChunk, 1));
+
+    return chunks ? chunks : 1;
+}
+
+/**
+ * Split [0, length) into given number of contiguous chunks of nearly equal
+ * size and process them concurrently on the global ThreadPool. Calling
+ * thread processes the first chunk itself. If any chunk throws, the first
+ * exception (by chunk order) is rethrown once all chunks are done.
+ *
+ * @tparam Body Callable as body(chunk, begin, end).
+ * @param length Number of items.
+ * @param chunks Number of chunks.
+ * @param body Chunk processor.
+ */
+template <typename Body>
+void parallelChunks(size_t length, size_t chunks, Body body) {
+    if (chunks == 1) {
+        body(0, 0, length);
+        return;
+    }
+
+    ThreadPool::global().forEachChunk(length, chunks, body);
+}
+
+/**
+ * Implementation of parallel variants of %Array methods. Every algorithm
+ * splits its work into contiguous chunks, runs the same per-range code as
+ * the sequential method on each of them, and merges results in chunks
+ * order, so results equal the sequential ones.
+ *
+ * @tparam T Elements type.
+ */
+template <typename T> class ParallelAlgorithms
+{
+public:
+    /**
+     * Minimal number of indexes per gather chunk.
+     */
+    static const size_t MIN_GATHER_CHUNK = 1 << 14;
+
+    /**
+     * Minimal number of elements per groupBy chunk.
+     */
+    static const size_t MIN_GROUP_CHUNK = 4096;
+
+    template <typename I>
+    static Array<T> gather(const Array<T> & array, const Array<I> & indices, size_t concurrency) {
+        size_t chunks = chunksFor(indices.length(), concurrency, MIN_GATHER_CHUNK);
+
+        if (chunks == 1) {
+            return array.gather(indices);
+        }
+
+        Array<T> result = Array<T>::allocate(indices.length(), std::is_trivial<T>());
+        T * out = result.data_.data();
+
+        parallelChunks(indices.length(), chunks, [&] (size_t, size_t begin, size_t end) {
+            array.gatherRange(indices.begin(), out, begin, end);
+        });
+
+        return result;
+    }
+
+    template <typename KeyFn>
+    static std::unordered_map<typename Array<T>::template GroupKey<KeyFn>::type, Array<T> > groupBy(const Array<T> & array, KeyFn keyFn, size_t concurrency) {
+        typedef typename Array<T>::template GroupKey<KeyFn>::type Key;
+        typedef std::unordered_map<Key, Array<T> > Groups;
+
+        size_t chunks = chunksFor(array.length(), concurrency, MIN_GROUP_CHUNK);
+
+        if (chunks == 1) {
+            return array.groupBy(keyFn);
+        }
+
+        std::vector<Groups> partials(chunks);
+
+        parallelChunks(array.length(), chunks, [&] (size_t chunk, size_t begin, size_t end) {
+            partials[chunk] = array.groupRange(begin, end, keyFn);
+        });
+
+        // Sum every group's size over all partials first, so that each group
+        // is allocated once.
+        std::unordered_map<Key, size_t> sizes(partials[0].size());
+
+        for (size_t chunk = 0; chunk < chunks; ++chunk) {
+            for (auto it = partials[chunk].begin(); it != partials[chunk].end(); ++it) {
+                sizes[it->first] += it->second.data_.size();
+            }
+        }
+
+        Groups result(sizes.size());
+
+        for (auto it = sizes.begin(); it != sizes.end(); ++it) {
+            result[it->first].data_.reserve(it->second);
+        }
+        for (size_t chunk = 0; chunk < chunks; ++chunk) {
+            for (auto it = partials[chunk].begin(); it != partials[chunk].end(); ++it) {
+                typename Array<T>::Storage & group = result[it->first].data_;
+                group.insert(group.end(),
+                    std::make_move_iterator(it->second.data_.begin()),
+                    std::make_move_iterator(it->second.data_.end()));
+            }
+        }
+
+        return result;
+    }
+};
+
+/**
+ * Implementation of parallel variants of packed %Array<bool> methods. Chunks
+ * of gather are made of whole result words, so that no word is written by
+ * two workers.
+ */
+template <> class ParallelAlgorithms<bool>
+{
+public:
+    /**
+     * Minimal number of result words per gather chunk.
+     */
+    static const size_t MIN_GATHER_CHUNK = (1 << 14) / Array<bool>::WORD_BITS;
+
+    /**
+     * Minimal number of elements per groupBy chunk.
+     */
+    static const size_t MIN_GROUP_CHUNK = 4096;
+
+    template <typename I>
+    static Array<bool> gather(const Array<bool> & array, const Array<I> & indices, size_t concurrency) {
+        Array<bool> result(indices.length());
+        size_t chunks = chunksFor(result.words_.size(), concurrency, MIN_GATHER_CHUNK);
+
+        parallelChunks(result.words_.size(), chunks, [&] (size_t, size_t begin, size_t end) {
+            result.gatherWords(array, indices.begin(), begin, end);
+        });
+
+        return result;
+    }
+
+    template <typename KeyFn>
+    static std::unordered_map<typename Array<bool>::GroupKey<KeyFn>::type, Array<bool> > groupBy(const Array<bool> & array, KeyFn keyFn, size_t concurrency) {
+        typedef std::unordered_map<typename Array<bool>::GroupKey<KeyFn>::type, Array<bool> > Groups;
+
+        size_t chunks = chunksFor(array.length(), concurrency, MIN_GROUP_CHUNK);
+
+        if (chunks == 1) {
+            return array.groupBy(keyFn);
+        }
+
+        std::vector<Groups> partials(chunks);
+
+        parallelChunks(array.length(), chunks, [&] (size_t chunk, size_t begin, size_t end) {
+            partials[chunk] = array.groupRange(begin, end, keyFn);
+        });
+
+        Groups result(partials[0].size());
+
+        for (size_t chunk = 0; chunk < chunks; ++chunk) {
+            for (auto it = partials[chunk].begin(); it != partials[chunk].end(); ++it) {
+                result[it->first].append(it->second);
+            }
+        }
+
+        return result;
+    }
+};
+
+/**
+ * Same as Array::gather, but reads contiguous chunks of indexes
+ * concurrently. Worth it only for very large index arrays.
+ *
+ * @tparam T Elements type.
+ * @tparam I Integral index type.
+ * @param array Array to read.
+ * @param indices Indexes to read.
+ * @param concurrency Number of workers, zero means number of hardware threads.
+ * @returns New array of indices' length.
+ * @throws std::out_of_range If some index is out of the array's bounds.
+ */
+template <typename T, typename I>
+Array<T> gatherParallel(const Array<T> & array, const Array<I> & indices, size_t concurrency = 0) {
+    return ParallelAlgorithms<T>::gather(array, indices, concurrency);
+}
+
+/**
+ * Same as Array::groupBy, but groups contiguous chunks of the array
+ * concurrently and merges partial groups afterwards (in chunks order, so
+ * order of elements inside groups is the same as in groupBy). Key function
+ * must be safe to call concurrently.
+ *
+ * @tparam T Elements type.
+ * @tparam KeyFn Key function type.
+ * @param array Array to group.
+ * @param keyFn Function generating key for an element.
+ * @param concurrency Number of workers, zero means number of hardware threads.
+ * @returns Map from keys to groups.
+ */
+template <typename T, typename KeyFn>
+auto groupByParallel(const Array<T> & array, KeyFn keyFn, size_t concurrency = 0) -> decltype(array.groupBy(keyFn)) {
+    return ParallelAlgorithms<T>::groupBy(array, keyFn, concurrency);
+}
+
+} // namespace js4cpp
@@ -0,0 +1,700 @@
+/* Copyright (c) 2012 Kirill Dmitrenko <kdmitrenko@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is furnished
+ * to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * @file promise.hpp
+ * JS-style Promise settled on an EventLoop.
+ */
+
+#pragma once
+
+#include <exception>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+#include "array.hpp"
+#include "event_loop.hpp"
+
+namespace js4cpp {
+
+/**
+ * Value of promises which fulfill with nothing, like JS `undefined`.
+ */
+struct Undefined {};
+
+/**
+ * Error rejecting Promise::any when every promise is rejected.
+ * @see https://developer.mozilla.org/en-US/docs/Web/JavaScript/Reference/Global_Objects/AggregateError
+ */
+class AggregateError : public std::runtime_error
+{
+public:
+    AggregateError(const std::string & message, const Array<std::exception_ptr> & errors) :
+        std::runtime_error(message), errors_(errors) {}
+
+    /**
+     * Get rejection reasons, in order of the promises.
+     */
+    const Array<std::exception_ptr> & errors() const {
+        return errors_;
+    }
+
+private:
+    Array<std::exception_ptr> errors_;
+};
+
+/**
+ * Promise's state.
+ */
+enum PromiseStatus {
+    Pending,
+    Fulfilled,
+    Rejected
+};
+
+/**
+ * Outcome of a promise, as reported by Promise::allSettled.
+ *
+ * @tparam T Value type.
+ */
+template <typename T> struct SettledResult {
+    PromiseStatus status;
+    T value;
+    std::exception_ptr reason;
+};
+
+template <typename T = Undefined> class Promise;
+template <typename T> struct PromiseAwaiter;
+
+/**
+ * Type of promise a handler's result turns into: values are wrapped,
+ * promises are adopted and nothing becomes Undefined.
+ */
+template <typename R> struct PromiseOf {
+    typedef Promise<R> type;
+};
+
+template <> struct PromiseOf<void> {
+    typedef Promise<Undefined> type;
+};
+
+template <typename U> struct PromiseOf<Promise<U> > {
+    typedef Promise<U> type;
+};
+
+/**
+ * Call handler with the argument if it takes one, or without otherwise.
+ */
+template <typename F, typename A>
+auto callHandler(F & f, A & argument, int) -> decltype(f(argument)) {
+    return f(argument);
+}
+
+template <typename F, typename A>
+auto callHandler(F & f, A &, long) -> decltype(f()) {
+    return f();
+}
+
+template <typename F, typename A> struct HandlerResult {
+    typedef decltype(callHandler(std::declval<F &>(), std::declval<A &>(), 0)) type;
+};
+
+/**
+ * JS-style promise: a value which becomes available later, or a reason why
+ * it will not. Reactions to settlement run as microtasks of the EventLoop
+ * of the thread which created the promise, and promises must only be used
+ * on that thread. Handlers take the value (or std::exception_ptr reason) or
+ * nothing; an exception thrown by a handler rejects the derived promise.
+ * @see https://developer.mozilla.org/en-US/docs/Web/JavaScript/Reference/Global_Objects/Promise
+ *
+ * @tparam T Value type.
+ */
+template <typename T> class Promise
+{
+    template <typename U> friend class Promise;
+    template <typename U> friend struct PromiseAwaiter;
+
+    struct State {
+        State() : loop(EventLoop::current()), status(Pending) {}
+
+        ~State() {
+            if (status == Fulfilled) {
+                value()->~T();
+            }
+            while (!reactions.empty()) {
+                loop.release(reactions.shift());
+            }
+        }
+
+        T * value() {
+            return reinterpret_cast<T *>(&storage);
+        }
+
+        EventLoop & loop;
+        PromiseStatus status;
+        typename std::aligned_storage<sizeof(T), std::alignment_of<T>::value>::type storage;
+        std::exception_ptr reason;
+        EventLoop::JobList reactions;
+    };
+
+    typedef std::shared_ptr<State> StatePtr;
+
+    /**
+     * Microtask running reactions of a settled promise.
+     */
+    struct React {
+        React(const StatePtr & state, EventLoop::JobList jobs) : state(state), jobs(jobs) {}
+
+        React(React && other) : state(std::move(other.state)), jobs(other.jobs) {
+            other.jobs = EventLoop::JobList();
+        }
+
+        ~React() {
+            while (!jobs.empty()) {
+                state->loop.release(jobs.shift());
+            }
+        }
+
+        void operator ()() {
+            while (!jobs.empty()) {
+                EventLoop::Job * job = jobs.shift();
+
+                job->call(state.get());
+                state->loop.release(job);
+            }
+        }
+
+        StatePtr state;
+        EventLoop::JobList jobs;
+    };
+
+    template <typename F, typename R> struct Reaction {
+        void operator ()(void * source) {
+            State & state = *static_cast<State *>(source);
+
+            if (state.status == Fulfilled) {
+                onFulfilled(*state.value());
+            } else {
+                onRejected(state.reason);
+            }
+        }
+
+        F onFulfilled;
+        R onRejected;
+    };
+
+    template <typename R> struct Tag {};
+
+public:
+    typedef T value_type;
+
+    /**
+     * Resolves a promise: fulfills it with a value or makes it follow
+     * another promise. Only the first resolution or rejection counts.
+     */
+    class Resolver
+    {
+    public:
+        explicit Resolver(const StatePtr & state) : state_(state) {}
+
+        void operator ()(T value) const {
+            Promise::fulfill(state_, std::move(value));
+        }
+
+        void operator ()(const Promise & other) const {
+            Promise::adopt(state_, other);
+        }
+
+        void operator ()() const {
+            Promise::fulfill(state_, T());
+        }
+
+    private:
+        StatePtr state_;
+    };
+
+    /**
+     * Rejects a promise with an exception or an exception_ptr.
+     */
+    class Rejecter
+    {
+    public:
+        explicit Rejecter(const StatePtr & state) : state_(state) {}
+
+        void operator ()(std::exception_ptr reason) const {
+            Promise::reject(state_, reason);
+        }
+
+        template <typename E>
+        void operator ()(const E & error) const {
+            Promise::reject(state_, std::make_exception_ptr(error));
+        }
+
+    private:
+        StatePtr state_;
+    };
+
+    /**
+     * Promise together with functions settling it.
+     * @see https://developer.mozilla.org/en-US/docs/Web/JavaScript/Reference/Global_Objects/Promise/withResolvers
+     */
+    struct WithResolvers {
+        Promise promise;
+        Resolver resolve;
+        Rejecter reject;
+    };
+
+    /**
+     * Create pending promise which is never settled.
+     */
+    Promise() : state_(std::make_shared<State>()) {}
+
+    /**
+     * Create promise settled by executor(resolve, reject), which is called
+     * right away. Exception thrown by executor rejects the promise.
+     * @see https://developer.mozilla.org/en-US/docs/Web/JavaScript/Reference/Global_Objects/Promise/Promise
+     *
+     * @tparam Executor Callable as executor(Resolver, Rejecter).
+     * @param executor Executor.
+     */
+    template <typename Executor, typename = typename std::enable_if<
+        !std::is_same<typename std::decay<Executor>::type, Promise>::value>::type>
+    explicit Promise(Executor executor) : state_(std::make_shared<State>()) {
+        try {
+            executor(Resolver(state_), Rejecter(state_));
+        } catch (...) {
+            reject(state_, std::current_exception());
+        }
+    }
+
+    /**
+     * Create promise fulfilled with given value.
+     * @see https://developer.mozilla.org/en-US/docs/Web/JavaScript/Reference/Global_Objects/Promise/resolve
+     */
+    static Promise resolve(T value = T()) {
+        Promise result;
+
+        fulfill(result.state_, std::move(value));
+
+        return result;
+    }
+
+    /**
+     * Create promise rejected with given reason.
+     * @see https://developer.mozilla.org/en-US/docs/Web/JavaScript/Reference/Global_Objects/Promise/reject
+     */
+    static Promise reject(std::exception_ptr reason) {
+        Promise result;
+
+        reject(result.state_, reason);
+
+        return result;
+    }
+
+    /**
+     * Create promise rejected with given exception.
+     */
+    template <typename E>
+    static Promise reject(const E & error) {
+        return reject(std::make_exception_ptr(error));
+    }
+
+    /**
+     * Create pending promise and functions settling it.
+     */
+    static WithResolvers withResolvers() {
+        Promise promise;
+        WithResolvers result = {promise, Resolver(promise.state_), Rejecter(promise.state_)};
+
+        return result;
+    }
+
+    /**
+     * Get promise's state.
+     */
+    PromiseStatus status() const {
+        return state_->status;
+    }
+
+    /**
+     * Get value of fulfilled promise.
+     *
+     * @throws std::logic_error If promise is not fulfilled.
+     */
+    const T & value() const {
+        if (state_->status != Fulfilled) {
+            throw std::logic_error("Promise is not fulfilled");
+        }
+
+        return *state_->value();
+    }
+
+    /**
+     * Get reason of rejected promise, null otherwise.
+     */
+    std::exception_ptr reason() const {
+        return state_->reason;
+    }
+
+    /**
+     * Derive promise settled with handler's result once this one is
+     * fulfilled; rejection passes through.
+     * @see https://developer.mozilla.org/en-US/docs/Web/JavaScript/Reference/Global_Objects/Promise/then
+     *
+     * @tparam F Callable as f(value) or f().
+     * @param onFulfilled Handler.
+     * @returns Derived promise.
+     */
+    template <typename F>
+    typename PromiseOf<typename HandlerResult<F, const T>::type>::type then(F onFulfilled) const {
+        typedef typename PromiseOf<typename HandlerResult<F, const T>::type>::type Result;
+
+        Result result;
+        typename Result::StatePtr target = result.state_;
+
+        subscribe([target, onFulfilled] (const T & value) mutable {
+            Result::settle(target, onFulfilled, value);
+        }, [target] (std::exception_ptr reason) {
+            Result::reject(target, reason);
+        });
+
+        return result;
+    }
+
+    /**
+     * Derive promise settled with result of the handler matching the way
+     * this one settles.
+     *
+     * @tparam F Callable as f(value) or f().
+     * @tparam R Callable as r(std::exception_ptr) or r().
+     * @param onFulfilled Fulfillment handler.
+     * @param onRejected Rejection handler, returning the same type.
+     * @returns Derived promise.
+     */
+    template <typename F, typename R>
+    typename PromiseOf<typename HandlerResult<F, const T>::type>::type then(F onFulfilled, R onRejected) const {
+        typedef typename PromiseOf<typename HandlerResult<F, const T>::type>::type Result;
+
+        Result result;
+        typename Result::StatePtr target = result.state_;
+
+        subscribe([target, onFulfilled] (const T & value) mutable {
+            Result::settle(target, onFulfilled, value);
+        }, [target, onRejected] (std::exception_ptr reason) mutable {
+            Result::settle(target, onRejected, reason);
+        });
+
+        return result;
+    }
+
+    /**
+     * Derive promise settled with handler's result once this one is
+     * rejected; value passes through.
+     * @see https://developer.mozilla.org/en-US/docs/Web/JavaScript/Reference/Global_Objects/Promise/catch
+     *
+     * @tparam R Callable as r(std::exception_ptr) or r(), returning T.
+     * @param onRejected Handler.
+     * @returns Derived promise.
+     */
+    template <typename R>
+    Promise catch_(R onRejected) const {
+        Promise result;
+        StatePtr target = result.state_;
+
+        subscribe([target] (const T & value) {
+            fulfill(target, value);
+        }, [target, onRejected] (std::exception_ptr reason) mutable {
+            settle(target, onRejected, reason);
+        });
+
+        return result;
+    }
+
+    /**
+     * Derive promise settled the same way as this one, after calling
+     * handler. Handler's result is ignored, but an exception it throws
+     * rejects the derived promise.
+     * @see https://developer.mozilla.org/en-US/docs/Web/JavaScript/Reference/Global_Objects/Promise/finally
+     *
+     * @tparam F Callable as f().
+     * @param onFinally Handler.
+     * @returns Derived promise.
+     */
+    template <typename F>
+    Promise finally(F onFinally) const {
+        Promise result;
+        StatePtr target = result.state_;
+
+        subscribe([target, onFinally] (const T & value) mutable {
+            try {
+                onFinally();
+                fulfill(target, value);
+            } catch (...) {
+                reject(target, std::current_exception());
+            }
+        }, [target, onFinally] (std::exception_ptr reason) mutable {
+            try {
+                onFinally();
+                reject(target, reason);
+            } catch (...) {
+                reject(target, std::current_exception());
+            }
+        });
+
+        return result;
+    }
+
+    /**
+     * Wait for all promises to be fulfilled, or any to be rejected.
+     * @see https://developer.mozilla.org/en-US/docs/Web/JavaScript/Reference/Global_Objects/Promise/all
+     *
+     * @param promises Promises.
+     * @returns Promise of values, in order of the promises.
+     */
+    static Promise<Array<T> > all(const Array<Promise> & promises) {
+        typedef Promise<Array<T> > Result;
+
+        struct Shared {
+            explicit Shared(size_t length) : values(length), remaining(length) {}
+
+            Array<T> values;
+            size_t remaining;
+        };
+
+        Result result;
+        typename Result::StatePtr target = result.state_;
+        std::shared_ptr<Shared> shared = std::make_shared<Shared>(promises.length());
+
+        if (promises.length() == 0) {
+            Result::fulfill(target, Array<T>());
+        }
+        for (size_t i = 0; i < promises.length(); ++i) {
+            promises.begin()[i].subscribe([target, shared, i] (const T & value) {
+                shared->values[i] = value;
+                if (--shared->remaining == 0) {
+                    Result::fulfill(target, std::move(shared->values));
+                }
+            }, [target] (std::exception_ptr reason) {
+                Result::reject(target, reason);
+            });
+        }
+
+        return result;
+    }
+
+    /**
+     * Wait for all promises to be settled.
+     * @see https://developer.mozilla.org/en-US/docs/Web/JavaScript/Reference/Global_Objects/Promise/allSettled
+     *
+     * @param promises Promises.
+     * @returns Promise of outcomes, in order of the promises; never rejected.
+     */
+    static Promise<Array<SettledResult<T> > > allSettled(const Array<Promise> & promises) {
+        typedef Promise<Array<SettledResult<T> > > Result;
+
+        struct Shared {
+            explicit Shared(size_t length) : results(length), remaining(length) {}
+
+            void settled(const typename Result::StatePtr & target) {
+                if (--remaining == 0) {
+                    Result::fulfill(target, std::move(results));
+                }
+            }
+
+            Array<SettledResult<T> > results;
+            size_t remaining;
+        };
+
+        Result result;
+        typename Result::StatePtr target = result.state_;
+        std::shared_ptr<Shared> shared = std::make_shared<Shared>(promises.length());
+
+        if (promises.length() == 0) {
+            Result::fulfill(target, Array<SettledResult<T> >());
+        }
+        for (size_t i = 0; i < promises.length(); ++i) {
+            promises.begin()[i].subscribe([target, shared, i] (const T & value) {
+                shared->results[i].status = Fulfilled;
+                shared->results[i].value = value;
+                shared->settled(target);
+            }, [target, shared, i] (std::exception_ptr reason) {
+                shared->results[i].status = Rejected;
+                shared->results[i].reason = reason;
+                shared->settled(target);
+            });
+        }
+
+        return result;
+    }
+
+    /**
+     * Settle the same way as the first promise which settles.
+     * @see https://developer.mozilla.org/en-US/docs/Web/JavaScript/Reference/Global_Objects/Promise/race
+     *
+     * @param promises Promises; if empty, result stays pending forever.
+     * @returns Promise.
+     */
+    static Promise race(const Array<Promise> & promises) {
+        Promise result;
+        StatePtr target = result.state_;
+
+        for (size_t i = 0; i < promises.length(); ++i) {
+            promises.begin()[i].subscribe([target] (const T & value) {
+                fulfill(target, value);
+            }, [target] (std::exception_ptr reason) {
+                reject(target, reason);
+            });
+        }
+
+        return result;
+    }
+
+    /**
+     * Fulfill with the first promise fulfilled, or reject with
+     * AggregateError if all are rejected.
+     * @see https://developer.mozilla.org/en-US/docs/Web/JavaScript/Reference/Global_Objects/Promise/any
+     *
+     * @param promises Promises.
+     * @returns Promise.
+     */
+    static Promise any(const Array<Promise> & promises) {
+        struct Shared {
+            explicit Shared(size_t length) : reasons(length), remaining(length) {}
+
+            Array<std::exception_ptr> reasons;
+            size_t remaining;
+        };
+
+        Promise result;
+        StatePtr target = result.state_;
+        std::shared_ptr<Shared> shared = std::make_shared<Shared>(promises.length());
+
+        if (promises.length() == 0) {
+            reject(target, std::make_exception_ptr(AggregateError("All promises were rejected", shared->reasons)));
+        }
+        for (size_t i = 0; i < promises.length(); ++i) {
+            promises.begin()[i].subscribe([target] (const T & value) {
+                fulfill(target, value);
+            }, [target, shared, i] (std::exception_ptr reason) {
+                shared->reasons[i] = reason;
+                if (--shared->remaining == 0) {
+                    reject(target, std::make_exception_ptr(AggregateError("All promises were rejected", shared->reasons)));
+                }
+            });
+        }
+
+        return result;
+    }
+
+private:
+    /**
+     * Call onFulfilled(value) or onRejected(reason) in a microtask once the
+     * promise is settled.
+     */
+    template <typename F, typename R>
+    void subscribe(F onFulfilled, R onRejected) const {
+        Reaction<F, R> reaction = {std::move(onFulfilled), std::move(onRejected)};
+        EventLoop::Job * job = state_->loop.job(std::move(reaction));
+
+        if (state_->status == Pending) {
+            state_->reactions.push(job);
+        } else {
+            EventLoop::JobList jobs;
+
+            jobs.push(job);
+            state_->loop.queueMicrotask(React(state_, jobs));
+        }
+    }
+
+    static void fulfill(const StatePtr & state, T value) {
+        if (state->status != Pending) {
+            return;
+        }
+        ::new (static_cast<void *>(&state->storage)) T(std::move(value));
+        state->status = Fulfilled;
+        react(state);
+    }
+
+    static void reject(const StatePtr & state, std::exception_ptr reason) {
+        if (state->status != Pending) {
+            return;
+        }
+        state->reason = reason;
+        state->status = Rejected;
+        react(state);
+    }
+
+    static void react(const StatePtr & state) {
+        if (!state->reactions.empty()) {
+            EventLoop::JobList jobs = state->reactions;
+
+            state->reactions = EventLoop::JobList();
+            state->loop.queueMicrotask(React(state, jobs));
+        }
+    }
+
+    static void adopt(const StatePtr & state, const Promise & other) {
+        if (other.state_ == state) {
+            reject(state, std::make_exception_ptr(std::logic_error("Promise can't be resolved with itself")));
+            return;
+        }
+        other.subscribe([state] (const T & value) {
+            fulfill(state, value);
+        }, [state] (std::exception_ptr reason) {
+            reject(state, reason);
+        });
+    }
+
+    /**
+     * Settle with handler's result; an exception it throws rejects.
+     */
+    template <typename F, typename A>
+    static void settle(const StatePtr & state, F & handler, A & argument) {
+        try {
+            complete(state, handler, argument, Tag<typename HandlerResult<F, A>::type>());
+        } catch (...) {
+            reject(state, std::current_exception());
+        }
+    }
+
+    template <typename F, typename A, typename R>
+    static void complete(const StatePtr & state, F & handler, A & argument, Tag<R>) {
+        fulfill(state, callHandler(handler, argument, 0));
+    }
+
+    template <typename F, typename A>
+    static void complete(const StatePtr & state, F & handler, A & argument, Tag<void>) {
+        callHandler(handler, argument, 0);
+        fulfill(state, T());
+    }
+
+    template <typename F, typename A>
+    static void complete(const StatePtr & state, F & handler, A & argument, Tag<Promise>) {
+        adopt(state, callHandler(handler, argument, 0));
+    }
+
+    StatePtr state_;
+};
+
+} // namespace js4cpp
@@ -0,0 +1,130 @@
+#pragma once
+
+#include <stdexcept>
+#include <string>
+
+#include <cppunit/TestCaller.h>
+#include <cppunit/TestCase.h>
+#include <cppunit/TestSuite.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+#include "promise.hpp"
+
+class PromiseTest : public CppUnit::TestCase
+{
+public:
+    typedef js4cpp::Promise<int> IntPromise;
+
+    PromiseTest() : CppUnit::TestCase("Promise Test Case") {};
+
+    void testThen() {
+        std::string log;
+
+        IntPromise::resolve(1)
+            .then([&] (int value) { log += "a"; return value + 1; })
+            .then([&] (int value) { return IntPromise::resolve(value * 10); })
+            .then([&] (int value) { log += std::to_string(value); })
+            .then([&] { log += "b"; });
+        log += "sync";
+        CPPUNIT_ASSERT( log == "sync" );
+
+        loop().run();
+        CPPUNIT_ASSERT( log == "synca20b" );
+
+        IntPromise pending([] (IntPromise::Resolver resolve, IntPromise::Rejecter) {
+            js4cpp::EventLoop::current().setTimeout([resolve] { resolve(7); }, 1);
+        });
+        CPPUNIT_ASSERT( pending.status() == js4cpp::Pending );
+        loop().run();
+        CPPUNIT_ASSERT( pending.status() == js4cpp::Fulfilled && pending.value() == 7 );
+    }
+
+    void testRejection() {
+        std::string log;
+
+        IntPromise([] (IntPromise::Resolver, IntPromise::Rejecter) {
+            throw std::runtime_error("executor");
+        }).then([&] (int) {
+            log += "skipped";
+            return 0;
+        }).catch_([&] (std::exception_ptr reason) {
+            try {
+                std::rethrow_exception(reason);
+            } catch (const std::runtime_error & error) {
+                log += error.what();
+            }
+            return 5;
+        }).finally([&] {
+            log += ",finally";
+        }).then([&] (int value) {
+            log += "," + std::to_string(value);
+            throw std::out_of_range("handler");
+        }).then([] {}, [&] (std::exception_ptr reason) {
+            log += reason ? ",handler" : "";
+        });
+
+        IntPromise rejected = IntPromise::reject(std::invalid_argument("reason"));
+        loop().run();
+        CPPUNIT_ASSERT( log == "executor,finally,5,handler" );
+        CPPUNIT_ASSERT( rejected.status() == js4cpp::Rejected && rejected.reason() );
+
+        bool thrown = false;
+        try {
+            rejected.value();
+        } catch (const std::logic_error &) {
+            thrown = true;
+        }
+        CPPUNIT_ASSERT( thrown );
+    }
+
+    void testCombinators() {
+        IntPromise::WithResolvers first = IntPromise::withResolvers(), second = IntPromise::withResolvers();
+        js4cpp::Array<IntPromise> promises = js4cpp::Array<IntPromise>::of(first.promise, second.promise, IntPromise::resolve(3));
+
+        js4cpp::Promise<js4cpp::Array<int> > all = IntPromise::all(promises);
+        js4cpp::Promise<js4cpp::Array<js4cpp::SettledResult<int> > > settled = IntPromise::allSettled(promises);
+        IntPromise race = IntPromise::race(promises), any = IntPromise::any(promises);
+
+        second.reject(std::runtime_error("second"));
+        first.resolve(1);
+        loop().run();
+
+        CPPUNIT_ASSERT( all.status() == js4cpp::Rejected );
+        CPPUNIT_ASSERT( settled.value().length() == 3 && settled.value().begin()[0].value == 1 );
+        CPPUNIT_ASSERT( settled.value().begin()[1].status == js4cpp::Rejected );
+        CPPUNIT_ASSERT( race.value() == 3 && any.value() == 3 );
+
+        js4cpp::Array<IntPromise> fulfilled = js4cpp::Array<IntPromise>::of(IntPromise::resolve(1), IntPromise::resolve(2));
+        js4cpp::Promise<js4cpp::Array<int> > values = IntPromise::all(fulfilled);
+        IntPromise none = IntPromise::any(js4cpp::Array<IntPromise>::of(IntPromise::reject(std::runtime_error("x"))));
+        loop().run();
+
+        CPPUNIT_ASSERT( values.value().join() == "1,2" );
+
+        bool aggregated = false;
+        try {
+            std::rethrow_exception(none.reason());
+        } catch (const js4cpp::AggregateError & error) {
+            aggregated = error.errors().length() == 1;
+        }
+        CPPUNIT_ASSERT( aggregated );
+        CPPUNIT_ASSERT( IntPromise::all(js4cpp::Array<IntPromise>()).status() == js4cpp::Fulfilled );
+    }
+
+    void setUp() {}
+
+    void tearDown() {}
+
+    CPPUNIT_TEST_SUITE( PromiseTest );
+
+        CPPUNIT_TEST( testThen );
+        CPPUNIT_TEST( testRejection );
+        CPPUNIT_TEST( testCombinators );
+
+    CPPUNIT_TEST_SUITE_END();
+
+private:
+    static js4cpp::EventLoop & loop() {
+        return js4cpp::EventLoop::current();
+    }
+};
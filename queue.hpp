@@ -0,0 +1,599 @@
+/* Copyright (c) 2012 Kirill Dmitrenko <kdmitrenko@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is furnished
+ * to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * @file queue.hpp
+ * Lock-free multi-producer multi-consumer queues with Array-style
+ * push/shift interface.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+#include "array.hpp"
+
+namespace js4cpp {
+
+/**
+ * Size of cache line queue indexes are padded to, so that producers and
+ * consumers do not invalidate each other's cache lines.
+ */
+static const size_t CACHE_LINE = 64;
+
+/**
+ * Atomic counter occupying a cache line of its own.
+ */
+struct PaddedCounter {
+    std::atomic<size_t> value;
+    char padding[CACHE_LINE - sizeof(std::atomic<size_t>)];
+
+    explicit PaddedCounter(size_t initial = 0) : value(initial) {}
+};
+
+/**
+ * Bounded lock-free multi-producer multi-consumer queue (Dmitry Vyukov's
+ * algorithm). Every cell carries a sequence number telling whether it is
+ * ready to be written or read in the current lap, so push and shift cost
+ * one CAS on their index each.
+ *
+ * @tparam T Elements type.
+ */
+template <typename T> class BoundedQueue
+{
+    static_assert(std::is_nothrow_move_constructible<T>::value, "Elements must be nothrow move constructible");
+
+    struct Cell {
+        std::atomic<size_t> sequence;
+        typename std::aligned_storage<sizeof(T), std::alignment_of<T>::value>::type storage;
+
+        T * element() {
+            return reinterpret_cast<T *>(&storage);
+        }
+    };
+
+public:
+    /**
+     * Create empty queue.
+     *
+     * @param capacity Maximal number of elements, rounded up to a power of two.
+     */
+    explicit BoundedQueue(size_t capacity) : mask_(roundUp(capacity) - 1), cells_(new Cell[mask_ + 1]) {
+        for (size_t i = 0; i <= mask_; ++i) {
+            cells_[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    ~BoundedQueue() {
+        size_t end = enqueue_.value.load(std::memory_order_relaxed);
+
+        for (size_t position = dequeue_.value.load(std::memory_order_relaxed); position != end; ++position) {
+            cells_[position & mask_].element()->~T();
+        }
+        delete [] cells_;
+    }
+
+    BoundedQueue(const BoundedQueue &) = delete;
+    BoundedQueue & operator =(const BoundedQueue &) = delete;
+
+    /**
+     * Get maximal number of elements.
+     */
+    size_t capacity() const {
+        return mask_ + 1;
+    }
+
+    /**
+     * Get number of elements. Under concurrent pushes and shifts the result
+     * is only approximate.
+     *
+     * @returns Length.
+     */
+    size_t length() const {
+        size_t shifted = dequeue_.value.load(std::memory_order_acquire);
+        size_t pushed = enqueue_.value.load(std::memory_order_acquire);
+
+        return pushed > shifted ? pushed - shifted : 0;
+    }
+
+    /**
+     * Add an element to the end of the queue. Unless T can be constructed
+     * from value without throwing, the element is constructed before a cell
+     * is claimed and then moved in, since a claimed cell which is never
+     * filled would block the queue for good.
+     * @see https://developer.mozilla.org/en-US/docs/Web/JavaScript/Reference/Global_Objects/Array/push
+     *
+     * @param value Element.
+     * @returns Whether element was added, i.e. the queue was not full.
+     * @throws Whatever T's constructor throws; the queue is left unchanged.
+     */
+    template <typename U>
+    bool push(U && value) {
+        return pushConstructed(std::forward<U>(value), std::is_nothrow_constructible<T, U &&>());
+    }
+
+    /**
+     * Remove the first element of the queue.
+     * @see https://developer.mozilla.org/en-US/docs/Web/JavaScript/Reference/Global_Objects/Array/shift
+     *
+     * @param element Where to move the element to.
+     * @returns Whether element was removed, i.e. the queue was not empty.
+     */
+    bool shift(T & element) {
+        size_t position = dequeue_.value.load(std::memory_order_relaxed);
+
+        for (;;) {
+            Cell & cell = cells_[position & mask_];
+            size_t sequence = cell.sequence.load(std::memory_order_acquire);
+            ptrdiff_t lag = ptrdiff_t(sequence) - ptrdiff_t(position + 1);
+
+            if (lag == 0) {
+                if (dequeue_.value.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                    element = std::move(*cell.element());
+                    cell.element()->~T();
+                    cell.sequence.store(position + mask_ + 1, std::memory_order_release);
+                    return true;
+                }
+            } else if (lag < 0) {
+                return false;
+            } else {
+                position = dequeue_.value.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    /**
+     * Add elements to the end of the queue, until it is full.
+     *
+     * @tparam Iterable Iterable of elements.
+     * @param elements Elements.
+     * @returns Number of added elements.
+     */
+    template <typename Iterable>
+    size_t pushAll(const Iterable & elements) {
+        size_t count = 0;
+
+        for (auto it = elements.begin(); it != elements.end() && push(*it); ++it) {
+            ++count;
+        }
+
+        return count;
+    }
+
+    /**
+     * Remove up to given number of elements from the beginning of the queue.
+     *
+     * @param count Maximal number of elements.
+     * @returns Array of removed elements.
+     */
+    Array<T> shiftMany(size_t count) {
+        Array<T> result;
+        T element;
+
+        while (result.length() < count && shift(element)) {
+            result.push(std::move(element));
+        }
+
+        return result;
+    }
+
+private:
+    template <typename U>
+    bool pushConstructed(U && value, std::false_type) {
+        T element(std::forward<U>(value));
+
+        return pushConstructed(std::move(element), std::true_type());
+    }
+
+    template <typename U>
+    bool pushConstructed(U && value, std::true_type) {
+        size_t position = enqueue_.value.load(std::memory_order_relaxed);
+
+        for (;;) {
+            Cell & cell = cells_[position & mask_];
+            size_t sequence = cell.sequence.load(std::memory_order_acquire);
+            ptrdiff_t lag = ptrdiff_t(sequence) - ptrdiff_t(position);
+
+            if (lag == 0) {
+                if (enqueue_.value.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                    ::new (static_cast<void *>(&cell.storage)) T(std::forward<U>(value));
+                    cell.sequence.store(position + 1, std::memory_order_release);
+                    return true;
+                }
+            } else if (lag < 0) {
+                return false;
+            } else {
+                position = enqueue_.value.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    static size_t roundUp(size_t capacity) {
+        size_t result = 2;
+
+        while (result < capacity) {
+            result <<= 1;
+        }
+
+        return result;
+    }
+
+    PaddedCounter enqueue_;
+    PaddedCounter dequeue_;
+    const size_t mask_;
+    Cell * cells_;
+};
+
+/**
+ * Unbounded lock-free multi-producer multi-consumer queue. Elements are
+ * stored in a linked list of fixed-size segments; within a segment push and
+ * shift claim slots with a single fetch_add each, and a slot a consumer
+ * gave up on is just skipped by its producer.
+ *
+ * Segments which consumers are done with are retired and freed with
+ * epoch-based reclamation: every operation is counted in the counter of the
+ * epoch it started in, and the epoch advances once the operations of the
+ * one before it are finished. Segments retired two epochs ago cannot be
+ * seen by any operation in progress, so they are freed even under
+ * continuous load.
+ *
+ * @tparam T Elements type.
+ */
+template <typename T> class Queue
+{
+    enum {
+        SEGMENT_LENGTH = 1024
+    };
+
+    enum {
+        EMPTY,
+        WRITTEN,
+        TAKEN
+    };
+
+    struct Slot {
+        std::atomic<unsigned char> state;
+        typename std::aligned_storage<sizeof(T), std::alignment_of<T>::value>::type storage;
+
+        T * element() {
+            return reinterpret_cast<T *>(&storage);
+        }
+    };
+
+    struct Segment {
+        PaddedCounter enqueue;
+        PaddedCounter dequeue;
+        std::atomic<Segment *> next;
+        Segment * retired;
+        Slot slots[SEGMENT_LENGTH];
+
+        Segment() : next(0), retired(0) {
+            for (size_t i = 0; i < SEGMENT_LENGTH; ++i) {
+                slots[i].state.store(EMPTY, std::memory_order_relaxed);
+            }
+        }
+    };
+
+    /**
+     * Marks an operation in progress, so that segments it may look at are
+     * not freed under it.
+     */
+    class Guard
+    {
+    public:
+        explicit Guard(const Queue & queue) : queue_(queue), epoch_(queue.enter()) {}
+
+        ~Guard() {
+            queue_.leave(epoch_);
+        }
+
+    private:
+        const Queue & queue_;
+        size_t epoch_;
+    };
+
+    /**
+     * Retired segments by epoch parity, on a cache line of their own: they
+     * are read by every operation but written only once per segment.
+     */
+    struct Limbo {
+        std::atomic<Segment *> segments[2];
+        std::atomic<bool> reclaiming;
+        char padding[CACHE_LINE - 2 * sizeof(std::atomic<Segment *>) - sizeof(std::atomic<bool>)];
+
+        Limbo() : reclaiming(false) {
+            segments[0].store(0);
+            segments[1].store(0);
+        }
+    };
+
+public:
+    /**
+     * Create empty queue.
+     */
+    Queue() {
+        Segment * segment = new Segment();
+
+        head_.store(segment);
+        tail_.store(segment);
+    }
+
+    ~Queue() {
+        for (Segment * segment = head_.load(); segment;) {
+            Segment * next = segment->next.load();
+            size_t end = std::min<size_t>(segment->enqueue.value.load(), SEGMENT_LENGTH);
+
+            for (size_t i = segment->dequeue.value.load(); i < end; ++i) {
+                if (segment->slots[i].state.load() == WRITTEN) {
+                    segment->slots[i].element()->~T();
+                }
+            }
+            delete segment;
+            segment = next;
+        }
+        release(limbo_.segments[0].load());
+        release(limbo_.segments[1].load());
+    }
+
+    Queue(const Queue &) = delete;
+    Queue & operator =(const Queue &) = delete;
+
+    /**
+     * Get number of elements. Under concurrent pushes and shifts the result
+     * is only approximate.
+     *
+     * @returns Length.
+     */
+    size_t length() const {
+        Guard guard(*this);
+        size_t length = 0;
+
+        for (Segment * segment = head_.load(); segment; segment = segment->next.load()) {
+            size_t pushed = std::min<size_t>(segment->enqueue.value.load(), SEGMENT_LENGTH);
+            size_t shifted = std::min<size_t>(segment->dequeue.value.load(), SEGMENT_LENGTH);
+
+            length += pushed > shifted ? pushed - shifted : 0;
+        }
+
+        return length;
+    }
+
+    /**
+     * Add an element to the end of the queue.
+     * @see https://developer.mozilla.org/en-US/docs/Web/JavaScript/Reference/Global_Objects/Array/push
+     *
+     * @param value Element.
+     */
+    void push(T value) {
+        Guard guard(*this);
+
+        pushGuarded(value);
+    }
+
+    /**
+     * Remove the first element of the queue.
+     * @see https://developer.mozilla.org/en-US/docs/Web/JavaScript/Reference/Global_Objects/Array/shift
+     *
+     * @param element Where to move the element to.
+     * @returns Whether element was removed, i.e. the queue was not empty.
+     */
+    bool shift(T & element) {
+        Guard guard(*this);
+
+        return shiftGuarded(element);
+    }
+
+    /**
+     * Add elements to the end of the queue.
+     *
+     * @tparam Iterable Iterable of elements.
+     * @param elements Elements.
+     * @returns Number of added elements.
+     */
+    template <typename Iterable>
+    size_t pushAll(const Iterable & elements) {
+        Guard guard(*this);
+        size_t count = 0;
+
+        for (auto it = elements.begin(); it != elements.end(); ++it, ++count) {
+            T value = *it;
+            pushGuarded(value);
+        }
+
+        return count;
+    }
+
+    /**
+     * Remove up to given number of elements from the beginning of the queue.
+     *
+     * @param count Maximal number of elements.
+     * @returns Array of removed elements.
+     */
+    Array<T> shiftMany(size_t count) {
+        Guard guard(*this);
+        Array<T> result;
+        T element;
+
+        while (result.length() < count && shiftGuarded(element)) {
+            result.push(std::move(element));
+        }
+
+        return result;
+    }
+
+private:
+    void pushGuarded(T & value) {
+        for (;;) {
+            Segment * segment = tail_.load();
+            size_t index = segment->enqueue.value.fetch_add(1);
+
+            if (index >= SEGMENT_LENGTH) {
+                append(segment);
+                continue;
+            }
+
+            Slot & slot = segment->slots[index];
+            unsigned char expected = EMPTY;
+
+            ::new (static_cast<void *>(&slot.storage)) T(std::move(value));
+            if (slot.state.compare_exchange_strong(expected, WRITTEN)) {
+                return;
+            }
+            // A consumer has given up on the slot already: take the element
+            // back and try the next one.
+            value = std::move(*slot.element());
+            slot.element()->~T();
+        }
+    }
+
+    bool shiftGuarded(T & element) {
+        for (;;) {
+            Segment * segment = head_.load();
+
+            if (segment->dequeue.value.load() >= segment->enqueue.value.load() && !segment->next.load()) {
+                return false;
+            }
+
+            size_t index = segment->dequeue.value.fetch_add(1);
+
+            if (index >= SEGMENT_LENGTH) {
+                Segment * next = segment->next.load();
+
+                if (!next) {
+                    return false;
+                }
+                // Tail must move past the segment before it is retired, so
+                // that operations starting later cannot reach it.
+                Segment * tail = segment;
+                tail_.compare_exchange_strong(tail, next);
+                if (head_.compare_exchange_strong(segment, next)) {
+                    retire(segment);
+                }
+                continue;
+            }
+
+            Slot & slot = segment->slots[index];
+
+            if (slot.state.exchange(TAKEN) == WRITTEN) {
+                element = std::move(*slot.element());
+                slot.element()->~T();
+                return true;
+            }
+        }
+    }
+
+    void append(Segment * segment) {
+        Segment * next = segment->next.load();
+
+        if (!next) {
+            Segment * fresh = new Segment();
+
+            if (segment->next.compare_exchange_strong(next, fresh)) {
+                next = fresh;
+            } else {
+                delete fresh;
+            }
+        }
+        tail_.compare_exchange_strong(segment, next);
+    }
+
+    /**
+     * Count an operation in the current epoch.
+     *
+     * @returns Epoch.
+     */
+    size_t enter() const {
+        for (;;) {
+            size_t epoch = epoch_.value.load();
+
+            active_[epoch & 1].value.fetch_add(1);
+            // Epoch may have advanced before the operation was counted, and
+            // the reclaimer may have seen its counter drained already.
+            if (epoch_.value.load() == epoch) {
+                return epoch;
+            }
+            active_[epoch & 1].value.fetch_sub(1);
+        }
+    }
+
+    /**
+     * Add unlinked segment to the list of the current epoch.
+     */
+    void retire(Segment * segment) const {
+        std::atomic<Segment *> & list = limbo_.segments[epoch_.value.load() & 1];
+
+        segment->retired = list.load();
+        while (!list.compare_exchange_weak(segment->retired, segment)) {}
+    }
+
+    void leave(size_t epoch) const {
+        active_[epoch & 1].value.fetch_sub(1);
+        if (limbo_.segments[0].load() || limbo_.segments[1].load()) {
+            reclaim();
+        }
+    }
+
+    /**
+     * Advance epoch from E to E + 1 if operations of E - 1 are finished, and
+     * free segments retired in E - 1: they were unlinked before E started,
+     * so only operations of E - 1 and earlier could see them. One thread
+     * reclaims at a time; others just skip it.
+     */
+    void reclaim() const {
+        if (limbo_.reclaiming.exchange(true)) {
+            return;
+        }
+
+        size_t epoch = epoch_.value.load();
+        Segment * released = 0;
+
+        if (active_[(epoch + 1) & 1].value.load() == 0) {
+            // The list is taken before the epoch advances, since segments
+            // retired in E + 1 go to the same list.
+            released = limbo_.segments[(epoch + 1) & 1].exchange(0);
+            epoch_.value.store(epoch + 1);
+        }
+        limbo_.reclaiming.store(false);
+        release(released);
+    }
+
+    static void release(Segment * segment) {
+        while (segment) {
+            Segment * next = segment->retired;
+            delete segment;
+            segment = next;
+        }
+    }
+
+    std::atomic<Segment *> head_;
+    char headPadding_[CACHE_LINE - sizeof(std::atomic<Segment *>)];
+    std::atomic<Segment *> tail_;
+    char tailPadding_[CACHE_LINE - sizeof(std::atomic<Segment *>)];
+    mutable PaddedCounter epoch_;
+    mutable PaddedCounter active_[2];
+    mutable Limbo limbo_;
+};
+
+} // namespace js4cpp
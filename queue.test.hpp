@@ -0,0 +1,136 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <cppunit/TestCaller.h>
+#include <cppunit/TestCase.h>
+#include <cppunit/TestSuite.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+#include "queue.hpp"
+
+class QueueTest : public CppUnit::TestCase
+{
+public:
+    QueueTest() : CppUnit::TestCase("Queue Test Case") {};
+
+    void testBoundedQueue() {
+        js4cpp::BoundedQueue<std::string> queue(3);
+        std::string element;
+
+        CPPUNIT_ASSERT( queue.capacity() == 4 && queue.length() == 0 && !queue.shift(element) );
+        CPPUNIT_ASSERT( queue.push("a") && queue.push("b") );
+        CPPUNIT_ASSERT( queue.pushAll(js4cpp::Array<std::string>::of("c", "d", "e")) == 2 );
+        CPPUNIT_ASSERT( queue.length() == 4 && !queue.push("f") );
+        CPPUNIT_ASSERT( queue.shift(element) && element == "a" );
+        CPPUNIT_ASSERT( queue.shiftMany(2).join() == "b,c" && queue.length() == 1 );
+        CPPUNIT_ASSERT( queue.push("g") && queue.shiftMany(10).join() == "d,g" );
+    }
+
+    void testBoundedQueueThrowingElement() {
+        // Copies throw when asked to, like a std::string copy running out of memory.
+        struct Fragile {
+            int value;
+            bool fragile;
+
+            Fragile(int value = 0, bool fragile = false) : value(value), fragile(fragile) {}
+            Fragile(const Fragile & other) : value(other.value), fragile(other.fragile) {
+                if (fragile) {
+                    throw std::runtime_error("Copy failed");
+                }
+            }
+            Fragile(Fragile && other) noexcept : value(other.value), fragile(other.fragile) {}
+            Fragile & operator =(Fragile && other) noexcept {
+                value = other.value;
+                fragile = other.fragile;
+                return *this;
+            }
+        };
+
+        js4cpp::BoundedQueue<Fragile> queue(2);
+        Fragile broken(1, true), element;
+        bool thrown = false;
+
+        try {
+            queue.push(broken);
+        } catch (const std::runtime_error &) {
+            thrown = true;
+        }
+        CPPUNIT_ASSERT( thrown && queue.length() == 0 && !queue.shift(element) );
+
+        // The queue keeps working across a few wraps.
+        for (int i = 0; i < 5; ++i) {
+            CPPUNIT_ASSERT( queue.push(Fragile(i)) && queue.push(Fragile(i + 10)) && !queue.push(Fragile()) );
+            CPPUNIT_ASSERT( queue.shift(element) && element.value == i && queue.shift(element) && element.value == i + 10 );
+        }
+    }
+
+    void testQueue() {
+        js4cpp::Queue<std::string> queue;
+        std::string element;
+
+        CPPUNIT_ASSERT( queue.length() == 0 && !queue.shift(element) );
+        for (int i = 0; i < 3000; ++i) {
+            queue.push(std::to_string(i));
+        }
+        CPPUNIT_ASSERT( queue.length() == 3000 );
+        CPPUNIT_ASSERT( queue.shift(element) && element == "0" );
+        CPPUNIT_ASSERT( queue.shiftMany(2000).length() == 2000 && queue.length() == 999 );
+        CPPUNIT_ASSERT( queue.shift(element) && element == "2001" );
+        CPPUNIT_ASSERT( queue.pushAll(js4cpp::Array<std::string>::of("x", "y")) == 2 && queue.length() == 1000 );
+    }
+
+    void testConcurrency() {
+        const int producers = 4, count = 50000;
+        js4cpp::Queue<int> queue;
+        js4cpp::BoundedQueue<int> bounded(256);
+        std::vector<char> seen(producers * count * 2);
+        std::vector<std::thread> threads;
+        std::atomic<int> consumed(0);
+
+        for (int p = 0; p < producers; ++p) {
+            threads.push_back(std::thread([&, p] {
+                for (int i = 0; i < count; ++i) {
+                    queue.push(p * count + i);
+                    while (!bounded.push(producers * count + p * count + i)) {
+                        std::this_thread::yield();
+                    }
+                }
+            }));
+            threads.push_back(std::thread([&] {
+                int element;
+
+                while (consumed.load() < producers * count * 2) {
+                    if (queue.shift(element) || bounded.shift(element)) {
+                        seen[element] = 1;
+                        ++consumed;
+                    }
+                }
+            }));
+        }
+        for (size_t t = 0; t < threads.size(); ++t) {
+            threads[t].join();
+        }
+
+        CPPUNIT_ASSERT( std::count(seen.begin(), seen.end(), 1) == producers * count * 2 );
+        CPPUNIT_ASSERT( queue.length() == 0 && bounded.length() == 0 );
+    }
+
+    void setUp() {}
+
+    void tearDown() {}
+
+    CPPUNIT_TEST_SUITE( QueueTest );
+
+        CPPUNIT_TEST( testBoundedQueue );
+        CPPUNIT_TEST( testBoundedQueueThrowingElement );
+        CPPUNIT_TEST( testQueue );
+        CPPUNIT_TEST( testConcurrency );
+
+    CPPUNIT_TEST_SUITE_END();
+};
@@ -0,0 +1,433 @@
+/* Copyright (c) 2012 Kirill Dmitrenko <kdmitrenko@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is furnished
+ * to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * @file serialization.hpp
+ * Compact binary format for js4cpp::Array.
+ *
+ * Every serialized array is a record: 32 byte header followed by payload.
+ *
+ * | Offset | Size | Field                                             |
+ * |--------|------|---------------------------------------------------|
+ * | 0      | 4    | Magic "JS4A"                                      |
+ * | 4      | 2    | Format version (1)                                |
+ * | 6      | 1    | Payload kind: 0 - packed elements, 1 - offsets    |
+ * | 7      | 1    | Flags: bit 0 is set when numbers are little-endian|
+ * | 8      | 2    | Element size for packed payload, 0 otherwise      |
+ * | 10     | 2    | Element type: 1 - signed integer, 2 - unsigned    |
+ * |        |      | integer, 3 - floating point, 4 - string, 5 - array|
+ * |        |      | 16 and up - types registered with BinaryType      |
+ * | 12     | 4    | Adler-32 checksum of the payload                  |
+ * | 16     | 8    | Number of elements                                |
+ * | 24     | 8    | Payload size in bytes                             |
+ *
+ * Packed payload is just the elements' bytes, so trivially copyable
+ * elements are written and read with a single memcpy and can be viewed in
+ * place. Arithmetic elements are supported out of the box; other trivially
+ * copyable types must specialize BinaryType with a code of their own, so
+ * that records of different types of the same size are never mixed up.
+ * Array<bool> is packed into bits and can't be serialized directly. Offsets payload (strings, nested arrays) starts with length + 1
+ * 64-bit offsets of elements' blobs relative to the end of the table,
+ * followed by the blobs: raw bytes of strings or nested records padded to
+ * 8 bytes. Numbers are stored in host byte order; records written on a host
+ * with different byte order are rejected.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+
+#include "array.hpp"
+#include "array_buffer.hpp"
+#include "array_view.hpp"
+
+namespace js4cpp {
+
+/**
+ * Error thrown when a record is malformed or does not match requested type.
+ */
+class BinaryFormatError : public std::runtime_error
+{
+public:
+    explicit BinaryFormatError(const std::string & message) : std::runtime_error(message) {}
+};
+
+/**
+ * Compute Adler-32 checksum.
+ *
+ * @param data Bytes.
+ * @param size Number of bytes.
+ * @returns Checksum.
+ */
+inline uint32_t adler32(const unsigned char * data, size_t size) {
+    const uint32_t modulo = 65521;
+    // Largest n such that 255 * n * (n + 1) / 2 + (n + 1) * (modulo - 1) fits 32 bits.
+    const size_t block = 5552;
+    uint32_t a = 1, b = 0;
+
+    while (size != 0) {
+        size_t n = size < block ? size : block;
+
+        size -= n;
+        for (; n != 0; --n) {
+            a += *data++;
+            b += a;
+        }
+        a %= modulo;
+        b %= modulo;
+    }
+
+    return (b << 16) | a;
+}
+
+/**
+ * Header of a serialized array record.
+ */
+struct BinaryHeader {
+    enum Kind {
+        Packed = 0,
+        Offsets = 1
+    };
+
+    static const size_t SIZE = 32;
+    static const uint16_t VERSION = 1;
+
+    /**
+     * First element type code available to types registered with BinaryType.
+     */
+    static const uint16_t FIRST_USER_TYPE = 16;
+
+    char magic[4];
+    uint16_t version;
+    uint8_t kind;
+    uint8_t flags;
+    uint16_t elementSize;
+    uint16_t elementType;
+    uint32_t checksum;
+    uint64_t length;
+    uint64_t payloadSize;
+
+    static BinaryHeader make(Kind kind, size_t elementSize, uint16_t elementType, size_t length, size_t payloadSize) {
+        BinaryHeader header;
+
+        std::memcpy(header.magic, "JS4A", 4);
+        header.version = VERSION;
+        header.kind = kind;
+        header.flags = nativeFlags();
+        header.elementSize = elementSize;
+        header.elementType = elementType;
+        header.checksum = 0;
+        header.length = length;
+        header.payloadSize = payloadSize;
+
+        return header;
+    }
+
+    /**
+     * Read and validate header of a record.
+     *
+     * @throws BinaryFormatError If header is malformed or does not match expected kind.
+     */
+    static BinaryHeader read(const unsigned char * data, size_t size, Kind kind, size_t elementSize, uint16_t elementType) {
+        BinaryHeader header;
+
+        if (size < SIZE) {
+            throw BinaryFormatError("Record is truncated");
+        }
+        std::memcpy(&header, data, SIZE);
+
+        if (std::memcmp(header.magic, "JS4A", 4) != 0) {
+            throw BinaryFormatError("Not a js4cpp record");
+        }
+        if (header.version != VERSION) {
+            throw BinaryFormatError("Unsupported record version");
+        }
+        if (header.flags != nativeFlags()) {
+            throw BinaryFormatError("Record was written with different byte order");
+        }
+        if (header.kind != kind || header.elementSize != elementSize || header.elementType != elementType) {
+            throw BinaryFormatError("Record holds elements of different type");
+        }
+        if (header.payloadSize > size - SIZE) {
+            throw BinaryFormatError("Record is truncated");
+        }
+
+        return header;
+    }
+
+    void verify(const unsigned char * data) const {
+        if (adler32(data + SIZE, payloadSize) != checksum) {
+            throw BinaryFormatError("Record checksum mismatch");
+        }
+    }
+
+    static uint8_t nativeFlags() {
+        const uint16_t probe = 1;
+        return *reinterpret_cast<const unsigned char *>(&probe);
+    }
+};
+
+static_assert(sizeof(BinaryHeader) == BinaryHeader::SIZE, "Unexpected BinaryHeader layout");
+
+/**
+ * Type code written to records of packed elements of type T. Arithmetic
+ * types have codes of their own; other trivially copyable types must
+ * specialize it, e.g.
+ *
+ *     template <> struct BinaryType<Point> {
+ *         static const uint16_t code = BinaryHeader::FIRST_USER_TYPE + 0;
+ *     };
+ *
+ * @tparam T Elements type.
+ */
+template <typename T, typename Enable = void> struct BinaryType {
+    static_assert(sizeof(T) == 0, "Specialize js4cpp::BinaryType to serialize non-arithmetic elements");
+};
+
+template <typename T> struct BinaryType<T, typename std::enable_if<std::is_arithmetic<T>::value>::type> {
+    static const uint16_t code = std::is_floating_point<T>::value ? 3 : std::is_signed<T>::value ? 1 : 2;
+};
+
+/**
+ * How elements of type T are serialized. Trivially copyable elements are
+ * packed; std::string and nested Arrays go to an offsets table.
+ */
+template <typename T, typename Enable = void> struct BinaryElement;
+
+template <typename T> struct BinaryElement<T, typename std::enable_if<std::is_trivially_copyable<T>::value>::type> {
+    static const bool packed = true;
+};
+
+template <> struct BinaryElement<std::string> {
+    static const bool packed = false;
+    static const uint16_t type = 4;
+
+    static size_t size(const std::string & value) {
+        return value.size();
+    }
+
+    static void write(unsigned char * out, const std::string & value) {
+        std::memcpy(out, value.data(), value.size());
+    }
+
+    static std::string read(const unsigned char * in, size_t size) {
+        return std::string(reinterpret_cast<const char *>(in), size);
+    }
+};
+
+template <typename T> struct BinaryArray;
+
+template <typename T> struct BinaryElement<Array<T> > {
+    static const bool packed = false;
+    static const uint16_t type = 5;
+
+    static size_t size(const Array<T> & value) {
+        // Keep nested records 8 byte aligned.
+        return (BinaryArray<T>::size(value) + 7) & ~size_t(7);
+    }
+
+    static void write(unsigned char * out, const Array<T> & value) {
+        size_t written = BinaryArray<T>::size(value);
+
+        BinaryArray<T>::write(out, value);
+        std::memset(out + written, 0, size(value) - written);
+    }
+
+    static Array<T> read(const unsigned char * in, size_t size) {
+        return BinaryArray<T>::read(in, size, false);
+    }
+};
+
+/**
+ * Serializer of arrays of given type into records.
+ *
+ * @tparam T Elements type.
+ */
+template <typename T> struct BinaryArray {
+    static_assert(!std::is_same<T, bool>::value, "Array<bool> is packed into bits, serialize Array<uint8_t> instead");
+
+    typedef std::integral_constant<bool, BinaryElement<T>::packed> Packed;
+
+    static size_t size(const Array<T> & array) {
+        return BinaryHeader::SIZE + payloadSize(array, Packed());
+    }
+
+    static void write(unsigned char * out, const Array<T> & array) {
+        BinaryHeader header = writePayload(out + BinaryHeader::SIZE, array, Packed());
+
+        header.checksum = adler32(out + BinaryHeader::SIZE, header.payloadSize);
+        std::memcpy(out, &header, BinaryHeader::SIZE);
+    }
+
+    static Array<T> read(const unsigned char * in, size_t size, bool verify) {
+        return readPayload(in, size, verify, Packed());
+    }
+
+private:
+    static size_t payloadSize(const Array<T> & array, std::true_type) {
+        return array.length() * sizeof(T);
+    }
+
+    static size_t payloadSize(const Array<T> & array, std::false_type) {
+        size_t total = (array.length() + 1) * sizeof(uint64_t);
+
+        for (const T & item : array) {
+            total += BinaryElement<T>::size(item);
+        }
+
+        return total;
+    }
+
+    static BinaryHeader writePayload(unsigned char * out, const Array<T> & array, std::true_type) {
+        if (array.length() != 0) {
+            std::memcpy(out, array.begin(), array.length() * sizeof(T));
+        }
+
+        return BinaryHeader::make(BinaryHeader::Packed, sizeof(T), BinaryType<T>::code, array.length(), array.length() * sizeof(T));
+    }
+
+    static BinaryHeader writePayload(unsigned char * out, const Array<T> & array, std::false_type) {
+        unsigned char * blobs = out + (array.length() + 1) * sizeof(uint64_t);
+        uint64_t offset = 0;
+
+        for (size_t i = 0; i < array.length(); ++i) {
+            const T & item = array.begin()[i];
+
+            std::memcpy(out + i * sizeof(uint64_t), &offset, sizeof(offset));
+            BinaryElement<T>::write(blobs + offset, item);
+            offset += BinaryElement<T>::size(item);
+        }
+        std::memcpy(out + array.length() * sizeof(uint64_t), &offset, sizeof(offset));
+
+        return BinaryHeader::make(BinaryHeader::Offsets, 0, BinaryElement<T>::type, array.length(), blobs + offset - out);
+    }
+
+    static Array<T> readPayload(const unsigned char * in, size_t size, bool verify, std::true_type) {
+        ArrayView<T> view = BinaryArray<T>::view(in, size, verify);
+
+        return Array<T>(view.begin(), view.end());
+    }
+
+    static Array<T> readPayload(const unsigned char * in, size_t size, bool verify, std::false_type) {
+        BinaryHeader header = BinaryHeader::read(in, size, BinaryHeader::Offsets, 0, BinaryElement<T>::type);
+        const unsigned char * payload = in + BinaryHeader::SIZE;
+
+        if (header.length >= header.payloadSize / sizeof(uint64_t)) {
+            throw BinaryFormatError("Record offsets table is truncated");
+        }
+        if (verify) {
+            header.verify(in);
+        }
+
+        const unsigned char * blobs = payload + (header.length + 1) * sizeof(uint64_t);
+        size_t blobsSize = header.payloadSize - (header.length + 1) * sizeof(uint64_t);
+        uint64_t begin, end;
+
+        std::memcpy(&begin, payload, sizeof(begin));
+
+        return Array<T>::from(header.length, [&] (size_t i) {
+            std::memcpy(&end, payload + (i + 1) * sizeof(uint64_t), sizeof(end));
+            if (begin > end || end > blobsSize) {
+                throw BinaryFormatError("Record offsets table is malformed");
+            }
+
+            T item = BinaryElement<T>::read(blobs + begin, end - begin);
+            begin = end;
+            return item;
+        });
+    }
+
+public:
+    static ArrayView<T> view(const unsigned char * in, size_t size, bool verify) {
+        BinaryHeader header = BinaryHeader::read(in, size, BinaryHeader::Packed, sizeof(T), BinaryType<T>::code);
+
+        if (header.length != header.payloadSize / sizeof(T) || header.payloadSize % sizeof(T) != 0) {
+            throw BinaryFormatError("Record length does not match its payload");
+        }
+        if (verify) {
+            header.verify(in);
+        }
+
+        const unsigned char * payload = in + BinaryHeader::SIZE;
+
+        if (reinterpret_cast<uintptr_t>(payload) % alignof(T) != 0) {
+            throw BinaryFormatError("Record payload is misaligned for the element type");
+        }
+
+        return ArrayView<T>(reinterpret_cast<const T *>(payload), header.length);
+    }
+};
+
+/**
+ * Serialize array into a new buffer allocated once with the exact size.
+ *
+ * @param array Array of trivially copyable elements, strings or nested arrays.
+ * @returns Buffer holding the record.
+ */
+template <typename T>
+ArrayBuffer serialize(const Array<T> & array) {
+    ArrayBuffer buffer(BinaryArray<T>::size(array));
+
+    BinaryArray<T>::write(buffer.data(), array);
+
+    return buffer;
+}
+
+/**
+ * Deserialize array from a record.
+ *
+ * @tparam T Elements type the record was written with.
+ * @param data Record.
+ * @param size Size of the record (or of any larger buffer it starts).
+ * @returns New array.
+ * @throws BinaryFormatError If record is malformed or holds different type.
+ */
+template <typename T>
+Array<T> deserialize(const void * data, size_t size) {
+    return BinaryArray<T>::read(static_cast<const unsigned char *>(data), size, true);
+}
+
+template <typename T>
+Array<T> deserialize(const ArrayBuffer & buffer) {
+    return deserialize<T>(buffer.data(), buffer.byteLength());
+}
+
+/**
+ * View packed elements of a record in place, e.g. right in a memory mapped
+ * file, without copying them. The view is valid as long as the record is.
+ *
+ * @tparam T Trivially copyable elements type the record was written with.
+ * @param data Record; its payload must be suitably aligned for T.
+ * @param size Size of the record.
+ * @returns View.
+ * @throws BinaryFormatError If record is malformed, misaligned or holds different type.
+ */
+template <typename T>
+ArrayView<T> deserializeView(const void * data, size_t size) {
+    static_assert(BinaryElement<T>::packed, "Only packed records can be viewed in place");
+
+    return BinaryArray<T>::view(static_cast<const unsigned char *>(data), size, true);
+}
+
+} // namespace js4cpp
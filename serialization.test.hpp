@@ -0,0 +1,103 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+#include <cppunit/TestCaller.h>
+#include <cppunit/TestCase.h>
+#include <cppunit/TestSuite.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+#include "serialization.hpp"
+
+class SerializationTest : public CppUnit::TestCase
+{
+public:
+    SerializationTest() : CppUnit::TestCase("Serialization Test Case") {};
+
+    void testAdler32() {
+        const char text[] = "Wikipedia";
+        CPPUNIT_ASSERT( js4cpp::adler32(reinterpret_cast<const unsigned char *>(text), 9) == 0x11E60398 );
+    }
+
+    void testPacked() {
+        using js4cpp::Array;
+
+        Array<double> numbers = Array<double>::from(100, [] (size_t i) { return i * 1.5; });
+        js4cpp::ArrayBuffer record = js4cpp::serialize(numbers);
+
+        CPPUNIT_ASSERT( record.byteLength() == js4cpp::BinaryHeader::SIZE + 800 );
+
+        Array<double> copy = js4cpp::deserialize<double>(record);
+        CPPUNIT_ASSERT( copy.length() == 100 && copy[99] == 148.5 );
+
+        js4cpp::ArrayView<double> view = js4cpp::deserializeView<double>(record.data(), record.byteLength());
+        CPPUNIT_ASSERT( view.length() == 100 && view[2] == 3 );
+        CPPUNIT_ASSERT( reinterpret_cast<const unsigned char *>(view.data()) == record.data() + js4cpp::BinaryHeader::SIZE );
+    }
+
+    void testStrings() {
+        using js4cpp::Array;
+
+        Array<std::string> strings = Array<std::string>::of("js", "", "4cpp");
+        Array<std::string> copy = js4cpp::deserialize<std::string>(js4cpp::serialize(strings));
+
+        CPPUNIT_ASSERT( copy.length() == 3 && copy[0] == "js" && copy[1] == "" && copy[2] == "4cpp" );
+    }
+
+    void testNested() {
+        using js4cpp::Array;
+
+        Array<Array<int32_t> > nested = Array<Array<int32_t> >::of(
+            Array<int32_t>::of(1, 2, 3), Array<int32_t>(), Array<int32_t>::of(4));
+        Array<Array<int32_t> > copy = js4cpp::deserialize<Array<int32_t> >(js4cpp::serialize(nested));
+
+        CPPUNIT_ASSERT( copy.length() == 3 );
+        CPPUNIT_ASSERT( copy[0].length() == 3 && copy[0][2] == 3 );
+        CPPUNIT_ASSERT( copy[1].length() == 0 && copy[2][0] == 4 );
+
+        Array<Array<std::string> > strings = Array<Array<std::string> >::of(Array<std::string>::of("a", "bc"));
+        CPPUNIT_ASSERT( js4cpp::deserialize<Array<std::string> >(js4cpp::serialize(strings))[0][1] == "bc" );
+
+        js4cpp::ArrayBuffer record = js4cpp::serialize(Array<std::string>::of("a"));
+        CPPUNIT_ASSERT( throws<Array<char> >(record.data(), record.byteLength()) );
+    }
+
+    void testErrors() {
+        js4cpp::ArrayBuffer record = js4cpp::serialize(js4cpp::Array<int32_t>::of(1, 2, 3));
+
+        CPPUNIT_ASSERT( throws<float>(record.data(), record.byteLength()) );
+        CPPUNIT_ASSERT( throws<uint32_t>(record.data(), record.byteLength()) );
+        CPPUNIT_ASSERT( record.data()[10] == js4cpp::BinaryType<int32_t>::code );
+        CPPUNIT_ASSERT( throws<std::string>(record.data(), record.byteLength()) );
+        CPPUNIT_ASSERT( throws<int32_t>(record.data(), record.byteLength() - 1) );
+
+        record.data()[js4cpp::BinaryHeader::SIZE] ^= 1;
+        CPPUNIT_ASSERT( throws<int32_t>(record.data(), record.byteLength()) );
+
+        record.data()[0] = 'X';
+        CPPUNIT_ASSERT( throws<int32_t>(record.data(), record.byteLength()) );
+    }
+
+    CPPUNIT_TEST_SUITE( SerializationTest );
+
+        CPPUNIT_TEST( testAdler32 );
+        CPPUNIT_TEST( testPacked );
+        CPPUNIT_TEST( testStrings );
+        CPPUNIT_TEST( testNested );
+        CPPUNIT_TEST( testErrors );
+
+    CPPUNIT_TEST_SUITE_END();
+
+private:
+    template <typename T>
+    static bool throws(const unsigned char * data, size_t size) {
+        try {
+            js4cpp::deserialize<T>(data, size);
+        } catch (const js4cpp::BinaryFormatError &) {
+            return true;
+        }
+
+        return false;
+    }
+};
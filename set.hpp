@@ -0,0 +1,301 @@
+/* Copyright (c) 2012 Kirill Dmitrenko <kdmitrenko@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is furnished
+ * to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * @file set.hpp
+ * JS-style Set.
+ */
+
+#pragma once
+
+#include <utility>
+
+#include "array.hpp"
+#include "ordered_table.hpp"
+
+namespace js4cpp {
+
+/**
+ * JS-style set: values are compared with SameValueZero and iterated in
+ * insertion order.
+ * @see https://developer.mozilla.org/en-US/docs/Web/JavaScript/Reference/Global_Objects/Set
+ *
+ * @tparam T Values type.
+ */
+template <typename T> class Set
+{
+    struct KeyOf {
+        const T & operator ()(const T & value) const {
+            return value;
+        }
+    };
+
+    typedef OrderedTable<T, KeyOf> Table;
+
+public:
+    typedef typename Table::const_iterator iterator;
+    typedef typename Table::const_iterator const_iterator;
+    typedef T value_type;
+
+    /**
+     * Create empty set.
+     */
+    Set() {}
+
+    /**
+     * Create set of array's distinct values, in order of first occurrence.
+     * @see https://developer.mozilla.org/en-US/docs/Web/JavaScript/Reference/Global_Objects/Set/Set
+     *
+     * @param values Values.
+     */
+    explicit Set(const Array<T> & values) {
+        for (const T & value : values) {
+            add(value);
+        }
+    }
+
+    /**
+     * Get number of values.
+     * @see https://developer.mozilla.org/en-US/docs/Web/JavaScript/Reference/Global_Objects/Set/size
+     *
+     * @returns Size.
+     */
+    size_t size() const {
+        return table_.size();
+    }
+
+    /**
+     * Check whether set has a value.
+     * @see https://developer.mozilla.org/en-US/docs/Web/JavaScript/Reference/Global_Objects/Set/has
+     *
+     * @param value Value.
+     * @returns True if it has.
+     */
+    bool has(const T & value) const {
+        return table_.find(value) != 0;
+    }
+
+    /**
+     * Add value unless it is already there.
+     * @see https://developer.mozilla.org/en-US/docs/Web/JavaScript/Reference/Global_Objects/Set/add
+     *
+     * @param value Value.
+     * @returns Set itself.
+     */
+    Set & add(const T & value) {
+        table_.insert(value, value);
+        return *this;
+    }
+
+    /**
+     * Remove value (`delete` in JS, which is reserved in C++).
+     * @see https://developer.mozilla.org/en-US/docs/Web/JavaScript/Reference/Global_Objects/Set/delete
+     *
+     * @param value Value.
+     * @returns True if there was such value.
+     */
+    bool remove(const T & value) {
+        return table_.remove(value);
+    }
+
+    /**
+     * Remove all values.
+     * @see https://developer.mozilla.org/en-US/docs/Web/JavaScript/Reference/Global_Objects/Set/clear
+     */
+    void clear() {
+        table_.clear();
+    }
+
+    /**
+     * Execute a function for each value in insertion order.
+     * @see https://developer.mozilla.org/en-US/docs/Web/JavaScript/Reference/Global_Objects/Set/forEach
+     *
+     * @param callback Function called as callback(value, value, set), taking as many arguments as it needs.
+     */
+    template <typename F>
+    void forEach(F callback) {
+        table_.forEach([&] (T & value) {
+            const T & item = value;
+            invokeCallback(callback, item, item, *this);
+        });
+    }
+
+    /**
+     * Get set of values in this set, then those only in the other one
+     * (`union` is reserved in C++).
+     * @see https://developer.mozilla.org/en-US/docs/Web/JavaScript/Reference/Global_Objects/Set/union
+     *
+     * @param other Other set.
+     * @returns New set.
+     */
+    Set unionWith(const Set & other) const {
+        Set result = *this;
+
+        for (const T & value : other) {
+            result.add(value);
+        }
+
+        return result;
+    }
+
+    /**
+     * Get set of values in both sets. Like in JS, the smaller set is
+     * iterated, so the result follows its order.
+     * @see https://developer.mozilla.org/en-US/docs/Web/JavaScript/Reference/Global_Objects/Set/intersection
+     *
+     * @param other Other set.
+     * @returns New set.
+     */
+    Set intersection(const Set & other) const {
+        const Set & smaller = size() <= other.size() ? *this : other;
+        const Set & larger = size() <= other.size() ? other : *this;
+        Set result;
+
+        for (const T & value : smaller) {
+            if (larger.has(value)) {
+                result.add(value);
+            }
+        }
+
+        return result;
+    }
+
+    /**
+     * Get set of values in this set but not in the other one.
+     * @see https://developer.mozilla.org/en-US/docs/Web/JavaScript/Reference/Global_Objects/Set/difference
+     *
+     * @param other Other set.
+     * @returns New set.
+     */
+    Set difference(const Set & other) const {
+        Set result;
+
+        for (const T & value : *this) {
+            if (!other.has(value)) {
+                result.add(value);
+            }
+        }
+
+        return result;
+    }
+
+    /**
+     * Get set of values in exactly one of the sets.
+     * @see https://developer.mozilla.org/en-US/docs/Web/JavaScript/Reference/Global_Objects/Set/symmetricDifference
+     *
+     * @param other Other set.
+     * @returns New set.
+     */
+    Set symmetricDifference(const Set & other) const {
+        Set result = difference(other);
+
+        for (const T & value : other) {
+            if (!has(value)) {
+                result.add(value);
+            }
+        }
+
+        return result;
+    }
+
+    /**
+     * Check whether all values are in the other set.
+     * @see https://developer.mozilla.org/en-US/docs/Web/JavaScript/Reference/Global_Objects/Set/isSubsetOf
+     */
+    bool isSubsetOf(const Set & other) const {
+        if (size() > other.size()) {
+            return false;
+        }
+
+        for (const T & value : *this) {
+            if (!other.has(value)) {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    /**
+     * Check whether all values of the other set are in this one.
+     * @see https://developer.mozilla.org/en-US/docs/Web/JavaScript/Reference/Global_Objects/Set/isSupersetOf
+     */
+    bool isSupersetOf(const Set & other) const {
+        return other.isSubsetOf(*this);
+    }
+
+    /**
+     * Check whether sets have no values in common.
+     * @see https://developer.mozilla.org/en-US/docs/Web/JavaScript/Reference/Global_Objects/Set/isDisjointFrom
+     */
+    bool isDisjointFrom(const Set & other) const {
+        const Set & smaller = size() <= other.size() ? *this : other;
+        const Set & larger = size() <= other.size() ? other : *this;
+
+        for (const T & value : smaller) {
+            if (larger.has(value)) {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    /**
+     * Get values in insertion order.
+     * @see https://developer.mozilla.org/en-US/docs/Web/JavaScript/Reference/Global_Objects/Set/values
+     *
+     * @returns Array of values.
+     */
+    Array<T> values() const {
+        return Array<T>::from(*this);
+    }
+
+    /**
+     * Same as values(), like in JS.
+     * @see https://developer.mozilla.org/en-US/docs/Web/JavaScript/Reference/Global_Objects/Set/keys
+     */
+    Array<T> keys() const {
+        return values();
+    }
+
+    /**
+     * Get [value, value] pairs in insertion order.
+     * @see https://developer.mozilla.org/en-US/docs/Web/JavaScript/Reference/Global_Objects/Set/entries
+     *
+     * @returns Array of pairs.
+     */
+    Array<std::pair<T, T> > entries() const {
+        return Array<std::pair<T, T> >::from(*this, [] (const T & value) { return std::make_pair(value, value); });
+    }
+
+    const_iterator begin() const {
+        return table_.begin();
+    }
+
+    const_iterator end() const {
+        return table_.end();
+    }
+
+private:
+    Table table_;
+};
+
+} // namespace js4cpp
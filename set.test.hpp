@@ -0,0 +1,106 @@
+#pragma once
+
+#include <cmath>
+#include <string>
+
+#include <cppunit/TestCaller.h>
+#include <cppunit/TestCase.h>
+#include <cppunit/TestSuite.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+#include "set.hpp"
+
+class SetTest : public CppUnit::TestCase
+{
+public:
+    SetTest() : CppUnit::TestCase("Set Test Case") {};
+
+    void testAddHas() {
+        using js4cpp::Array;
+        using js4cpp::Set;
+
+        Set<int> set(Array<int>::of(3, 1, 3, 2, 1));
+        CPPUNIT_ASSERT( set.size() == 3 && set.values().join() == "3,1,2" );
+        CPPUNIT_ASSERT( set.has(2) && !set.has(4) );
+
+        set.add(4).add(3);
+        CPPUNIT_ASSERT( set.size() == 4 && set.keys().join() == "3,1,2,4" );
+        CPPUNIT_ASSERT( set.entries()[3].first == 4 && set.entries()[3].second == 4 );
+    }
+
+    void testRemove() {
+        using js4cpp::Set;
+
+        Set<std::string> set;
+        set.add("a").add("b").add("c");
+        CPPUNIT_ASSERT( set.remove("a") && !set.remove("a") && set.values().join() == "b,c" );
+
+        for (int i = 0; i < 1000; ++i) {
+            set.add(std::to_string(i));
+            set.remove(std::to_string(i - 1));
+        }
+        CPPUNIT_ASSERT( set.size() == 3 && set.values().join() == "b,c,999" );
+
+        set.clear();
+        CPPUNIT_ASSERT( set.size() == 0 && set.values().length() == 0 );
+    }
+
+    void testNaN() {
+        using js4cpp::Array;
+        using js4cpp::Set;
+
+        Set<double> set(Array<double>::of(NAN, -NAN, 0.0, -0.0, 1.0));
+        CPPUNIT_ASSERT( set.size() == 3 && set.has(NAN) && set.has(-0.0) );
+    }
+
+    void testForEach() {
+        using js4cpp::Array;
+        using js4cpp::Set;
+
+        Set<int> set(Array<int>::of(1, 2, 3));
+        int sum = 0;
+        set.forEach([&] (int value, int key, Set<int> & self) {
+            sum += value + key;
+            if (value == 1) {
+                self.remove(2);
+                self.add(10);
+            }
+        });
+        CPPUNIT_ASSERT( sum == 28 );
+
+        int count = 0;
+        for (int value : set) {
+            count += value;
+        }
+        CPPUNIT_ASSERT( count == 14 );
+    }
+
+    void testSetMethods() {
+        using js4cpp::Array;
+        using js4cpp::Set;
+
+        Set<int> odds(Array<int>::of(1, 3, 5, 7, 9)), primes(Array<int>::of(2, 3, 5, 7));
+        CPPUNIT_ASSERT( odds.unionWith(primes).values().join() == "1,3,5,7,9,2" );
+        CPPUNIT_ASSERT( odds.intersection(primes).values().join() == "3,5,7" );
+        CPPUNIT_ASSERT( primes.intersection(odds).values().join() == "3,5,7" );
+        CPPUNIT_ASSERT( odds.difference(primes).values().join() == "1,9" );
+        CPPUNIT_ASSERT( odds.symmetricDifference(primes).values().join() == "1,9,2" );
+
+        Set<int> small(Array<int>::of(3, 5));
+        CPPUNIT_ASSERT( small.isSubsetOf(odds) && small.isSubsetOf(primes) && !odds.isSubsetOf(small) );
+        CPPUNIT_ASSERT( odds.isSupersetOf(small) && !small.isSupersetOf(odds) );
+        CPPUNIT_ASSERT( !odds.isDisjointFrom(primes) && Set<int>(Array<int>::of(2, 4)).isDisjointFrom(odds) );
+    }
+
+    void setUp() {}
+
+    void tearDown() {}
+
+    CPPUNIT_TEST_SUITE( SetTest );
+    CPPUNIT_TEST( testAddHas );
+    CPPUNIT_TEST( testRemove );
+    CPPUNIT_TEST( testNaN );
+    CPPUNIT_TEST( testForEach );
+    CPPUNIT_TEST( testSetMethods );
+    CPPUNIT_TEST_SUITE_END();
+};
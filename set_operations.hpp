@@ -0,0 +1,387 @@
+/* Copyright (c) 2012 Kirill Dmitrenko <kdmitrenko@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is furnished
+ * to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * @file set_operations.hpp
+ * Set operations on Arrays.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include "array.hpp"
+#include "ordered_table.hpp"
+#include "parallel.hpp"
+
+namespace js4cpp {
+
+/**
+ * Whether `<` is a strict total order consistent with SameValueZero for T,
+ * which allows sorted inputs to be merged instead of hashed. Floating point
+ * types are excluded because of NaN. Specialize for other types.
+ */
+template <typename T, typename Enable = void> struct IsStrictlyOrdered : std::false_type {};
+
+template <typename T> struct IsStrictlyOrdered<T, typename std::enable_if<std::is_integral<T>::value>::type> : std::true_type {};
+
+template <> struct IsStrictlyOrdered<std::string> : std::true_type {};
+
+/**
+ * Implementation of set operations between two Arrays. Every operation
+ * keeps distinct elements of `a`, then distinct elements of `b`, according
+ * to whether they are found in the other array:
+ *
+ * | Operation           | In both | Only in a | Only in b |
+ * |---------------------|---------|-----------|-----------|
+ * | intersection        | yes     |           |           |
+ * | difference          |         | yes       |           |
+ * | unionOf             | yes     | yes       | yes       |
+ * | symmetricDifference |         | yes       | yes       |
+ *
+ * Strategy depends on inputs: if both are sorted (and T is strictly
+ * ordered) they are merged in one pass, galloping through the longer one
+ * when lengths differ by more than GALLOP_RATIO; otherwise b is hashed
+ * (O(a + b) instead of O(a * b) of `filter` with `indexOf`).
+ *
+ * @tparam T Elements type.
+ */
+template <typename T> class SetOperations
+{
+public:
+    /**
+     * Length ratio from which intersection and difference gallop.
+     */
+    static const size_t GALLOP_RATIO = 32;
+
+    /**
+     * Minimal number of elements of `a` per parallel chunk.
+     */
+    static const size_t MIN_PARALLEL_CHUNK = 1 << 14;
+
+    static Array<T> run(const Array<T> & a, const Array<T> & b, bool common, bool onlyA, bool onlyB) {
+        if (bothSorted(a, b, IsStrictlyOrdered<T>())) {
+            return merge(a.begin(), a.end(), b.begin(), b.end(), common, onlyA, onlyB);
+        }
+
+        return hash(a, b, common, onlyA, onlyB);
+    }
+
+    /**
+     * Parallel version for operations which keep only elements of a.
+     */
+    static Array<T> runParallel(const Array<T> & a, const Array<T> & b, bool common, bool onlyA, size_t concurrency) {
+        size_t chunks = chunksFor(a.length(), concurrency, MIN_PARALLEL_CHUNK);
+
+        if (chunks == 1) {
+            return run(a, b, common, onlyA, false);
+        }
+        if (bothSorted(a, b, IsStrictlyOrdered<T>())) {
+            return mergeParallel(a, b, common, onlyA, chunks, IsStrictlyOrdered<T>());
+        }
+
+        return hashParallel(a, b, common, onlyA, chunks);
+    }
+
+private:
+    struct Identity {
+        const T & operator ()(const T & value) const {
+            return value;
+        }
+    };
+
+    typedef OrderedTable<T, Identity> Table;
+
+    static bool bothSorted(const Array<T> & a, const Array<T> & b, std::true_type) {
+        return std::is_sorted(a.begin(), a.end()) && std::is_sorted(b.begin(), b.end());
+    }
+
+    static bool bothSorted(const Array<T> &, const Array<T> &, std::false_type) {
+        return false;
+    }
+
+    /**
+     * Find first element not less than value, doubling the step from the
+     * start first, so that finding a near element costs O(log distance).
+     */
+    static const T * gallop(const T * begin, const T * end, const T & value) {
+        size_t step = 1;
+
+        while (step < size_t(end - begin) && begin[step - 1] < value) {
+            begin += step;
+            step *= 2;
+        }
+
+        return std::lower_bound(begin, std::min(begin + step, end), value);
+    }
+
+    static Array<T> merge(const T * a, const T * aEnd, const T * b, const T * bEnd, bool common, bool onlyA, bool onlyB) {
+        Array<T> result;
+        size_t aLength = aEnd - a, bLength = bEnd - b;
+
+        if (!onlyB && bLength >= aLength * GALLOP_RATIO) {
+            for (; a != aEnd; ++a) {
+                if (a + 1 != aEnd && a[1] == *a) {
+                    continue;
+                }
+                b = gallop(b, bEnd, *a);
+                if ((b != bEnd && *b == *a) ? common : onlyA) {
+                    result.push(*a);
+                }
+            }
+
+            return result;
+        }
+        if (common && !onlyA && !onlyB && aLength >= bLength * GALLOP_RATIO) {
+            for (; b != bEnd; ++b) {
+                if (b + 1 != bEnd && b[1] == *b) {
+                    continue;
+                }
+                a = gallop(a, aEnd, *b);
+                if (a != aEnd && *a == *b) {
+                    result.push(*b);
+                }
+            }
+
+            return result;
+        }
+
+        while (a != aEnd || b != bEnd) {
+            const T * next;
+            bool keep;
+
+            if (b == bEnd || (a != aEnd && *a < *b)) {
+                next = a;
+                keep = onlyA;
+            } else if (a == aEnd || *b < *a) {
+                next = b;
+                keep = onlyB;
+            } else {
+                next = a;
+                keep = common;
+            }
+
+            const T & value = *next;
+            if (keep) {
+                result.push(value);
+            }
+            while (a != aEnd && *a == value) {
+                ++a;
+            }
+            while (b != bEnd && *b == value) {
+                ++b;
+            }
+        }
+
+        return result;
+    }
+
+    static Array<T> hash(const Array<T> & a, const Array<T> & b, bool common, bool onlyA, bool onlyB) {
+        Table inB, seen;
+        Array<T> result;
+
+        for (const T & value : b) {
+            inB.insert(value, value);
+        }
+        for (const T & value : a) {
+            if (seen.insert(value, value).second && (inB.find(value) ? common : onlyA)) {
+                result.push(value);
+            }
+        }
+        if (onlyB) {
+            for (const T & value : b) {
+                if (seen.insert(value, value).second) {
+                    result.push(value);
+                }
+            }
+        }
+
+        return result;
+    }
+
+    /**
+     * Merge chunks of a with matching ranges of b concurrently. Chunk
+     * boundaries are moved past runs of equal elements, so every value is
+     * handled by exactly one chunk.
+     */
+    static Array<T> mergeParallel(const Array<T> & a, const Array<T> & b, bool common, bool onlyA, size_t chunks, std::true_type) {
+        std::vector<Array<T> > parts(chunks);
+        const T * data = a.begin();
+        size_t length = a.length();
+
+        parallelChunks(length, chunks, [&] (size_t chunk, size_t begin, size_t end) {
+            while (begin != 0 && begin < length && data[begin] == data[begin - 1]) {
+                ++begin;
+            }
+            while (end < length && data[end] == data[end - 1]) {
+                ++end;
+            }
+            if (begin >= end) {
+                return;
+            }
+
+            const T * bBegin = std::lower_bound(b.begin(), b.end(), data[begin]);
+            const T * bEnd = end < length ? std::lower_bound(bBegin, b.end(), data[end]) : b.end();
+
+            parts[chunk] = merge(data + begin, data + end, bBegin, bEnd, common, onlyA, false);
+        });
+
+        return concat(parts);
+    }
+
+    static Array<T> mergeParallel(const Array<T> &, const Array<T> &, bool, bool, size_t, std::false_type) {
+        return Array<T>();
+    }
+
+    /**
+     * Probe chunks of a against hashed b concurrently (lookups only read
+     * the table), then drop repeated elements in a sequential pass.
+     */
+    static Array<T> hashParallel(const Array<T> & a, const Array<T> & b, bool common, bool onlyA, size_t chunks) {
+        std::vector<Array<T> > parts(chunks);
+        const T * data = a.begin();
+        Table inB, seen;
+        Array<T> result;
+
+        for (const T & value : b) {
+            inB.insert(value, value);
+        }
+
+        parallelChunks(a.length(), chunks, [&] (size_t chunk, size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i) {
+                if (inB.find(data[i]) ? common : onlyA) {
+                    parts[chunk].push(data[i]);
+                }
+            }
+        });
+
+        for (size_t chunk = 0; chunk < chunks; ++chunk) {
+            for (const T & value : parts[chunk]) {
+                if (seen.insert(value, value).second) {
+                    result.push(value);
+                }
+            }
+        }
+
+        return result;
+    }
+
+    static Array<T> concat(std::vector<Array<T> > & parts) {
+        size_t total = 0;
+
+        for (size_t i = 0; i < parts.size(); ++i) {
+            total += parts[i].length();
+        }
+
+        Array<T> result(total);
+        T * out = result.begin();
+
+        for (size_t i = 0; i < parts.size(); ++i) {
+            out = std::move(parts[i].begin(), parts[i].end(), out);
+        }
+
+        return result;
+    }
+};
+
+/**
+ * Get distinct elements of a which are also in b, in a's order.
+ * @see https://developer.mozilla.org/en-US/docs/Web/JavaScript/Reference/Global_Objects/Set/intersection
+ *
+ * @param a First array.
+ * @param b Second array.
+ * @returns Intersection.
+ */
+template <typename T>
+Array<T> intersection(const Array<T> & a, const Array<T> & b) {
+    return SetOperations<T>::run(a, b, true, false, false);
+}
+
+/**
+ * Get distinct elements of a which are not in b, in a's order.
+ * @see https://developer.mozilla.org/en-US/docs/Web/JavaScript/Reference/Global_Objects/Set/difference
+ *
+ * @param a First array.
+ * @param b Second array.
+ * @returns Difference.
+ */
+template <typename T>
+Array<T> difference(const Array<T> & a, const Array<T> & b) {
+    return SetOperations<T>::run(a, b, false, true, false);
+}
+
+/**
+ * Get distinct elements of a, then those of b which are not in a (`union`
+ * is reserved in C++). Sorted inputs give a sorted result.
+ * @see https://developer.mozilla.org/en-US/docs/Web/JavaScript/Reference/Global_Objects/Set/union
+ *
+ * @param a First array.
+ * @param b Second array.
+ * @returns Union.
+ */
+template <typename T>
+Array<T> unionOf(const Array<T> & a, const Array<T> & b) {
+    return SetOperations<T>::run(a, b, true, true, true);
+}
+
+/**
+ * Get distinct elements which are in exactly one of the arrays: those of a
+ * first, then those of b. Sorted inputs give a sorted result.
+ * @see https://developer.mozilla.org/en-US/docs/Web/JavaScript/Reference/Global_Objects/Set/symmetricDifference
+ *
+ * @param a First array.
+ * @param b Second array.
+ * @returns Symmetric difference.
+ */
+template <typename T>
+Array<T> symmetricDifference(const Array<T> & a, const Array<T> & b) {
+    return SetOperations<T>::run(a, b, false, true, true);
+}
+
+/**
+ * Same as intersection(), processing chunks of a concurrently.
+ *
+ * @param a First array.
+ * @param b Second array.
+ * @param concurrency Maximal number of threads, zero means hardware concurrency.
+ * @returns Intersection.
+ */
+template <typename T>
+Array<T> intersectionParallel(const Array<T> & a, const Array<T> & b, size_t concurrency = 0) {
+    return SetOperations<T>::runParallel(a, b, true, false, concurrency);
+}
+
+/**
+ * Same as difference(), processing chunks of a concurrently.
+ *
+ * @param a First array.
+ * @param b Second array.
+ * @param concurrency Maximal number of threads, zero means hardware concurrency.
+ * @returns Difference.
+ */
+template <typename T>
+Array<T> differenceParallel(const Array<T> & a, const Array<T> & b, size_t concurrency = 0) {
+    return SetOperations<T>::runParallel(a, b, false, true, concurrency);
+}
+
+} // namespace js4cpp
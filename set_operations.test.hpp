@@ -0,0 +1,91 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <string>
+
+#include <cppunit/TestCaller.h>
+#include <cppunit/TestCase.h>
+#include <cppunit/TestSuite.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+#include "set_operations.hpp"
+
+class SetOperationsTest : public CppUnit::TestCase
+{
+public:
+    SetOperationsTest() : CppUnit::TestCase("Set Operations Test Case") {};
+
+    void testUnsorted() {
+        using js4cpp::Array;
+
+        Array<int> a = Array<int>::of(5, 1, 3, 1, 7), b = Array<int>::of(3, 8, 5, 8);
+        CPPUNIT_ASSERT( js4cpp::intersection(a, b).join() == "5,3" );
+        CPPUNIT_ASSERT( js4cpp::difference(a, b).join() == "1,7" );
+        CPPUNIT_ASSERT( js4cpp::unionOf(a, b).join() == "5,1,3,7,8" );
+        CPPUNIT_ASSERT( js4cpp::symmetricDifference(a, b).join() == "1,7,8" );
+
+        Array<double> numbers = Array<double>::of(NAN, 0.0, 1.0);
+        CPPUNIT_ASSERT( js4cpp::intersection(numbers, Array<double>::of(-0.0, NAN)).length() == 2 );
+    }
+
+    void testSorted() {
+        using js4cpp::Array;
+
+        Array<int> a = Array<int>::of(1, 1, 3, 5, 7), b = Array<int>::of(3, 5, 5, 8);
+        CPPUNIT_ASSERT( js4cpp::intersection(a, b).join() == "3,5" );
+        CPPUNIT_ASSERT( js4cpp::difference(a, b).join() == "1,7" );
+        CPPUNIT_ASSERT( js4cpp::unionOf(a, b).join() == "1,3,5,7,8" );
+        CPPUNIT_ASSERT( js4cpp::symmetricDifference(a, b).join() == "1,7,8" );
+        CPPUNIT_ASSERT( js4cpp::intersection(a, Array<int>()).length() == 0 && js4cpp::unionOf(Array<int>(), b).join() == "3,5,8" );
+
+        Array<std::string> words = Array<std::string>::of("a", "b", "c");
+        CPPUNIT_ASSERT( js4cpp::difference(words, Array<std::string>::of("b")).join() == "a,c" );
+    }
+
+    void testGallop() {
+        using js4cpp::Array;
+
+        Array<uint64_t> ids = Array<uint64_t>::from(100000, [] (size_t i) { return uint64_t(i) * 3; });
+        Array<uint64_t> probe = Array<uint64_t>::of(0, 4, 9, 9, 299997, 299998, 400000);
+
+        CPPUNIT_ASSERT( js4cpp::intersection(probe, ids).join() == "0,9,299997" );
+        CPPUNIT_ASSERT( js4cpp::intersection(ids, probe).join() == "0,9,299997" );
+        CPPUNIT_ASSERT( js4cpp::difference(probe, ids).join() == "4,299998,400000" );
+        CPPUNIT_ASSERT( js4cpp::difference(ids, probe).length() == 99997 );
+    }
+
+    void testParallel() {
+        using js4cpp::Array;
+
+        Array<uint64_t> evens = Array<uint64_t>::from(200000, [] (size_t i) { return uint64_t(i / 2) * 2; });
+        Array<uint64_t> thirds = Array<uint64_t>::from(100000, [] (size_t i) { return uint64_t(i) * 3; });
+
+        Array<uint64_t> common = js4cpp::intersectionParallel(evens, thirds, 4);
+        CPPUNIT_ASSERT( common.length() == 33334 && common[1] == 6 && equal(common, js4cpp::intersection(evens, thirds)) );
+        CPPUNIT_ASSERT( equal(js4cpp::differenceParallel(evens, thirds, 4), js4cpp::difference(evens, thirds)) );
+
+        Array<uint64_t> shuffled = evens.toReversed();
+        Array<uint64_t> reversed = js4cpp::intersectionParallel(shuffled, thirds, 4);
+        CPPUNIT_ASSERT( reversed.length() == 33334 && reversed[0] == 199998 && reversed[33333] == 0 );
+        CPPUNIT_ASSERT( equal(js4cpp::differenceParallel(shuffled, thirds, 4), js4cpp::difference(shuffled, thirds)) );
+    }
+
+    void setUp() {}
+
+    void tearDown() {}
+
+    CPPUNIT_TEST_SUITE( SetOperationsTest );
+    CPPUNIT_TEST( testUnsorted );
+    CPPUNIT_TEST( testSorted );
+    CPPUNIT_TEST( testGallop );
+    CPPUNIT_TEST( testParallel );
+    CPPUNIT_TEST_SUITE_END();
+
+private:
+    template <typename T>
+    static bool equal(const js4cpp::Array<T> & a, const js4cpp::Array<T> & b) {
+        return a.length() == b.length() && std::equal(a.begin(), a.end(), b.begin());
+    }
+};
@@ -0,0 +1,325 @@
+/* Copyright (c) 2012 Kirill Dmitrenko <kdmitrenko@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is furnished
+ * to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * @file soa_array.hpp
+ * Array of records stored as one Array per field.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <functional>
+#include <numeric>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "array.hpp"
+
+namespace js4cpp {
+
+/**
+ * Compile-time list of indexes, to expand operations over all columns.
+ */
+template <size_t... I> struct Indices {};
+
+template <size_t N, size_t... I> struct MakeIndices : MakeIndices<N - 1, N - 1, I...> {};
+
+template <size_t... I> struct MakeIndices<0, I...> {
+    typedef Indices<I...> type;
+};
+
+/**
+ * Proxy of one row of an SoAArray: references fields in their columns.
+ *
+ * @tparam Columns Tuple of column Arrays (const for read-only rows).
+ * @tparam Record Tuple of fields.
+ */
+template <typename Columns, typename Record> class SoARow
+{
+public:
+    SoARow(Columns & columns, size_t index) : columns_(&columns), index_(index) {}
+
+    /**
+     * Get reference to a field.
+     *
+     * @tparam I Field index.
+     * @returns Field.
+     */
+    template <size_t I>
+    auto get() const -> decltype(std::get<I>(std::declval<Columns &>()).begin()[0]) {
+        return std::get<I>(*columns_).begin()[index_];
+    }
+
+    /**
+     * Get row's index.
+     */
+    size_t index() const {
+        return index_;
+    }
+
+    /**
+     * Copy fields into a tuple.
+     *
+     * @returns Record.
+     */
+    Record tuple() const {
+        return tupleOf(typename MakeIndices<std::tuple_size<Record>::value>::type());
+    }
+
+private:
+    template <size_t... I>
+    Record tupleOf(Indices<I...>) const {
+        return Record(std::get<I>(*columns_).begin()[index_]...);
+    }
+
+    Columns * columns_;
+    size_t index_;
+};
+
+/**
+ * Structure of arrays: records with fields Fields... stored as one
+ * Array per field, so scans of a single field read memory sequentially
+ * and vectorize, instead of dragging whole records through the cache.
+ * Columns are ordinary Arrays (column<I>()), whose whole API applies;
+ * row-wise operations pass a Row proxy to callbacks.
+ *
+ * @tparam Fields Fields types.
+ */
+template <typename... Fields> class SoAArray
+{
+    static_assert(sizeof...(Fields) > 0, "SoAArray needs at least one field");
+
+    typedef std::tuple<Array<Fields>...> Columns;
+    typedef typename MakeIndices<sizeof...(Fields)>::type AllColumns;
+
+public:
+    typedef std::tuple<Fields...> Record;
+    typedef SoARow<Columns, Record> Row;
+    typedef SoARow<const Columns, Record> ConstRow;
+
+    /**
+     * Type of a field.
+     */
+    template <size_t I> struct Field {
+        typedef typename std::tuple_element<I, Record>::type type;
+    };
+
+    /**
+     * Create array of given length filled with default records.
+     */
+    explicit SoAArray(size_t length = 0) : columns_(Array<Fields>(length)...) {}
+
+    /**
+     * Create array from any iterable of records (tuples), i.e. convert
+     * array of structures into structure of arrays.
+     *
+     * @param iterable Records.
+     * @returns New array.
+     */
+    template <typename Iterable>
+    static SoAArray from(const Iterable & iterable) {
+        SoAArray result;
+
+        for (auto it = std::begin(iterable); it != std::end(iterable); ++it) {
+            result.pushRecord(*it, AllColumns());
+        }
+
+        return result;
+    }
+
+    /**
+     * Get column of a field.
+     *
+     * @tparam I Field index.
+     * @returns Column.
+     */
+    template <size_t I>
+    Array<typename Field<I>::type> & column() {
+        return std::get<I>(columns_);
+    }
+
+    template <size_t I>
+    const Array<typename Field<I>::type> & column() const {
+        return std::get<I>(columns_);
+    }
+
+    /**
+     * Get number of records.
+     */
+    size_t length() const {
+        return std::get<0>(columns_).length();
+    }
+
+    /**
+     * Get row proxy. Index must be less than length.
+     */
+    Row operator [](size_t index) {
+        return Row(columns_, index);
+    }
+
+    ConstRow operator [](size_t index) const {
+        return ConstRow(columns_, index);
+    }
+
+    /**
+     * Append record.
+     *
+     * @param fields Record's fields.
+     */
+    void push(const Fields &... fields) {
+        pushRecord(std::forward_as_tuple(fields...), AllColumns());
+    }
+
+    /**
+     * Execute a function for each row.
+     *
+     * @param callback Function called as callback(row, index, array), taking as many arguments as it needs.
+     */
+    template <typename F>
+    void forEach(F callback) {
+        for (size_t i = 0, length = this->length(); i < length; ++i) {
+            Row row(columns_, i);
+            invokeCallback(callback, row, i, *this);
+        }
+    }
+
+    /**
+     * Create Array of callback's results for each row.
+     *
+     * @tparam R Result type. Deduced from callback if not specified.
+     * @param callback Function called as callback(row, index, array).
+     * @returns New array.
+     */
+    template <typename R = void, typename F>
+    Array<typename std::conditional<std::is_void<R>::value,
+        typename std::decay<decltype(invokeCallback(std::declval<F &>(), std::declval<ConstRow &>(), size_t(), std::declval<const SoAArray &>()))>::type, R>::type>
+    map(F callback) const {
+        typedef typename std::conditional<std::is_void<R>::value,
+            typename std::decay<decltype(invokeCallback(callback, std::declval<ConstRow &>(), size_t(), *this))>::type, R>::type Result;
+
+        return Array<Result>::from(length(), [&] (size_t i) {
+            ConstRow row(columns_, i);
+            return invokeCallback(callback, row, i, *this);
+        });
+    }
+
+    /**
+     * Create array of rows which pass the test.
+     *
+     * @param test Function called as test(row, index, array).
+     * @returns New array.
+     */
+    template <typename F>
+    SoAArray filter(F test) const {
+        Array<size_t> selected;
+
+        for (size_t i = 0, length = this->length(); i < length; ++i) {
+            ConstRow row(columns_, i);
+            if (invokeCallback(test, row, i, *this)) {
+                selected.push(i);
+            }
+        }
+
+        return select(selected, AllColumns());
+    }
+
+    /**
+     * Reduce rows to a single value.
+     *
+     * @param callback Function called as callback(accumulator, row, index, array).
+     * @param initialValue Initial accumulator.
+     * @returns Accumulated value.
+     */
+    template <typename F, typename R>
+    R reduce(F callback, R initialValue) const {
+        for (size_t i = 0, length = this->length(); i < length; ++i) {
+            ConstRow row(columns_, i);
+            initialValue = invokeReducer(callback, initialValue, row, i, *this);
+        }
+
+        return initialValue;
+    }
+
+    /**
+     * Stable sort of all rows by one field. The field's column is sorted
+     * into a permutation first, then every column is permuted once.
+     *
+     * @tparam I Field index.
+     * @param comparator Comparator of field values.
+     */
+    template <size_t I, typename Compare = std::less<typename Field<I>::type> >
+    void sortBy(Compare comparator = Compare()) {
+        const typename Field<I>::type * keys = column<I>().begin();
+        Array<size_t> order(length(), Uninitialized());
+
+        std::iota(order.begin(), order.end(), size_t(0));
+        std::stable_sort(order.begin(), order.end(), [&] (size_t a, size_t b) {
+            return comparator(keys[a], keys[b]);
+        });
+
+        *this = select(order, AllColumns());
+    }
+
+    /**
+     * Sort rows with a comparator of rows.
+     *
+     * @param comparator Function called as comparator(rowA, rowB).
+     */
+    template <typename Compare>
+    void sort(Compare comparator) {
+        Array<size_t> order(length(), Uninitialized());
+
+        std::iota(order.begin(), order.end(), size_t(0));
+        std::stable_sort(order.begin(), order.end(), [&] (size_t a, size_t b) {
+            return comparator(ConstRow(columns_, a), ConstRow(columns_, b));
+        });
+
+        *this = select(order, AllColumns());
+    }
+
+private:
+    template <typename Tuple, size_t... I>
+    void pushRecord(const Tuple & record, Indices<I...>) {
+        int expand[] = { 0, (std::get<I>(columns_).push(std::get<I>(record)), 0)... };
+        (void) expand;
+    }
+
+    /**
+     * Gather rows at given indexes into a new array, column by column.
+     */
+    template <size_t... I>
+    SoAArray select(const Array<size_t> & indexes, Indices<I...>) const {
+        SoAArray result;
+        const size_t * index = indexes.begin();
+
+        int expand[] = { 0, (std::get<I>(result.columns_) = Array<Fields>::from(indexes.length(), [&] (size_t i) {
+            return std::get<I>(columns_).begin()[index[i]];
+        }), 0)... };
+        (void) expand;
+
+        return result;
+    }
+
+    Columns columns_;
+};
+
+} // namespace js4cpp
@@ -0,0 +1,98 @@
+#pragma once
+
+#include <string>
+#include <tuple>
+
+#include <cppunit/TestCaller.h>
+#include <cppunit/TestCase.h>
+#include <cppunit/TestSuite.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+#include "soa_array.hpp"
+
+class SoAArrayTest : public CppUnit::TestCase
+{
+public:
+    typedef js4cpp::SoAArray<int, double, std::string> Table;
+
+    SoAArrayTest() : CppUnit::TestCase("SoAArray Test Case") {};
+
+    void testColumns() {
+        CPPUNIT_ASSERT( table->length() == 4 );
+        CPPUNIT_ASSERT( table->column<0>().join() == "3,1,2,1" && table->column<2>().join() == "c,a,b,d" );
+        CPPUNIT_ASSERT( table->column<1>().reduce(std::plus<double>(), 0.0) == 10 );
+
+        table->column<1>().forEach([] (double & price) { price *= 2; });
+        CPPUNIT_ASSERT( (*table)[3].get<1>() == 8 );
+
+        Table sized(3);
+        CPPUNIT_ASSERT( sized.length() == 3 && sized.column<2>().length() == 3 && sized[2].get<0>() == 0 );
+    }
+
+    void testRows() {
+        Table::Row row = (*table)[1];
+        CPPUNIT_ASSERT( row.get<0>() == 1 && row.get<2>() == "a" && row.index() == 1 );
+
+        row.get<2>() = "z";
+        CPPUNIT_ASSERT( table->column<2>()[1] == "z" );
+        CPPUNIT_ASSERT( (*table)[0].tuple() == std::make_tuple(3, 3.0, std::string("c")) );
+
+        Table converted = Table::from(js4cpp::Array<Table::Record>::of(std::make_tuple(7, 0.5, std::string("x"))));
+        CPPUNIT_ASSERT( converted.length() == 1 && converted[0].get<2>() == "x" );
+    }
+
+    void testIteration() {
+        int ids = 0;
+        table->forEach([&] (const Table::Row & row, size_t index) {
+            ids += row.get<0>() * int(index);
+        });
+        CPPUNIT_ASSERT( ids == 0 + 1 + 4 + 3 );
+
+        js4cpp::Array<std::string> labels = table->map([] (const Table::ConstRow & row) {
+            return row.get<2>() + std::to_string(row.get<0>());
+        });
+        CPPUNIT_ASSERT( labels.join() == "c3,a1,b2,d1" );
+
+        Table ones = table->filter([] (const Table::ConstRow & row) { return row.get<0>() == 1; });
+        CPPUNIT_ASSERT( ones.length() == 2 && ones.column<2>().join() == "a,d" && ones.column<1>().join() == "1,4" );
+
+        CPPUNIT_ASSERT( table->reduce([] (double sum, const Table::ConstRow & row) {
+            return sum + row.get<0>() * row.get<1>();
+        }, 0.0) == 3 * 3 + 1 + 2 * 2 + 4 );
+    }
+
+    void testSort() {
+        table->sortBy<0>();
+        CPPUNIT_ASSERT( table->column<0>().join() == "1,1,2,3" && table->column<2>().join() == "a,d,b,c" );
+
+        table->sortBy<2>(std::greater<std::string>());
+        CPPUNIT_ASSERT( table->column<2>().join() == "d,c,b,a" && table->column<1>().join() == "4,3,2,1" );
+
+        table->sort([] (const Table::ConstRow & a, const Table::ConstRow & b) {
+            return a.get<0>() < b.get<0>();
+        });
+        CPPUNIT_ASSERT( table->column<2>().join() == "d,a,b,c" && table->column<0>().join() == "1,1,2,3" );
+    }
+
+    void setUp() {
+        table = new Table();
+        table->push(3, 3.0, "c");
+        table->push(1, 1.0, "a");
+        table->push(2, 2.0, "b");
+        table->push(1, 4.0, "d");
+    }
+
+    void tearDown() {
+        delete table;
+    }
+
+    CPPUNIT_TEST_SUITE( SoAArrayTest );
+    CPPUNIT_TEST( testColumns );
+    CPPUNIT_TEST( testRows );
+    CPPUNIT_TEST( testIteration );
+    CPPUNIT_TEST( testSort );
+    CPPUNIT_TEST_SUITE_END();
+
+private:
+    Table * table;
+};
@@ -0,0 +1,867 @@
+/* Copyright (c) 2012 Kirill Dmitrenko <kdmitrenko@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is furnished
+ * to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * @file string.hpp
+ * JS-style immutable string.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#include "array.hpp"
+
+namespace js4cpp {
+
+/**
+ * JS-style immutable string of bytes (UTF-8 code units; indexes count
+ * bytes, not UTF-16 code units as in JS).
+ *
+ * Copies and slices share one buffer, so slice, substring and trim are O(1)
+ * and allocate nothing. Strings of up to 15 bytes are stored inline.
+ * Concatenating long strings builds a rope which is flattened into a single
+ * buffer the first time its characters are read, so building a string
+ * piece by piece with `+` is linear.
+ *
+ * Reading an unflattened rope updates the String object it is read from:
+ * like std::string, one String object must not be used from several
+ * threads without synchronization (distinct copies can be).
+ * @see https://developer.mozilla.org/en-US/docs/Web/JavaScript/Reference/Global_Objects/String
+ */
+class String
+{
+public:
+    typedef const char * iterator;
+    typedef const char * const_iterator;
+    typedef char value_type;
+
+    /**
+     * Longest string stored inline.
+     */
+    static const size_t SMALL_CAPACITY = 15;
+
+    /**
+     * Shortest concatenation which is deferred into a rope rather than
+     * copied right away.
+     */
+    static const size_t ROPE_MIN_LENGTH = 64;
+
+    /**
+     * Create empty string.
+     */
+    String() : length_(0), offset_(0) {}
+
+    /**
+     * Create string by copying characters.
+     */
+    String(const char * chars) {
+        assign(chars, std::strlen(chars));
+    }
+
+    String(const char * chars, size_t length) {
+        assign(chars, length);
+    }
+
+    String(const std::string & chars) {
+        assign(chars.data(), chars.size());
+    }
+
+    /**
+     * Create string taking over a std::string's buffer without copying.
+     */
+    String(std::string && chars);
+
+    /**
+     * Get canonical copy of a string: equal interned strings share one
+     * buffer, so repeated keys take memory once and compare in O(1).
+     * Interned strings are never freed, so intern only a bounded set of
+     * strings such as property names.
+     *
+     * Strings of up to SMALL_CAPACITY bytes are deliberately not entered
+     * into the table and come back as inline copies: they own no buffer to
+     * share, and copying or comparing one is already as cheap as it gets.
+     *
+     * @param string String.
+     * @returns Interned string.
+     */
+    static String intern(const String & string);
+
+    /**
+     * Get string's length.
+     * @see https://developer.mozilla.org/en-US/docs/Web/JavaScript/Reference/Global_Objects/String/length
+     *
+     * @returns Length in bytes.
+     */
+    size_t length() const {
+        return length_;
+    }
+
+    /**
+     * Get characters (not null-terminated).
+     *
+     * @returns Pointer to characters.
+     */
+    const char * data() const;
+
+    const_iterator begin() const {
+        return data();
+    }
+
+    const_iterator end() const {
+        return data() + length_;
+    }
+
+    /**
+     * Get character at given index. Index must be less than length.
+     */
+    char operator [](size_t index) const {
+        return data()[index];
+    }
+
+    /**
+     * Get character at given index as a string.
+     * @see https://developer.mozilla.org/en-US/docs/Web/JavaScript/Reference/Global_Objects/String/charAt
+     *
+     * @param index Index.
+     * @returns One-character string or empty string if out of range.
+     */
+    String charAt(size_t index) const {
+        return index < length_ ? String(data() + index, 1) : String();
+    }
+
+    /**
+     * Copy characters into a std::string.
+     *
+     * @returns std::string.
+     */
+    std::string str() const {
+        return std::string(data(), length_);
+    }
+
+    /**
+     * Extract a section of the string, sharing its buffer.
+     * @see https://developer.mozilla.org/en-US/docs/Web/JavaScript/Reference/Global_Objects/String/slice
+     *
+     * @param start Relative index of the first character.
+     * @param end Relative index after the last character.
+     * @returns Slice.
+     */
+    String slice(ssize_t start, ssize_t end = std::numeric_limits<ssize_t>::max()) const {
+        size_t from = relativeIndex(start, length_), to = relativeIndex(end, length_);
+
+        return from < to ? String(*this, from, to - from) : String();
+    }
+
+    /**
+     * Extract characters between two indexes (swapped if start > end),
+     * sharing the buffer.
+     * @see https://developer.mozilla.org/en-US/docs/Web/JavaScript/Reference/Global_Objects/String/substring
+     *
+     * @param start Index of the first character.
+     * @param end Index after the last character.
+     * @returns Substring.
+     */
+    String substring(size_t start, size_t end = std::numeric_limits<size_t>::max()) const {
+        start = std::min(start, length_);
+        end = std::min(end, length_);
+        if (start > end) {
+            std::swap(start, end);
+        }
+
+        return String(*this, start, end - start);
+    }
+
+    /**
+     * Find first occurrence of a substring.
+     * @see https://developer.mozilla.org/en-US/docs/Web/JavaScript/Reference/Global_Objects/String/indexOf
+     *
+     * @param search Substring.
+     * @param fromIndex Index to start search at.
+     * @returns Index or -1 if not found.
+     */
+    ssize_t indexOf(const String & search, size_t fromIndex = 0) const {
+        return find(data(), length_, search.data(), search.length_, fromIndex);
+    }
+
+    /**
+     * Find last occurrence of a substring.
+     * @see https://developer.mozilla.org/en-US/docs/Web/JavaScript/Reference/Global_Objects/String/lastIndexOf
+     *
+     * @param search Substring.
+     * @param fromIndex Last index the substring may start at.
+     * @returns Index or -1 if not found.
+     */
+    ssize_t lastIndexOf(const String & search, size_t fromIndex = std::numeric_limits<size_t>::max()) const {
+        if (search.length_ > length_) {
+            return -1;
+        }
+
+        const char * text = data(), * pattern = search.data();
+        size_t m = search.length_;
+
+        for (size_t i = std::min(fromIndex, length_ - m) + 1; i-- > 0;) {
+            if ((m == 0 || text[i] == pattern[0]) && std::memcmp(text + i, pattern, m) == 0) {
+                return i;
+            }
+        }
+
+        return -1;
+    }
+
+    /**
+     * Check whether string contains a substring.
+     * @see https://developer.mozilla.org/en-US/docs/Web/JavaScript/Reference/Global_Objects/String/includes
+     *
+     * @param search Substring.
+     * @param position Index to start search at.
+     * @returns True if found.
+     */
+    bool includes(const String & search, size_t position = 0) const {
+        return indexOf(search, position) != -1;
+    }
+
+    /**
+     * Check whether string starts with a substring.
+     * @see https://developer.mozilla.org/en-US/docs/Web/JavaScript/Reference/Global_Objects/String/startsWith
+     *
+     * @param search Substring.
+     * @param position Index the substring is expected at.
+     * @returns True if it starts with the substring.
+     */
+    bool startsWith(const String & search, size_t position = 0) const {
+        return position <= length_ && search.length_ <= length_ - position
+            && std::memcmp(data() + position, search.data(), search.length_) == 0;
+    }
+
+    /**
+     * Check whether string ends with a substring.
+     * @see https://developer.mozilla.org/en-US/docs/Web/JavaScript/Reference/Global_Objects/String/endsWith
+     *
+     * @param search Substring.
+     * @param endPosition Index the substring is expected to end at.
+     * @returns True if it ends with the substring.
+     */
+    bool endsWith(const String & search, size_t endPosition = std::numeric_limits<size_t>::max()) const {
+        endPosition = std::min(endPosition, length_);
+
+        return search.length_ <= endPosition
+            && std::memcmp(data() + endPosition - search.length_, search.data(), search.length_) == 0;
+    }
+
+    /**
+     * Concatenate strings. Long results are built lazily as ropes.
+     * @see https://developer.mozilla.org/en-US/docs/Web/JavaScript/Reference/Global_Objects/String/concat
+     *
+     * @param other String to append.
+     * @returns Concatenated string.
+     */
+    String concat(const String & other) const;
+
+    String & operator +=(const String & other) {
+        return *this = concat(other);
+    }
+
+    /**
+     * Split string into slices sharing its buffer.
+     * @see https://developer.mozilla.org/en-US/docs/Web/JavaScript/Reference/Global_Objects/String/split
+     *
+     * @param separator Separator; empty one splits into single characters.
+     * @param limit Maximum number of slices.
+     * @returns Slices.
+     */
+    Array<String> split(const String & separator, size_t limit = std::numeric_limits<size_t>::max()) const;
+
+    /**
+     * Replace first occurrence of a substring.
+     * @see https://developer.mozilla.org/en-US/docs/Web/JavaScript/Reference/Global_Objects/String/replace
+     *
+     * @param pattern Substring to replace.
+     * @param replacement Replacement.
+     * @returns New string.
+     */
+    String replace(const String & pattern, const String & replacement) const {
+        ssize_t found = indexOf(pattern);
+
+        if (found == -1) {
+            return *this;
+        }
+
+        std::string result;
+        result.reserve(length_ - pattern.length_ + replacement.length_);
+        result.append(data(), found);
+        result.append(replacement.data(), replacement.length_);
+        result.append(data() + found + pattern.length_, length_ - found - pattern.length_);
+
+        return String(std::move(result));
+    }
+
+    /**
+     * Replace all occurrences of a substring.
+     * @see https://developer.mozilla.org/en-US/docs/Web/JavaScript/Reference/Global_Objects/String/replaceAll
+     *
+     * @param pattern Substring to replace; empty one matches between all characters.
+     * @param replacement Replacement.
+     * @returns New string.
+     */
+    String replaceAll(const String & pattern, const String & replacement) const {
+        const char * text = data();
+        std::string result;
+        size_t position = 0;
+
+        if (pattern.length_ == 0) {
+            result.reserve(length_ + (length_ + 1) * replacement.length_);
+            for (size_t i = 0; i < length_; ++i) {
+                result.append(replacement.data(), replacement.length_);
+                result += text[i];
+            }
+            result.append(replacement.data(), replacement.length_);
+
+            return String(std::move(result));
+        }
+
+        for (ssize_t found; (found = find(text, length_, pattern.data(), pattern.length_, position)) != -1; position = found + pattern.length_) {
+            result.append(text + position, found - position);
+            result.append(replacement.data(), replacement.length_);
+        }
+        if (position == 0) {
+            return *this;
+        }
+        result.append(text + position, length_ - position);
+
+        return String(std::move(result));
+    }
+
+    /**
+     * Repeat string.
+     * @see https://developer.mozilla.org/en-US/docs/Web/JavaScript/Reference/Global_Objects/String/repeat
+     *
+     * @param count Number of copies.
+     * @returns New string.
+     */
+    String repeat(size_t count) const {
+        std::string result;
+        result.reserve(length_ * count);
+        for (size_t i = 0; i < count; ++i) {
+            result.append(data(), length_);
+        }
+
+        return String(std::move(result));
+    }
+
+    /**
+     * Remove whitespace from both ends, sharing the buffer.
+     * @see https://developer.mozilla.org/en-US/docs/Web/JavaScript/Reference/Global_Objects/String/trim
+     *
+     * @returns Trimmed string.
+     */
+    String trim() const {
+        return trimEnd().trimStart();
+    }
+
+    String trimStart() const {
+        const char * text = data();
+        size_t start = 0;
+
+        while (start < length_ && isSpace(text[start])) {
+            ++start;
+        }
+
+        return String(*this, start, length_ - start);
+    }
+
+    String trimEnd() const {
+        const char * text = data();
+        size_t end = length_;
+
+        while (end > 0 && isSpace(text[end - 1])) {
+            --end;
+        }
+
+        return String(*this, 0, end);
+    }
+
+    /**
+     * Compare strings byte by byte.
+     *
+     * @param other String to compare with.
+     * @returns Negative, zero or positive like std::string::compare.
+     */
+    int compare(const String & other) const {
+        if (sharesChars(other)) {
+            return 0;
+        }
+
+        int result = std::memcmp(data(), other.data(), std::min(length_, other.length_));
+
+        return result != 0 ? result : length_ < other.length_ ? -1 : length_ > other.length_;
+    }
+
+    bool operator ==(const String & other) const {
+        return length_ == other.length_ && (sharesChars(other) || std::memcmp(data(), other.data(), length_) == 0);
+    }
+
+    bool operator !=(const String & other) const {
+        return !(*this == other);
+    }
+
+    bool operator <(const String & other) const {
+        return compare(other) < 0;
+    }
+
+    /**
+     * Get hash of characters (FNV-1a).
+     *
+     * @returns Hash.
+     */
+    size_t hash() const {
+        const unsigned char * p = reinterpret_cast<const unsigned char *>(data());
+        uint64_t hash = 14695981039346656037ULL;
+
+        for (size_t i = 0; i < length_; ++i) {
+            hash = (hash ^ p[i]) * 1099511628211ULL;
+        }
+
+        return static_cast<size_t>(hash);
+    }
+
+    /**
+     * Find substring in characters: memchr skips to candidates for the
+     * first character, memcmp checks the rest.
+     *
+     * @param text Characters to search in.
+     * @param length Length of text.
+     * @param pattern Characters to search for.
+     * @param patternLength Length of pattern.
+     * @param fromIndex Index to start search at.
+     * @returns Index or -1 if not found.
+     */
+    static ssize_t find(const char * text, size_t length, const char * pattern, size_t patternLength, size_t fromIndex) {
+        fromIndex = std::min(fromIndex, length);
+        if (patternLength == 0) {
+            return fromIndex;
+        }
+        if (patternLength > length - fromIndex) {
+            return -1;
+        }
+
+        const char * p = text + fromIndex, * last = text + length - patternLength;
+
+        while ((p = static_cast<const char *>(std::memchr(p, pattern[0], last - p + 1))) != 0) {
+            if (std::memcmp(p + 1, pattern + 1, patternLength - 1) == 0) {
+                return p - text;
+            }
+            if (p++ == last) {
+                break;
+            }
+        }
+
+        return -1;
+    }
+
+    /**
+     * Count occurrences of a character, 8 bytes at a time.
+     *
+     * @param text Characters to search in.
+     * @param length Length of text.
+     * @param c Character to count.
+     * @returns Number of occurrences.
+     */
+    static size_t count(const char * text, size_t length, char c) {
+        const uint64_t lows = 0x7f7f7f7f7f7f7f7fULL;
+        const uint64_t pattern = 0x0101010101010101ULL * static_cast<unsigned char>(c);
+        size_t result = 0, i = 0;
+
+        for (; i + 8 <= length; i += 8) {
+            uint64_t word;
+            std::memcpy(&word, text + i, 8);
+            word ^= pattern;
+            // High bit set exactly in the bytes which are zero (no borrows
+            // between bytes, unlike the usual haszero trick).
+            result += __builtin_popcountll(~(((word & lows) + lows) | word | lows));
+        }
+        for (; i < length; ++i) {
+            result += text[i] == c;
+        }
+
+        return result;
+    }
+
+    /**
+     * Count pieces split would produce, so the result is allocated once.
+     *
+     * @param text Characters to split.
+     * @param length Length of text.
+     * @param separator Separator characters.
+     * @param separatorLength Length of separator.
+     * @param limit Maximum number of pieces.
+     * @returns Number of pieces.
+     */
+    static size_t countPieces(const char * text, size_t length, const char * separator, size_t separatorLength, size_t limit) {
+        if (separatorLength == 0) {
+            return std::min(length, limit);
+        }
+        if (separatorLength == 1 && limit > length) {
+            return count(text, length, separator[0]) + 1;
+        }
+
+        size_t result = 0;
+        for (ssize_t found = 0; result < limit && found != -1; ++result) {
+            found = find(text, length, separator, separatorLength, found);
+            found = found == -1 ? -1 : found + separatorLength;
+        }
+
+        return result;
+    }
+
+    /**
+     * Find end of the piece starting at given index.
+     *
+     * @returns Index of the next separator or length if there is none.
+     */
+    static size_t endOfPiece(const char * text, size_t length, const char * separator, size_t separatorLength, size_t start) {
+        if (separatorLength == 1) {
+            const void * found = std::memchr(text + start, separator[0], length - start);
+            return found ? static_cast<const char *>(found) - text : length;
+        }
+
+        ssize_t found = find(text, length, separator, separatorLength, start);
+        return found == -1 ? length : found;
+    }
+
+private:
+    struct Node;
+
+    String(const String & source, size_t offset, size_t length) {
+        if (length <= SMALL_CAPACITY) {
+            assign(source.data() + offset, length);
+        } else {
+            source.data();
+            node_ = source.node_;
+            offset_ = source.offset_ + offset;
+            length_ = length;
+        }
+    }
+
+    void assign(const char * chars, size_t length);
+
+    bool sharesChars(const String & other) const {
+        return node_ && node_ == other.node_ && offset_ == other.offset_ && length_ == other.length_;
+    }
+
+    static bool isSpace(char c) {
+        return c == ' ' || (c >= '\t' && c <= '\r');
+    }
+
+    void flatten() const;
+
+    mutable std::shared_ptr<Node> node_;
+    size_t length_;
+    union {
+        size_t offset_;
+        char small_[SMALL_CAPACITY + 1];
+    };
+};
+
+/**
+ * Shared buffer or rope of two non-empty strings.
+ */
+struct String::Node {
+    explicit Node(std::string && chars) : chars(std::move(chars)) {}
+
+    Node(const String & left, const String & right) : left(left), right(right) {}
+
+    /**
+     * Release children iteratively: a rope built by appending in a loop is
+     * as deep as it is long.
+     */
+    ~Node() {
+        if (!isRope()) {
+            return;
+        }
+
+        std::vector<std::shared_ptr<Node> > pending;
+        pending.push_back(std::move(left.node_));
+        pending.push_back(std::move(right.node_));
+
+        while (!pending.empty()) {
+            std::shared_ptr<Node> node = std::move(pending.back());
+            pending.pop_back();
+
+            if (node && node.use_count() == 1 && node->isRope()) {
+                pending.push_back(std::move(node->left.node_));
+                pending.push_back(std::move(node->right.node_));
+            }
+        }
+    }
+
+    bool isRope() const {
+        return left.length_ != 0;
+    }
+
+    std::string chars;
+    String left;
+    String right;
+};
+
+inline String::String(std::string && chars) {
+    if (chars.size() <= SMALL_CAPACITY) {
+        assign(chars.data(), chars.size());
+    } else {
+        length_ = chars.size();
+        offset_ = 0;
+        node_ = std::make_shared<Node>(std::move(chars));
+    }
+}
+
+inline const char * String::data() const {
+    if (!node_) {
+        return small_;
+    }
+    if (node_->isRope()) {
+        flatten();
+    }
+
+    return node_->chars.data() + offset_;
+}
+
+inline void String::assign(const char * chars, size_t length) {
+    length_ = length;
+    if (length <= SMALL_CAPACITY) {
+        std::memset(small_, 0, sizeof(small_));
+        std::memcpy(small_, chars, length);
+    } else {
+        offset_ = 0;
+        node_ = std::make_shared<Node>(std::string(chars, length));
+    }
+}
+
+inline String String::concat(const String & other) const {
+    if (other.length_ == 0) {
+        return *this;
+    }
+    if (length_ == 0) {
+        return other;
+    }
+
+    size_t length = length_ + other.length_;
+
+    if (length < ROPE_MIN_LENGTH) {
+        std::string chars;
+        chars.reserve(length);
+        chars.append(data(), length_);
+        chars.append(other.data(), other.length_);
+
+        return String(std::move(chars));
+    }
+
+    String result;
+    result.node_ = std::make_shared<Node>(*this, other);
+    result.offset_ = 0;
+    result.length_ = length;
+
+    return result;
+}
+
+inline void String::flatten() const {
+    std::string chars;
+    std::vector<const String *> pending(1, this);
+
+    chars.reserve(length_);
+    while (!pending.empty()) {
+        const String * string = pending.back();
+        pending.pop_back();
+
+        if (string->node_ && string->node_->isRope()) {
+            pending.push_back(&string->node_->right);
+            pending.push_back(&string->node_->left);
+        } else {
+            chars.append(string->data(), string->length_);
+        }
+    }
+
+    node_ = std::make_shared<Node>(std::move(chars));
+}
+
+inline Array<String> String::split(const String & separator, size_t limit) const {
+    const char * text = data(), * pattern = separator.data();
+    size_t m = separator.length_, start = 0;
+
+    return Array<String>::from(countPieces(text, length_, pattern, m, limit), [&] (size_t) {
+        size_t end = m == 0 ? start + 1 : endOfPiece(text, length_, pattern, m, start);
+        String piece(*this, start, end - start);
+
+        start = end + m;
+        return piece;
+    });
+}
+
+inline String operator +(const String & left, const String & right) {
+    return left.concat(right);
+}
+
+/**
+ * Non-owning view of characters, e.g. a field of a line being parsed. The
+ * viewed characters must outlive the view. Like built-in types, a default
+ * constructed view is uninitialized, which lets Arrays of views be
+ * allocated without initialization.
+ */
+class StringView
+{
+public:
+    typedef const char * iterator;
+    typedef const char * const_iterator;
+    typedef char value_type;
+
+    StringView() = default;
+
+    StringView(const char * data, size_t length) : data_(data), length_(length) {}
+
+    StringView(const char * chars) : data_(chars), length_(std::strlen(chars)) {}
+
+    StringView(const std::string & string) : data_(string.data()), length_(string.size()) {}
+
+    StringView(const String & string) : data_(string.data()), length_(string.length()) {}
+
+    const char * data() const {
+        return data_;
+    }
+
+    size_t length() const {
+        return length_;
+    }
+
+    const_iterator begin() const {
+        return data_;
+    }
+
+    const_iterator end() const {
+        return data_ + length_;
+    }
+
+    char operator [](size_t index) const {
+        return data_[index];
+    }
+
+    /**
+     * Copy characters into a std::string.
+     *
+     * @returns std::string.
+     */
+    std::string str() const {
+        return std::string(data_, length_);
+    }
+
+    bool operator ==(const StringView & other) const {
+        return length_ == other.length_ && std::memcmp(data_, other.data_, length_) == 0;
+    }
+
+    bool operator !=(const StringView & other) const {
+        return !(*this == other);
+    }
+
+    bool operator <(const StringView & other) const {
+        int result = std::memcmp(data_, other.data_, std::min(length_, other.length_));
+        return result != 0 ? result < 0 : length_ < other.length_;
+    }
+
+private:
+    const char * data_;
+    size_t length_;
+};
+
+/**
+ * Split characters into views of the pieces between separators, like JS
+ * `text.split(separator, limit)` but without copying any piece. Separators
+ * are counted first so the Array is allocated once and written without
+ * initialization; single-character separators are counted 8 bytes at a
+ * time and found with memchr.
+ * @see https://developer.mozilla.org/en-US/docs/Web/JavaScript/Reference/Global_Objects/String/split
+ *
+ * @param text Characters to split; must outlive the views.
+ * @param separator Separator; empty one splits into single characters.
+ * @param limit Maximum number of pieces.
+ * @returns Views of pieces.
+ */
+inline Array<StringView> split(StringView text, StringView separator, size_t limit = std::numeric_limits<size_t>::max()) {
+    const char * chars = text.data(), * pattern = separator.data();
+    size_t length = text.length(), m = separator.length(), start = 0;
+
+    return Array<StringView>::from(String::countPieces(chars, length, pattern, m, limit), [&] (size_t) {
+        size_t end = m == 0 ? start + 1 : String::endOfPiece(chars, length, pattern, m, start);
+        StringView piece(chars + start, end - start);
+
+        start = end + m;
+        return piece;
+    });
+}
+
+inline void appendString(std::string & out, const StringView & value) {
+    out.append(value.data(), value.length());
+}
+
+/**
+ * Append string for Array::join, so joining an Array<String> copies each
+ * string once into the result.
+ */
+inline void appendString(std::string & out, const String & value) {
+    out.append(value.data(), value.length());
+}
+
+} // namespace js4cpp
+
+namespace std {
+
+template <> struct hash<js4cpp::String> {
+    size_t operator ()(const js4cpp::String & string) const {
+        return string.hash();
+    }
+};
+
+} // namespace std
+
+namespace js4cpp {
+
+inline String String::intern(const String & string) {
+    static std::mutex mutex;
+    static std::unordered_set<String> table;
+
+    // Inline strings have no buffer to share (see the declaration).
+    if (string.length_ <= SMALL_CAPACITY) {
+        return string;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex);
+    std::unordered_set<String>::const_iterator found = table.find(string);
+
+    // Copy, so that an interned slice does not keep its whole source alive.
+    return found != table.end() ? *found : *table.insert(String(string.data(), string.length_)).first;
+}
+
+} // namespace js4cpp
@@ -0,0 +1,170 @@
+#pragma once
+
+#include <string>
+
+#include <cppunit/TestCaller.h>
+#include <cppunit/TestCase.h>
+#include <cppunit/TestSuite.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+#include "string.hpp"
+
+class StringTest : public CppUnit::TestCase
+{
+public:
+    StringTest() : CppUnit::TestCase("String Test Case") {};
+
+    void testConstruct() {
+        using js4cpp::String;
+
+        CPPUNIT_ASSERT( String().length() == 0 && String() == String("") );
+        CPPUNIT_ASSERT( String("short").length() == 5 && String("short").str() == "short" );
+        CPPUNIT_ASSERT( String(*text).str() == *text && String(*text) == *text );
+
+        std::string owned = *text;
+        const char * chars = owned.data();
+        String adopted(std::move(owned));
+        CPPUNIT_ASSERT( adopted.data() == chars );
+
+        CPPUNIT_ASSERT( String("abc")[1] == 'b' && String("abc").charAt(2) == "c" && String("abc").charAt(3) == "" );
+        CPPUNIT_ASSERT( std::string(adopted.begin(), adopted.end()) == *text );
+    }
+
+    void testSlice() {
+        using js4cpp::String;
+
+        String string = *text;
+        String slice = string.slice(4, -4);
+        CPPUNIT_ASSERT( slice.str() == text->substr(4, text->size() - 8) );
+        CPPUNIT_ASSERT( slice.data() == string.data() + 4 );
+        CPPUNIT_ASSERT( slice.slice(-5).str() == text->substr(text->size() - 9, 5) );
+        CPPUNIT_ASSERT( string.slice(-3, 2) == "" && string.slice(0, 3) == "the" );
+        CPPUNIT_ASSERT( string.substring(9, 4) == "quick" && string.substring(40) == text->substr(40) );
+        CPPUNIT_ASSERT( String("  \t padded \n").trim() == "padded" );
+        CPPUNIT_ASSERT( String("  x").trimStart() == "x" && String("x  ").trimEnd() == "x" );
+    }
+
+    void testSearch() {
+        using js4cpp::String;
+
+        String string = *text;
+        CPPUNIT_ASSERT( string.indexOf("quick") == 4 && string.indexOf("the", 1) == 31 );
+        CPPUNIT_ASSERT( string.indexOf("cat") == -1 && string.indexOf("") == 0 && string.indexOf("", 1000) == ssize_t(text->size()) );
+        CPPUNIT_ASSERT( string.indexOf("g.") == ssize_t(text->size()) - 2 );
+        CPPUNIT_ASSERT( string.lastIndexOf("the") == 31 && string.lastIndexOf("the", 30) == 0 && string.lastIndexOf("cat") == -1 );
+        CPPUNIT_ASSERT( string.includes("lazy") && !string.includes("lazy", 40) );
+        CPPUNIT_ASSERT( string.startsWith("the") && string.startsWith("quick", 4) && !string.startsWith("quick") );
+        CPPUNIT_ASSERT( string.endsWith("dog.") && string.endsWith("the", 34) && !string.endsWith("dog") );
+    }
+
+    void testConcat() {
+        using js4cpp::String;
+
+        CPPUNIT_ASSERT( String("ab") + "cd" == "abcd" && String() + "x" == "x" );
+
+        String built;
+        std::string expected;
+        for (int i = 0; i < 1000; ++i) {
+            built += *text;
+            expected += *text;
+        }
+        CPPUNIT_ASSERT( built.length() == expected.size() );
+
+        String copy = built;
+        CPPUNIT_ASSERT( built.str() == expected && copy.slice(-4) == "dog." );
+
+        // Deep ropes must be released without recursing per level.
+        String deep;
+        for (int i = 0; i < 200000; ++i) {
+            deep = deep + *text;
+        }
+        CPPUNIT_ASSERT( deep.length() == 200000 * text->size() );
+    }
+
+    void testSplit() {
+        using js4cpp::Array;
+        using js4cpp::String;
+
+        Array<String> words = String(*text).split(" ");
+        CPPUNIT_ASSERT( words.length() == 9 && words[0] == "the" && words[8] == "dog." );
+        CPPUNIT_ASSERT( String(*text).split(" ", 2).length() == 2 && String(*text).split(" ", 2)[1] == "quick" );
+        CPPUNIT_ASSERT( String(*text).split(" ", 0).length() == 0 );
+        CPPUNIT_ASSERT( String("a,,b,").split(",").join("|") == "a||b|" );
+        CPPUNIT_ASSERT( String("").split(",").length() == 1 && String("abc").split("").join("-") == "a-b-c" );
+        CPPUNIT_ASSERT( String("a<>b<>c").split("<>").length() == 3 );
+
+        String joined = String(words.join(", "));
+        CPPUNIT_ASSERT( joined.split(", ").join(" ") == *text );
+    }
+
+    void testSplitViews() {
+        using js4cpp::Array;
+        using js4cpp::StringView;
+
+        std::string line = "id,name,,email@example.com,42,\"quoted\",last field";
+        Array<StringView> fields = js4cpp::split(line, ",");
+        CPPUNIT_ASSERT( fields.length() == 7 && fields[1] == "name" && fields[2] == "" && fields[6] == "last field" );
+        CPPUNIT_ASSERT( fields[3].data() == line.data() + 9 );
+        CPPUNIT_ASSERT( fields.join(",") == line );
+
+        CPPUNIT_ASSERT( js4cpp::split(line, ",", 3).length() == 3 && js4cpp::split(line, ",", 3)[2] == "" );
+        CPPUNIT_ASSERT( js4cpp::split(line, ",", 0).length() == 0 );
+        CPPUNIT_ASSERT( js4cpp::split(line, ", ").length() == 1 && js4cpp::split("", ",").length() == 1 );
+        CPPUNIT_ASSERT( js4cpp::split("a::b::", "::").join("|") == "a|b|" );
+        CPPUNIT_ASSERT( js4cpp::split("xyz", "").join("|") == "x|y|z" && js4cpp::split("xyz", "", 2).join("|") == "x|y" );
+
+        std::string wide(1000, 'x');
+        for (size_t i = 0; i < wide.size(); i += 7) {
+            wide[i] = ';';
+        }
+        Array<StringView> pieces = js4cpp::split(wide, ";");
+        CPPUNIT_ASSERT( pieces.length() == 144 && pieces[0] == "" && pieces[1] == "xxxxxx" && pieces[143] == "xxxxx" );
+        CPPUNIT_ASSERT( js4cpp::String::count(wide.data(), wide.size(), ';') == 143 );
+    }
+
+    void testReplace() {
+        using js4cpp::String;
+
+        CPPUNIT_ASSERT( String("a-b-c").replace("-", "+") == "a+b-c" );
+        CPPUNIT_ASSERT( String("a-b-c").replaceAll("-", "--") == "a--b--c" );
+        CPPUNIT_ASSERT( String("abc").replaceAll("", "_") == "_a_b_c_" );
+        CPPUNIT_ASSERT( String("abc").replace("x", "y") == "abc" && String("ab").repeat(3) == "ababab" );
+    }
+
+    void testCompareAndIntern() {
+        using js4cpp::String;
+
+        CPPUNIT_ASSERT( String("abc") < String("abd") && String("ab") < String("abc") && !(String("b") < String("a")) );
+        CPPUNIT_ASSERT( String("abc").compare("abc") == 0 && String("abc") != String("abcd") );
+        CPPUNIT_ASSERT( String(*text).hash() == String(*text).hash() && String("a").hash() != String("b").hash() );
+
+        String first = String::intern(String(*text).slice(4));
+        String second = String::intern(String(text->substr(4)));
+        CPPUNIT_ASSERT( first == second && first.data() == second.data() );
+
+        String small = String::intern(String(*text).slice(4, 9));
+        CPPUNIT_ASSERT( small == "quick" && small == String::intern("quick") && small.length() <= String::SMALL_CAPACITY );
+    }
+
+    void setUp() {
+        text = new std::string("the quick brown fox jumps over the lazy dog.");
+    }
+
+    void tearDown() {
+        delete text;
+    }
+
+    CPPUNIT_TEST_SUITE( StringTest );
+    CPPUNIT_TEST( testConstruct );
+    CPPUNIT_TEST( testSlice );
+    CPPUNIT_TEST( testSearch );
+    CPPUNIT_TEST( testConcat );
+    CPPUNIT_TEST( testSplit );
+    CPPUNIT_TEST( testSplitViews );
+    CPPUNIT_TEST( testReplace );
+    CPPUNIT_TEST( testCompareAndIntern );
+    CPPUNIT_TEST_SUITE_END();
+
+private:
+    std::string * text;
+};
@@ -1,10 +1,54 @@
 #include <cppunit/ui/text/TestRunner.h>
 
 #include "array.test.hpp"
+#include "array_buffer.test.hpp"
+#include "array_view.test.hpp"
+#include "bit_array.test.hpp"
+#include "concurrent_array.test.hpp"
+#include "coroutine.test.hpp"
+#include "data_view.test.hpp"
+#include "event_loop.test.hpp"
+#include "json.test.hpp"
+#include "json_stream.test.hpp"
+#include "map.test.hpp"
+#include "mapped_array.test.hpp"
+#include "promise.test.hpp"
+#include "queue.test.hpp"
+#include "serialization.test.hpp"
+#include "set.test.hpp"
+#include "set_operations.test.hpp"
+#include "soa_array.test.hpp"
+#include "string.test.hpp"
+#include "thread_pool.test.hpp"
+#include "typed_array.test.hpp"
+#include "value.test.hpp"
 
 int main() {
     CppUnit::TextUi::TestRunner runner;
     runner.addTest(ArrayTest::suite());
+    runner.addTest(BitArrayTest::suite());
+    runner.addTest(TypedArrayTest::suite());
+    runner.addTest(ArrayBufferTest::suite());
+    runner.addTest(DataViewTest::suite());
+    runner.addTest(ArrayViewTest::suite());
+    runner.addTest(MappedArrayTest::suite());
+    runner.addTest(SerializationTest::suite());
+    runner.addTest(JSONTest::suite());
+    runner.addTest(JSONStreamTest::suite());
+    runner.addTest(ValueTest::suite());
+    runner.addTest(StringTest::suite());
+    runner.addTest(MapTest::suite());
+    runner.addTest(SetTest::suite());
+    runner.addTest(SetOperationsTest::suite());
+    runner.addTest(SoAArrayTest::suite());
+    runner.addTest(ConcurrentArrayTest::suite());
+    runner.addTest(QueueTest::suite());
+    runner.addTest(ThreadPoolTest::suite());
+    runner.addTest(EventLoopTest::suite());
+    runner.addTest(PromiseTest::suite());
+#if defined(__cpp_impl_coroutine) && __cpp_impl_coroutine >= 201902L
+    runner.addTest(CoroutineTest::suite());
+#endif
     runner.run();
     return 0;
 }
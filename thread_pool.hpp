@@ -0,0 +1,680 @@
+/* Copyright (c) 2012 Kirill Dmitrenko <kdmitrenko@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is furnished
+ * to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * @file thread_pool.hpp
+ * Work-stealing thread pool parallel algorithms run on.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace js4cpp {
+
+/**
+ * Unit of work run by a ThreadPool.
+ */
+class Task
+{
+public:
+    virtual ~Task() {}
+
+    virtual void run() = 0;
+};
+
+/**
+ * Chase-Lev work-stealing deque. Its owner pushes and pops tasks at the
+ * bottom without contention; other threads steal from the top with a CAS.
+ * Buffers replaced on growth are kept until the deque is destroyed, since
+ * thieves may still be reading them.
+ */
+class WorkDeque
+{
+    struct Buffer {
+        Buffer(size_t capacity, Buffer * previous) :
+            mask(capacity - 1), items(new std::atomic<Task *>[capacity]), previous(previous) {}
+
+        ~Buffer() {
+            delete [] items;
+        }
+
+        Task * get(ptrdiff_t index) const {
+            return items[index & mask].load(std::memory_order_relaxed);
+        }
+
+        void put(ptrdiff_t index, Task * task) {
+            items[index & mask].store(task, std::memory_order_relaxed);
+        }
+
+        size_t mask;
+        std::atomic<Task *> * items;
+        Buffer * previous;
+    };
+
+public:
+    WorkDeque() : top_(0), bottom_(0), buffer_(new Buffer(256, 0)) {}
+
+    ~WorkDeque() {
+        for (Buffer * buffer = buffer_.load(); buffer;) {
+            Buffer * previous = buffer->previous;
+            delete buffer;
+            buffer = previous;
+        }
+    }
+
+    WorkDeque(const WorkDeque &) = delete;
+    WorkDeque & operator =(const WorkDeque &) = delete;
+
+    /**
+     * Get number of tasks; exact only when called by the owner.
+     */
+    size_t length() const {
+        ptrdiff_t bottom = bottom_.load(std::memory_order_relaxed);
+        ptrdiff_t top = top_.load(std::memory_order_relaxed);
+
+        return bottom > top ? bottom - top : 0;
+    }
+
+    /**
+     * Add a task to the bottom. Only the owner may call it.
+     */
+    void push(Task * task) {
+        ptrdiff_t bottom = bottom_.load(std::memory_order_relaxed);
+        ptrdiff_t top = top_.load(std::memory_order_acquire);
+        Buffer * buffer = buffer_.load(std::memory_order_relaxed);
+
+        if (bottom - top > ptrdiff_t(buffer->mask)) {
+            buffer = grow(buffer, top, bottom);
+        }
+        buffer->put(bottom, task);
+        bottom_.store(bottom + 1, std::memory_order_release);
+    }
+
+    /**
+     * Take the most recently pushed task. Only the owner may call it.
+     *
+     * @returns Task or null if the deque is empty.
+     */
+    Task * pop() {
+        ptrdiff_t bottom = bottom_.load(std::memory_order_relaxed) - 1;
+        Buffer * buffer = buffer_.load(std::memory_order_relaxed);
+
+        bottom_.store(bottom, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+
+        ptrdiff_t top = top_.load(std::memory_order_relaxed);
+
+        if (top > bottom) {
+            bottom_.store(bottom + 1, std::memory_order_relaxed);
+            return 0;
+        }
+
+        Task * task = buffer->get(bottom);
+
+        if (top == bottom) {
+            // The last task: race thieves for it.
+            if (!top_.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+                task = 0;
+            }
+            bottom_.store(bottom + 1, std::memory_order_relaxed);
+        }
+
+        return task;
+    }
+
+    /**
+     * Take the least recently pushed task. Any thread may call it.
+     *
+     * @returns Task or null if the deque is empty or another thread won the
+     *          race for the task.
+     */
+    Task * steal() {
+        ptrdiff_t top = top_.load(std::memory_order_acquire);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        ptrdiff_t bottom = bottom_.load(std::memory_order_acquire);
+
+        if (top >= bottom) {
+            return 0;
+        }
+
+        Task * task = buffer_.load(std::memory_order_acquire)->get(top);
+
+        if (!top_.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+            return 0;
+        }
+
+        return task;
+    }
+
+private:
+    Buffer * grow(Buffer * buffer, ptrdiff_t top, ptrdiff_t bottom) {
+        Buffer * bigger = new Buffer(2 * (buffer->mask + 1), buffer);
+
+        for (ptrdiff_t i = top; i < bottom; ++i) {
+            bigger->put(i, buffer->get(i));
+        }
+        buffer_.store(bigger, std::memory_order_release);
+
+        return bigger;
+    }
+
+    std::atomic<ptrdiff_t> top_;
+    char topPadding_[64 - sizeof(std::atomic<ptrdiff_t>)];
+    std::atomic<ptrdiff_t> bottom_;
+    std::atomic<Buffer *> buffer_;
+};
+
+/**
+ * Work-stealing thread pool. Every worker owns a WorkDeque: tasks spawned by
+ * a worker go to its own deque, idle workers steal from the others, and
+ * tasks scheduled from outside the pool go through a shared queue. Threads
+ * waiting for their tasks to finish run other tasks meanwhile, so parallel
+ * algorithms may be nested.
+ */
+class ThreadPool
+{
+    struct Worker {
+        WorkDeque deque;
+        std::thread thread;
+    };
+
+    struct Context {
+        ThreadPool * pool;
+        size_t index;
+        unsigned random;
+    };
+
+public:
+    /**
+     * Placement of worker threads on CPUs.
+     */
+    enum Affinity {
+        /** Threads are placed by the OS scheduler. */
+        Unpinned,
+        /** Every thread is pinned to one CPU the process may run on, in
+         *  order, so that workers stay near their caches (and memory nodes). */
+        Pinned
+    };
+
+    /**
+     * Create pool and start its workers.
+     *
+     * @param threads Number of workers; threads calling the pool's
+     *        algorithms work as well, so hardware threads minus one is the
+     *        default.
+     * @param affinity Placement of workers.
+     */
+    explicit ThreadPool(size_t threads = defaultThreads(), Affinity affinity = Unpinned) :
+        pending_(0), injectedLength_(0), sleeping_(0), stopping_(false) {
+        for (size_t i = 0; i < threads; ++i) {
+            workers_.push_back(std::unique_ptr<Worker>(new Worker()));
+        }
+        for (size_t i = 0; i < threads; ++i) {
+            workers_[i]->thread = std::thread(&ThreadPool::work, this, i);
+            if (affinity == Pinned) {
+                pin(workers_[i]->thread, i);
+            }
+        }
+    }
+
+    /**
+     * Run tasks left and stop workers.
+     */
+    ~ThreadPool() {
+        {
+            std::lock_guard<std::mutex> lock(sleepMutex_);
+            stopping_.store(true);
+        }
+        wakeup_.notify_all();
+        for (size_t i = 0; i < workers_.size(); ++i) {
+            workers_[i]->thread.join();
+        }
+        while (Task * task = find(current())) {
+            execute(task);
+        }
+    }
+
+    ThreadPool(const ThreadPool &) = delete;
+    ThreadPool & operator =(const ThreadPool &) = delete;
+
+    /**
+     * Get number of workers.
+     */
+    size_t size() const {
+        return workers_.size();
+    }
+
+    /**
+     * Run function asynchronously. As with std::thread, an exception
+     * escaping the function terminates the program.
+     *
+     * @tparam F Function type.
+     * @param f Function.
+     */
+    template <typename F>
+    void submit(F f) {
+        struct FunctionTask : Task {
+            explicit FunctionTask(F && f) : f(std::move(f)) {}
+
+            void run() {
+                F local(std::move(f));
+
+                delete this;
+                try {
+                    local();
+                } catch (...) {
+                    std::terminate();
+                }
+            }
+
+            F f;
+        };
+
+        schedule(new FunctionTask(std::move(f)));
+    }
+
+    /**
+     * Split [0, length) into given number of contiguous chunks of nearly
+     * equal size and process them in parallel. Calling thread processes the
+     * first chunk itself. If any chunk throws, the first exception (by chunk
+     * order) is rethrown once all chunks are done.
+     *
+     * @tparam Body Callable as body(chunk, begin, end).
+     * @param length Number of items.
+     * @param chunks Number of chunks.
+     * @param body Chunk processor.
+     */
+    template <typename Body>
+    void forEachChunk(size_t length, size_t chunks, Body body) {
+        struct ChunkTask : Task {
+            void run() {
+                try {
+                    (*body)(chunk, begin, end);
+                } catch (...) {
+                    *error = std::current_exception();
+                }
+                remaining->fetch_sub(1, std::memory_order_release);
+            }
+
+            Body * body;
+            size_t chunk, begin, end;
+            std::exception_ptr * error;
+            std::atomic<size_t> * remaining;
+        };
+
+        std::vector<std::exception_ptr> errors(chunks);
+        std::vector<ChunkTask> tasks(chunks);
+        std::atomic<size_t> remaining(chunks);
+
+        for (size_t chunk = 0; chunk < chunks; ++chunk) {
+            tasks[chunk].body = &body;
+            tasks[chunk].chunk = chunk;
+            tasks[chunk].begin = length * chunk / chunks;
+            tasks[chunk].end = length * (chunk + 1) / chunks;
+            tasks[chunk].error = &errors[chunk];
+            tasks[chunk].remaining = &remaining;
+        }
+        for (size_t chunk = chunks - 1; chunk > 0; --chunk) {
+            schedule(&tasks[chunk]);
+        }
+        tasks[0].run();
+        helpUntilDone(remaining);
+
+        for (size_t chunk = 0; chunk < chunks; ++chunk) {
+            if (errors[chunk]) {
+                std::rethrow_exception(errors[chunk]);
+            }
+        }
+    }
+
+    /**
+     * Process [0, length) in parallel, splitting it adaptively: a range is
+     * halved only while its worker has no other work queued, i.e. while
+     * other workers may be idle, and is otherwise processed in grain-sized
+     * pieces. If the body throws, remaining pieces are skipped and the first
+     * exception is rethrown.
+     *
+     * @tparam Body Callable as body(begin, end).
+     * @param length Number of items.
+     * @param body Range processor.
+     * @param grain Minimal number of items per piece, zero means automatic.
+     */
+    template <typename Body>
+    void parallelFor(size_t length, Body body, size_t grain = 0) {
+        struct Shared {
+            Body * body;
+            size_t grain;
+            std::atomic<size_t> remaining;
+            std::atomic<bool> failed;
+            std::exception_ptr error;
+        };
+
+        struct RangeTask : Task {
+            RangeTask(ThreadPool & pool, Shared & shared, size_t begin, size_t end, bool owned) :
+                pool(pool), shared(shared), begin(begin), end(end), owned(owned) {}
+
+            void run() {
+                while (begin < end && !shared.failed.load(std::memory_order_relaxed)) {
+                    if (end - begin >= 2 * shared.grain && pool.shouldSplit()) {
+                        size_t middle = begin + (end - begin) / 2;
+
+                        shared.remaining.fetch_add(1, std::memory_order_relaxed);
+                        pool.schedule(new RangeTask(pool, shared, middle, end, true));
+                        end = middle;
+                        continue;
+                    }
+
+                    size_t stop = std::min(begin + shared.grain, end);
+
+                    try {
+                        (*shared.body)(begin, stop);
+                    } catch (...) {
+                        if (!shared.failed.exchange(true)) {
+                            shared.error = std::current_exception();
+                        }
+                    }
+                    begin = stop;
+                }
+
+                bool heap = owned;
+
+                shared.remaining.fetch_sub(1, std::memory_order_release);
+                if (heap) {
+                    delete this;
+                }
+            }
+
+            ThreadPool & pool;
+            Shared & shared;
+            size_t begin, end;
+            bool owned;
+        };
+
+        if (length == 0) {
+            return;
+        }
+
+        Shared shared;
+
+        shared.body = &body;
+        shared.grain = grain ? grain : std::max<size_t>(length / (8 * (workers_.size() + 1)), 1);
+        shared.remaining.store(1);
+        shared.failed.store(false);
+
+        RangeTask root(*this, shared, 0, length, false);
+
+        root.run();
+        helpUntilDone(shared.remaining);
+
+        if (shared.error) {
+            std::rethrow_exception(shared.error);
+        }
+    }
+
+    /**
+     * Get pool used by parallel algorithms. It is created on first use with
+     * the default number of workers unless configure was called before, and
+     * is never destroyed, so its workers never race static destructors.
+     */
+    static ThreadPool & global() {
+        ThreadPool * pool = globalPool().load(std::memory_order_acquire);
+
+        if (!pool) {
+            std::lock_guard<std::mutex> lock(globalMutex());
+
+            pool = globalPool().load(std::memory_order_relaxed);
+            if (!pool) {
+                pool = new ThreadPool();
+                globalPool().store(pool, std::memory_order_release);
+            }
+        }
+
+        return *pool;
+    }
+
+    /**
+     * Create global pool with given settings.
+     *
+     * @param threads Number of workers.
+     * @param affinity Placement of workers.
+     * @throws std::logic_error If global pool is already created.
+     */
+    static void configure(size_t threads, Affinity affinity = Unpinned) {
+        std::lock_guard<std::mutex> lock(globalMutex());
+
+        if (globalPool().load(std::memory_order_relaxed)) {
+            throw std::logic_error("Global ThreadPool is already created");
+        }
+        globalPool().store(new ThreadPool(threads, affinity), std::memory_order_release);
+    }
+
+    /**
+     * Get default number of workers: hardware threads minus one.
+     */
+    static size_t defaultThreads() {
+        size_t threads = std::thread::hardware_concurrency();
+
+        return threads > 1 ? threads - 1 : 0;
+    }
+
+private:
+    /**
+     * How many times an idle worker looks for tasks before going to sleep.
+     */
+    static const unsigned SPINS = 64;
+
+    static Context & current() {
+        static thread_local Context context = {0, 0, 0};
+
+        return context;
+    }
+
+    static std::atomic<ThreadPool *> & globalPool() {
+        static std::atomic<ThreadPool *> pool(0);
+
+        return pool;
+    }
+
+    static std::mutex & globalMutex() {
+        static std::mutex mutex;
+
+        return mutex;
+    }
+
+    static void pin(std::thread & thread, size_t index) {
+#if defined(__linux__)
+        cpu_set_t allowed;
+
+        if (sched_getaffinity(0, sizeof(allowed), &allowed) != 0 || CPU_COUNT(&allowed) == 0) {
+            return;
+        }
+
+        size_t skip = index % CPU_COUNT(&allowed);
+
+        for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+            if (CPU_ISSET(cpu, &allowed) && skip-- == 0) {
+                cpu_set_t one;
+
+                CPU_ZERO(&one);
+                CPU_SET(cpu, &one);
+                pthread_setaffinity_np(thread.native_handle(), sizeof(one), &one);
+                return;
+            }
+        }
+#else
+        (void) thread;
+        (void) index;
+#endif
+    }
+
+    void schedule(Task * task) {
+        Context & context = current();
+
+        pending_.fetch_add(1);
+        if (context.pool == this) {
+            workers_[context.index]->deque.push(task);
+        } else {
+            std::lock_guard<std::mutex> lock(injectedMutex_);
+            injected_.push_back(task);
+            injectedLength_.fetch_add(1);
+        }
+        // Pairs with the check in work(): either the sleeping worker sees
+        // the pending task, or this thread sees the worker sleeping.
+        if (sleeping_.load() != 0) {
+            std::lock_guard<std::mutex> lock(sleepMutex_);
+            wakeup_.notify_one();
+        }
+    }
+
+    bool shouldSplit() {
+        Context & context = current();
+
+        if (workers_.empty()) {
+            return false;
+        }
+
+        return context.pool != this || workers_[context.index]->deque.length() == 0;
+    }
+
+    Task * find(Context & context) {
+        if (context.pool == this) {
+            if (Task * task = workers_[context.index]->deque.pop()) {
+                return task;
+            }
+        }
+        if (injectedLength_.load(std::memory_order_relaxed) != 0) {
+            std::lock_guard<std::mutex> lock(injectedMutex_);
+
+            if (!injected_.empty()) {
+                Task * task = injected_.front();
+
+                injected_.pop_front();
+                injectedLength_.fetch_sub(1);
+                return task;
+            }
+        }
+
+        size_t count = workers_.size();
+
+        if (count == 0) {
+            return 0;
+        }
+
+        // Victims are visited starting from a random one (xorshift).
+        if (context.random == 0) {
+            context.random = static_cast<unsigned>(reinterpret_cast<uintptr_t>(&context)) | 1;
+        }
+        context.random ^= context.random << 13;
+        context.random ^= context.random >> 17;
+        context.random ^= context.random << 5;
+
+        for (size_t i = 0, start = context.random % count; i < count; ++i) {
+            size_t victim = (start + i) % count;
+
+            if (context.pool == this && victim == context.index) {
+                continue;
+            }
+            if (Task * task = workers_[victim]->deque.steal()) {
+                return task;
+            }
+        }
+
+        return 0;
+    }
+
+    void execute(Task * task) {
+        pending_.fetch_sub(1);
+        task->run();
+    }
+
+    void helpUntilDone(const std::atomic<size_t> & remaining) {
+        Context & context = current();
+
+        while (remaining.load(std::memory_order_acquire) != 0) {
+            if (Task * task = find(context)) {
+                execute(task);
+            } else {
+                std::this_thread::yield();
+            }
+        }
+    }
+
+    void work(size_t index) {
+        Context & context = current();
+
+        context.pool = this;
+        context.index = index;
+        context.random = 2654435761u * (index + 1);
+
+        for (unsigned idle = 0;;) {
+            if (Task * task = find(context)) {
+                execute(task);
+                idle = 0;
+                continue;
+            }
+            if (stopping_.load() && pending_.load() == 0) {
+                return;
+            }
+            if (++idle < SPINS) {
+                std::this_thread::yield();
+                continue;
+            }
+            idle = 0;
+
+            std::unique_lock<std::mutex> lock(sleepMutex_);
+
+            sleeping_.fetch_add(1);
+            while (pending_.load() == 0 && !stopping_.load()) {
+                wakeup_.wait(lock);
+            }
+            sleeping_.fetch_sub(1);
+        }
+    }
+
+    std::vector<std::unique_ptr<Worker> > workers_;
+    std::atomic<size_t> pending_;
+    std::mutex injectedMutex_;
+    std::deque<Task *> injected_;
+    std::atomic<size_t> injectedLength_;
+    std::mutex sleepMutex_;
+    std::condition_variable wakeup_;
+    std::atomic<size_t> sleeping_;
+    std::atomic<bool> stopping_;
+};
+
+} // namespace js4cpp
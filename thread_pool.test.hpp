@@ -0,0 +1,125 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <cppunit/TestCaller.h>
+#include <cppunit/TestCase.h>
+#include <cppunit/TestSuite.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+#include "thread_pool.hpp"
+
+class ThreadPoolTest : public CppUnit::TestCase
+{
+public:
+    ThreadPoolTest() : CppUnit::TestCase("ThreadPool Test Case") {};
+
+    void testSubmit() {
+        std::atomic<int> counter(0);
+
+        {
+            js4cpp::ThreadPool pool(3);
+
+            CPPUNIT_ASSERT( pool.size() == 3 );
+            for (int i = 0; i < 1000; ++i) {
+                pool.submit([&counter] { ++counter; });
+            }
+        }
+        CPPUNIT_ASSERT( counter == 1000 );
+
+        {
+            js4cpp::ThreadPool idle(0);
+            idle.submit([&counter] { ++counter; });
+        }
+        CPPUNIT_ASSERT( counter == 1001 );
+    }
+
+    void testForEachChunk() {
+        js4cpp::ThreadPool pool(3);
+        std::vector<size_t> begins(8), ends(8);
+
+        pool.forEachChunk(100, 8, [&] (size_t chunk, size_t begin, size_t end) {
+            begins[chunk] = begin;
+            ends[chunk] = end;
+        });
+        CPPUNIT_ASSERT( begins[0] == 0 && ends[7] == 100 );
+        for (size_t chunk = 1; chunk < 8; ++chunk) {
+            CPPUNIT_ASSERT( begins[chunk] == ends[chunk - 1] );
+        }
+
+        bool thrown = false;
+        try {
+            pool.forEachChunk(100, 4, [] (size_t chunk, size_t, size_t) {
+                if (chunk >= 2) {
+                    throw std::out_of_range(chunk == 2 ? "first" : "second");
+                }
+            });
+        } catch (const std::out_of_range & error) {
+            thrown = std::string(error.what()) == "first";
+        }
+        CPPUNIT_ASSERT( thrown );
+    }
+
+    void testParallelFor() {
+        js4cpp::ThreadPool pool(3);
+        std::vector<int> visits(100000);
+
+        pool.parallelFor(visits.size(), [&] (size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i) {
+                ++visits[i];
+            }
+        });
+        CPPUNIT_ASSERT( std::count(visits.begin(), visits.end(), 1) == 100000 );
+
+        std::atomic<size_t> sum(0);
+        pool.parallelFor(64, [&] (size_t begin, size_t end) {
+            pool.parallelFor(1000, [&] (size_t innerBegin, size_t innerEnd) {
+                sum += (end - begin) * (innerEnd - innerBegin);
+            }, 10);
+        }, 1);
+        CPPUNIT_ASSERT( sum == 64000 );
+
+        bool thrown = false;
+        try {
+            pool.parallelFor(1000, [] (size_t begin, size_t) {
+                if (begin == 0) {
+                    throw std::runtime_error("failed");
+                }
+            }, 10);
+        } catch (const std::runtime_error &) {
+            thrown = true;
+        }
+        CPPUNIT_ASSERT( thrown );
+    }
+
+    void testGlobal() {
+        js4cpp::ThreadPool & pool = js4cpp::ThreadPool::global();
+
+        CPPUNIT_ASSERT( &pool == &js4cpp::ThreadPool::global() );
+
+        bool thrown = false;
+        try {
+            js4cpp::ThreadPool::configure(2);
+        } catch (const std::logic_error &) {
+            thrown = true;
+        }
+        CPPUNIT_ASSERT( thrown );
+    }
+
+    void setUp() {}
+
+    void tearDown() {}
+
+    CPPUNIT_TEST_SUITE( ThreadPoolTest );
+
+        CPPUNIT_TEST( testSubmit );
+        CPPUNIT_TEST( testForEachChunk );
+        CPPUNIT_TEST( testParallelFor );
+        CPPUNIT_TEST( testGlobal );
+
+    CPPUNIT_TEST_SUITE_END();
+};
@@ -0,0 +1,635 @@
+/* Copyright (c) 2012 Kirill Dmitrenko <kdmitrenko@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is furnished
+ * to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * @file typed_array.hpp
+ * JS-style typed arrays.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+#include <type_traits>
+
+#include "array.hpp"
+#include "array_buffer.hpp"
+
+namespace js4cpp {
+
+/**
+ * Conversion of JS numbers to integer elements which wraps them modulo
+ * 2^bits (like ToInt32/ToUint8 etc. do); floating point elements are
+ * converted with a plain cast.
+ *
+ * @tparam T Element type.
+ */
+template <typename T> struct WrappingConversion
+{
+    static T from(double value) {
+        return fromNumber(value, std::is_integral<T>());
+    }
+
+private:
+    static T fromNumber(double value, std::true_type) {
+        if (!std::isfinite(value)) {
+            return 0;
+        }
+
+        const double modulo = std::ldexp(1.0, std::numeric_limits<typename std::make_unsigned<T>::type>::digits);
+        double wrapped = std::fmod(std::trunc(value), modulo);
+
+        if (wrapped < 0) {
+            wrapped += modulo;
+        }
+
+        return static_cast<T>(static_cast<uint64_t>(wrapped));
+    }
+
+    static T fromNumber(double value, std::false_type) {
+        return static_cast<T>(value);
+    }
+};
+
+/**
+ * Conversion of JS numbers to bytes which clamps them to [0, 255] and rounds
+ * half to even, like Uint8ClampedArray does.
+ */
+struct ClampedConversion
+{
+    static uint8_t from(double value) {
+        if (!(value > 0)) {
+            return 0;
+        }
+        if (value >= 255) {
+            return 255;
+        }
+
+        double floor = std::floor(value), fraction = value - floor;
+
+        if (fraction > 0.5 || (fraction == 0.5 && std::fmod(floor, 2) != 0)) {
+            floor += 1;
+        }
+
+        return static_cast<uint8_t>(floor);
+    }
+};
+
+/**
+ * JS-style typed array: fixed length array of numbers stored packed in
+ * native byte order (little-endian on all supported targets) in an
+ * ArrayBuffer. Typed arrays created over the same buffer, subarrays
+ * included, alias the same bytes.
+ * Method vocabulary follows js4cpp::Array; every method is a plain counted
+ * loop over the packed storage.
+ * @see https://developer.mozilla.org/en-US/docs/Web/JavaScript/Reference/Global_Objects/TypedArray
+ *
+ * @tparam T Element type.
+ * @tparam Conversion Conversion of JS numbers to elements.
+ */
+template <typename T, typename Conversion = WrappingConversion<T> > class TypedArray
+{
+    static_assert(std::is_arithmetic<T>::value, "Typed arrays hold numbers only");
+
+public:
+    typedef T * iterator;
+    typedef const T * const_iterator;
+    typedef T value_type;
+
+    /**
+     * Size of an element in bytes.
+     * @see https://developer.mozilla.org/en-US/docs/Web/JavaScript/Reference/Global_Objects/TypedArray/BYTES_PER_ELEMENT
+     */
+    static const size_t BYTES_PER_ELEMENT = sizeof(T);
+
+    /**
+     * Create new zero-filled typed array of given length.
+     *
+     * @param length Length.
+     */
+    explicit TypedArray(size_t length = 0) :
+        buffer_(length * sizeof(T)), offset_(0), length_(length) {}
+
+    /**
+     * Create typed array viewing a part of given buffer without copying it.
+     *
+     * @param buffer Buffer.
+     * @param byteOffset Offset in the buffer; must be a multiple of element size.
+     * @param length Length in elements. Defaults to the rest of the buffer.
+     * @throws std::out_of_range If offset is misaligned or the view does not fit the buffer.
+     */
+    TypedArray(const ArrayBuffer & buffer, size_t byteOffset, size_t length = std::numeric_limits<size_t>::max()) :
+        buffer_(buffer), offset_(byteOffset / sizeof(T)), length_(length)
+    {
+        if (byteOffset % sizeof(T) != 0 || byteOffset > buffer.byteLength()) {
+            throw std::out_of_range("Invalid typed array offset");
+        }
+
+        size_t available = (buffer.byteLength() - byteOffset) / sizeof(T);
+
+        if (length == std::numeric_limits<size_t>::max()) {
+            length_ = available;
+        } else if (length > available) {
+            throw std::out_of_range("Invalid typed array length");
+        }
+    }
+
+    /**
+     * Create typed array viewing the whole buffer.
+     *
+     * @param buffer Buffer.
+     * @throws std::out_of_range If buffer's length is not a multiple of element size.
+     */
+    explicit TypedArray(const ArrayBuffer & buffer) :
+        buffer_(buffer), offset_(0), length_(buffer.byteLength() / sizeof(T))
+    {
+        if (buffer.byteLength() % sizeof(T) != 0) {
+            throw std::out_of_range("Buffer length should be a multiple of element size");
+        }
+    }
+
+    /**
+     * Create new typed array from any iterable, converting its elements.
+     * @see https://developer.mozilla.org/en-US/docs/Web/JavaScript/Reference/Global_Objects/TypedArray/from
+     *
+     * @param iterable Source.
+     * @returns New typed array.
+     */
+    template <typename Iterable>
+    static TypedArray from(const Iterable & iterable) {
+        TypedArray result(std::distance(std::begin(iterable), std::end(iterable)));
+        T * data = result.data();
+        size_t i = 0;
+
+        for (auto it = std::begin(iterable); it != std::end(iterable); ++it) {
+            data[i++] = convert(*it);
+        }
+
+        return result;
+    }
+
+    /**
+     * Create new typed array from given numbers.
+     * @see https://developer.mozilla.org/en-US/docs/Web/JavaScript/Reference/Global_Objects/TypedArray/of
+     *
+     * @param items Numbers.
+     * @returns New typed array.
+     */
+    template <typename... Args>
+    static TypedArray of(Args... items) {
+        const double values[] = { 0, static_cast<double>(items)... };
+        TypedArray result(sizeof...(items));
+
+        for (size_t i = 0; i < sizeof...(items); ++i) {
+            result.data()[i] = Conversion::from(values[i + 1]);
+        }
+
+        return result;
+    }
+
+    /**
+     * Get element under given index. Typed arrays never grow, so the index
+     * must be less than length.
+     *
+     * @param i Index.
+     * @returns Element.
+     */
+    T & operator [](size_t i) {
+        return data()[i];
+    }
+
+    /**
+     * Get element under given index.
+     *
+     * @param i Index.
+     * @returns Element.
+     */
+    const T & operator [](size_t i) const {
+        return data()[i];
+    }
+
+    /**
+     * Get array's length.
+     *
+     * @returns Length.
+     */
+    size_t length() const {
+        return length_;
+    }
+
+    /**
+     * Get array's length in bytes.
+     *
+     * @returns Length in bytes.
+     */
+    size_t byteLength() const {
+        return length_ * sizeof(T);
+    }
+
+    /**
+     * Get offset of the array in its storage in bytes.
+     *
+     * @returns Offset in bytes.
+     */
+    size_t byteOffset() const {
+        return offset_ * sizeof(T);
+    }
+
+    /**
+     * Get the buffer the array views.
+     *
+     * @returns Buffer.
+     */
+    const ArrayBuffer & buffer() const {
+        return buffer_;
+    }
+
+    T * data() {
+        return reinterpret_cast<T *>(buffer_.data()) + offset_;
+    }
+
+    const T * data() const {
+        return reinterpret_cast<const T *>(buffer_.data()) + offset_;
+    }
+
+    iterator begin() {
+        return data();
+    }
+
+    iterator end() {
+        return data() + length_;
+    }
+
+    const_iterator begin() const {
+        return data();
+    }
+
+    const_iterator end() const {
+        return data() + length_;
+    }
+
+    /**
+     * Store JS number under given index converting it to element type.
+     * Out of range writes are ignored like in JS.
+     *
+     * @param i Index.
+     * @param value Number.
+     */
+    void set(size_t i, double value) {
+        if (i < length_) {
+            data()[i] = Conversion::from(value);
+        }
+    }
+
+    /**
+     * Copy elements of given array (converting them) into this one starting
+     * from given offset.
+     * @see https://developer.mozilla.org/en-US/docs/Web/JavaScript/Reference/Global_Objects/TypedArray/set
+     *
+     * @param source Source array.
+     * @param offset Index to start writing at.
+     * @throws std::out_of_range If source does not fit.
+     */
+    template <typename Source>
+    typename std::enable_if<!std::is_arithmetic<Source>::value>::type
+    set(const Source & source, size_t offset = 0) {
+        size_t count = std::distance(std::begin(source), std::end(source));
+
+        if (offset > length_ || count > length_ - offset) {
+            throw std::out_of_range("Source is too large");
+        }
+
+        copyFrom(std::begin(source), count, data() + offset);
+    }
+
+    /**
+     * Create view of the elements from begin to end (not including) sharing
+     * storage with this array. Negative indexes are counted from the end.
+     * @see https://developer.mozilla.org/en-US/docs/Web/JavaScript/Reference/Global_Objects/TypedArray/subarray
+     *
+     * @param begin Begin index.
+     * @param end End index.
+     * @returns View.
+     */
+    TypedArray subarray(ssize_t begin = 0, ssize_t end = std::numeric_limits<ssize_t>::max()) const {
+        size_t from = relativeIndex(begin, length_), to = std::max(from, relativeIndex(end, length_));
+
+        return TypedArray(buffer_, (offset_ + from) * sizeof(T), to - from);
+    }
+
+    /**
+     * Create copy of the elements from begin to end (not including).
+     * Negative indexes are counted from the end.
+     * @see https://developer.mozilla.org/en-US/docs/Web/JavaScript/Reference/Global_Objects/TypedArray/slice
+     *
+     * @param begin Begin index.
+     * @param end End index.
+     * @returns New typed array.
+     */
+    TypedArray slice(ssize_t begin = 0, ssize_t end = std::numeric_limits<ssize_t>::max()) const {
+        size_t from = relativeIndex(begin, length_), to = std::max(from, relativeIndex(end, length_));
+        TypedArray result(to - from);
+
+        std::memcpy(result.data(), data() + from, (to - from) * sizeof(T));
+
+        return result;
+    }
+
+    /**
+     * Fill elements from start to end (not including) with given value.
+     * @see https://developer.mozilla.org/en-US/docs/Web/JavaScript/Reference/Global_Objects/TypedArray/fill
+     *
+     * @param value Value.
+     * @param start Start index.
+     * @param end End index.
+     */
+    void fill(T value, ssize_t start = 0, ssize_t end = std::numeric_limits<ssize_t>::max()) {
+        size_t from = relativeIndex(start, length_), to = relativeIndex(end, length_);
+        T * out = data();
+
+        for (size_t i = from; i < to; ++i) {
+            out[i] = value;
+        }
+    }
+
+    /**
+     * Get index of given value.
+     * @see https://developer.mozilla.org/en-US/docs/Web/JavaScript/Reference/Global_Objects/TypedArray/indexOf
+     *
+     * @param value Value.
+     * @param fromIndex The index at which to begin the search.
+     * @returns Value's index or -1.
+     */
+    ssize_t indexOf(T value, size_t fromIndex = 0) const {
+        const T * in = data();
+
+        for (size_t i = fromIndex; i < length_; ++i) {
+            if (in[i] == value) {
+                return i;
+            }
+        }
+
+        return -1;
+    }
+
+    /**
+     * Get the last index of given value.
+     * @see https://developer.mozilla.org/en-US/docs/Web/JavaScript/Reference/Global_Objects/TypedArray/lastIndexOf
+     *
+     * @param value Value.
+     * @returns Value's last index or -1.
+     */
+    ssize_t lastIndexOf(T value) const {
+        const T * in = data();
+
+        for (size_t i = length_; i-- > 0; ) {
+            if (in[i] == value) {
+                return i;
+            }
+        }
+
+        return -1;
+    }
+
+    /**
+     * Check whether the array contains given value.
+     * @see https://developer.mozilla.org/en-US/docs/Web/JavaScript/Reference/Global_Objects/TypedArray/includes
+     *
+     * @param value Value.
+     * @returns `true` if value was found.
+     */
+    bool includes(T value) const {
+        return indexOf(value) != -1;
+    }
+
+    /**
+     * Reverse order of elements in place.
+     */
+    void reverse() {
+        std::reverse(begin(), end());
+    }
+
+    /**
+     * Sort elements in place in numeric order (NaNs go last).
+     * @see https://developer.mozilla.org/en-US/docs/Web/JavaScript/Reference/Global_Objects/TypedArray/sort
+     */
+    void sort() {
+        std::sort(begin(), end(), [] (T a, T b) { return a < b || (b != b && a == a); });
+    }
+
+    /**
+     * Sort elements in place by given comparator.
+     *
+     * @param comparator Comparator.
+     */
+    template <typename Comparator>
+    void sort(Comparator comparator) {
+        std::sort(begin(), end(), comparator);
+    }
+
+    /**
+     * Call callback for every element.
+     * @see https://developer.mozilla.org/en-US/docs/Web/JavaScript/Reference/Global_Objects/TypedArray/forEach
+     *
+     * @param callback Callback accepting (element[, index[, array]]).
+     */
+    template <typename F>
+    void forEach(F callback) {
+        T * in = data();
+
+        for (size_t i = 0; i < length_; ++i) {
+            invokeCallback(callback, in[i], i, *this);
+        }
+    }
+
+    /**
+     * Create typed array of the same type from callback's results.
+     * @see https://developer.mozilla.org/en-US/docs/Web/JavaScript/Reference/Global_Objects/TypedArray/map
+     *
+     * @param callback Callback accepting (element[, index[, array]]).
+     * @returns New typed array.
+     */
+    template <typename F>
+    TypedArray map(F callback) const {
+        TypedArray result(length_);
+        const T * in = data();
+        T * out = result.data();
+
+        for (size_t i = 0; i < length_; ++i) {
+            out[i] = convert(invokeCallback(callback, in[i], i, *this));
+        }
+
+        return result;
+    }
+
+    /**
+     * Create typed array of elements passed the test.
+     * @see https://developer.mozilla.org/en-US/docs/Web/JavaScript/Reference/Global_Objects/TypedArray/filter
+     *
+     * @param test Test accepting (element[, index[, array]]).
+     * @returns New typed array.
+     */
+    template <typename F>
+    TypedArray filter(F test) const {
+        TypedArray scratch(length_);
+        const T * in = data();
+        T * out = scratch.data();
+        size_t count = 0;
+
+        for (size_t i = 0; i < length_; ++i) {
+            out[count] = in[i];
+            count += invokeCallback(test, in[i], i, *this) ? 1 : 0;
+        }
+
+        return scratch.slice(0, count);
+    }
+
+    /**
+     * Test whether all elements pass the test.
+     *
+     * @param condition Test accepting (element[, index[, array]]).
+     * @returns `true` if all elements passed.
+     */
+    template <typename F>
+    bool every(F condition) const {
+        const T * in = data();
+
+        for (size_t i = 0; i < length_; ++i) {
+            if (!invokeCallback(condition, in[i], i, *this)) {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    /**
+     * Test whether any element passes the test.
+     *
+     * @param condition Test accepting (element[, index[, array]]).
+     * @returns `true` if at least one element passed.
+     */
+    template <typename F>
+    bool some(F condition) const {
+        const T * in = data();
+
+        for (size_t i = 0; i < length_; ++i) {
+            if (invokeCallback(condition, in[i], i, *this)) {
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    /**
+     * Reduce elements to a single value (from left to right).
+     * @see https://developer.mozilla.org/en-US/docs/Web/JavaScript/Reference/Global_Objects/TypedArray/reduce
+     *
+     * @param callback Reducer accepting (accumulator, element[, index[, array]]).
+     * @param initialValue Accumulator initial value.
+     * @returns Accumulated value.
+     */
+    template <typename F, typename R>
+    R reduce(F callback, R initialValue) const {
+        const T * in = data();
+
+        for (size_t i = 0; i < length_; ++i) {
+            initialValue = invokeReducer(callback, initialValue, in[i], i, *this);
+        }
+
+        return initialValue;
+    }
+
+    /**
+     * Sum all elements.
+     *
+     * @returns Sum.
+     */
+    T reduce() const {
+        return reduce(std::plus<T>(), T());
+    }
+
+    /**
+     * Copy elements to a generic array.
+     *
+     * @returns Array.
+     */
+    Array<T> toArray() const {
+        return Array<T>(begin(), end());
+    }
+
+private:
+    template <typename U>
+    static T convert(U value) {
+        return convert(value, std::is_same<T, U>());
+    }
+
+    template <typename U>
+    static T convert(U value, std::true_type) {
+        return value;
+    }
+
+    template <typename U>
+    static T convert(U value, std::false_type) {
+        return Conversion::from(static_cast<double>(value));
+    }
+
+    template <typename Iterator>
+    static void copyFrom(Iterator source, size_t count, T * out) {
+        // Source may be a view of this very storage, so go through a copy.
+        std::unique_ptr<T[]> copy(new T[count]);
+
+        for (size_t i = 0; i < count; ++i, ++source) {
+            copy[i] = convert(*source);
+        }
+        std::memcpy(out, copy.get(), count * sizeof(T));
+    }
+
+    static void copyFrom(const T * source, size_t count, T * out) {
+        std::memmove(out, source, count * sizeof(T));
+    }
+
+    ArrayBuffer buffer_;
+    size_t offset_;
+    size_t length_;
+};
+
+template <typename T, typename Conversion>
+const size_t TypedArray<T, Conversion>::BYTES_PER_ELEMENT;
+
+typedef TypedArray<int8_t> Int8Array;
+typedef TypedArray<uint8_t> Uint8Array;
+typedef TypedArray<uint8_t, ClampedConversion> Uint8ClampedArray;
+typedef TypedArray<int16_t> Int16Array;
+typedef TypedArray<uint16_t> Uint16Array;
+typedef TypedArray<int32_t> Int32Array;
+typedef TypedArray<uint32_t> Uint32Array;
+typedef TypedArray<float> Float32Array;
+typedef TypedArray<double> Float64Array;
+
+} // namespace js4cpp
@@ -0,0 +1,123 @@
+#pragma once
+
+#include <cmath>
+
+#include <cppunit/TestCaller.h>
+#include <cppunit/TestCase.h>
+#include <cppunit/TestSuite.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+#include "typed_array.hpp"
+
+class TypedArrayTest : public CppUnit::TestCase
+{
+public:
+    TypedArrayTest() : CppUnit::TestCase("TypedArray Test Case") {};
+
+    void setUp() {
+        arr = new js4cpp::Int32Array(10);
+
+        for (size_t i = 0; i < arr->length(); ++i) {
+            (*arr)[i] = int32_t(i);
+        }
+    }
+
+    void testLength() {
+        CPPUNIT_ASSERT( arr->length() == 10 );
+        CPPUNIT_ASSERT( arr->byteLength() == 40 );
+        CPPUNIT_ASSERT( js4cpp::Float64Array(3)[2] == 0 );
+    }
+
+    void testConversion() {
+        js4cpp::Uint8Array bytes(1);
+        bytes.set(0, 257);
+        CPPUNIT_ASSERT( bytes[0] == 1 );
+        bytes.set(0, -1);
+        CPPUNIT_ASSERT( bytes[0] == 255 );
+
+        js4cpp::Int8Array signedBytes = js4cpp::Int8Array::of(128, -129, 3.7, NAN);
+        CPPUNIT_ASSERT( signedBytes[0] == -128 && signedBytes[1] == 127 && signedBytes[2] == 3 && signedBytes[3] == 0 );
+
+        js4cpp::Uint8ClampedArray clamped = js4cpp::Uint8ClampedArray::of(300, -5, 1.5, 2.5, 2.6);
+        CPPUNIT_ASSERT( clamped[0] == 255 && clamped[1] == 0 && clamped[2] == 2 && clamped[3] == 2 && clamped[4] == 3 );
+    }
+
+    void testSubarray() {
+        js4cpp::Int32Array view = arr->subarray(2, -2);
+        CPPUNIT_ASSERT( view.length() == 6 && view[0] == 2 && view.byteOffset() == 8 );
+
+        view[0] = 42;
+        CPPUNIT_ASSERT( (*arr)[2] == 42 );
+
+        js4cpp::Int32Array copy = arr->slice(2, 4);
+        copy[0] = 0;
+        CPPUNIT_ASSERT( copy.length() == 2 && (*arr)[2] == 42 );
+    }
+
+    void testSet() {
+        arr->set(js4cpp::Float64Array::of(1.9, -2.1), 8);
+        CPPUNIT_ASSERT( (*arr)[8] == 1 && (*arr)[9] == -2 );
+
+        arr->set(arr->subarray(0, 5), 1);
+        CPPUNIT_ASSERT( (*arr)[1] == 0 && (*arr)[5] == 4 );
+
+        bool thrown = false;
+        try {
+            arr->set(js4cpp::Int32Array(3), 8);
+        } catch (const std::out_of_range &) {
+            thrown = true;
+        }
+        CPPUNIT_ASSERT( thrown );
+    }
+
+    void testFillIndexOf() {
+        arr->fill(7, -3);
+        CPPUNIT_ASSERT( arr->indexOf(7) == 7 && arr->lastIndexOf(7) == 9 && arr->indexOf(8) == -1 );
+        CPPUNIT_ASSERT( arr->includes(6) && !arr->includes(9) );
+    }
+
+    void testSort() {
+        js4cpp::Float64Array numbers = js4cpp::Float64Array::of(3, NAN, -1, 2);
+        numbers.sort();
+        CPPUNIT_ASSERT( numbers[0] == -1 && numbers[2] == 3 && std::isnan(numbers[3]) );
+
+        arr->sort(std::greater<int32_t>());
+        CPPUNIT_ASSERT( (*arr)[0] == 9 );
+    }
+
+    void testIteration() {
+        js4cpp::Int32Array doubled = arr->map([] (int32_t x) { return x * 2; });
+        CPPUNIT_ASSERT( doubled[9] == 18 );
+
+        js4cpp::Uint8Array wrapped = js4cpp::Uint8Array::of(200).map([] (uint8_t x) { return x * 2; });
+        CPPUNIT_ASSERT( wrapped[0] == 144 );
+
+        js4cpp::Int32Array odd = arr->filter([] (int32_t x) { return x % 2 != 0; });
+        CPPUNIT_ASSERT( odd.length() == 5 && odd[4] == 9 );
+
+        CPPUNIT_ASSERT( arr->reduce() == 45 );
+        CPPUNIT_ASSERT( arr->reduce([] (double sum, int32_t x, size_t i) { return sum + x * double(i); }, 0.0) == 285 );
+        CPPUNIT_ASSERT( arr->every([] (int32_t x, size_t i) { return x == int32_t(i); }) );
+        CPPUNIT_ASSERT( !arr->some([] (int32_t x) { return x > 9; }) );
+        CPPUNIT_ASSERT( arr->toArray().length() == 10 );
+    }
+
+    void tearDown() {
+        delete arr;
+    }
+
+    CPPUNIT_TEST_SUITE( TypedArrayTest );
+
+        CPPUNIT_TEST( testLength );
+        CPPUNIT_TEST( testConversion );
+        CPPUNIT_TEST( testSubarray );
+        CPPUNIT_TEST( testSet );
+        CPPUNIT_TEST( testFillIndexOf );
+        CPPUNIT_TEST( testSort );
+        CPPUNIT_TEST( testIteration );
+
+    CPPUNIT_TEST_SUITE_END();
+
+private:
+    js4cpp::Int32Array * arr;
+};
@@ -0,0 +1,768 @@
+/* Copyright (c) 2012 Kirill Dmitrenko <kdmitrenko@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is furnished
+ * to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * @file value.hpp
+ * Dynamically typed JS value.
+ */
+
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "array.hpp"
+#include "array_view.hpp"
+#include "json.hpp"
+
+namespace js4cpp {
+
+class Value;
+
+/**
+ * Properties of a JS object in insertion order.
+ */
+typedef std::vector<std::pair<std::string, Value> > Properties;
+
+/**
+ * Dynamically typed JS value (what `var` holds) packed into 64 bits with
+ * NaN-boxing: numbers are stored as plain doubles (all NaNs are made
+ * canonical), everything else lives in the payload of negative quiet NaNs
+ * which no number uses:
+ *
+ * | Top 16 bits | Payload (48 bits)               |
+ * |-------------|---------------------------------|
+ * | 0xfff9      | undefined                       |
+ * | 0xfffa      | null                            |
+ * | 0xfffb      | boolean                         |
+ * | 0xfffc      | pointer to string               |
+ * | 0xfffd      | pointer to array                |
+ * | 0xfffe      | pointer to object               |
+ *
+ * Strings, arrays and objects are shared between copies of a value (like
+ * JS references) and freed with the last copy. Reference counting is not
+ * atomic: a value and its copies must stay on one thread.
+ * @see https://developer.mozilla.org/en-US/docs/Web/JavaScript/Data_structures
+ */
+class Value
+{
+public:
+    /**
+     * Value types, see `typeof`.
+     */
+    enum Type {
+        UndefinedType,
+        NullType,
+        BooleanType,
+        NumberType,
+        StringType,
+        ArrayType,
+        ObjectType
+    };
+
+    /**
+     * Create undefined.
+     */
+    Value() : bits_(tagged(UndefinedTag, 0)) {}
+
+    /**
+     * Create null.
+     */
+    Value(std::nullptr_t) : bits_(tagged(NullTag, 0)) {}
+
+    /**
+     * Create boolean.
+     */
+    Value(bool value) : bits_(tagged(BooleanTag, value)) {}
+
+    /**
+     * Create number.
+     */
+    template <typename T>
+    Value(T value, typename std::enable_if<std::is_arithmetic<T>::value && !std::is_same<T, bool>::value>::type * = 0) {
+        setNumber(static_cast<double>(value));
+    }
+
+    /**
+     * Create string.
+     */
+    Value(const char * value) : bits_(boxed(StringTag, new StringCell(value))) {}
+
+    Value(const std::string & value) : bits_(boxed(StringTag, new StringCell(value))) {}
+
+    /**
+     * Create array holding copies of given values.
+     */
+    Value(const Array<Value> & value);
+
+    /**
+     * Create empty object.
+     *
+     * @returns Object.
+     */
+    static Value object();
+
+    Value(const Value & other) : bits_(other.bits_) {
+        retain();
+    }
+
+    Value(Value && other) : bits_(other.bits_) {
+        other.bits_ = tagged(UndefinedTag, 0);
+    }
+
+    Value & operator =(Value other) {
+        std::swap(bits_, other.bits_);
+        return *this;
+    }
+
+    ~Value() {
+        release();
+    }
+
+    /**
+     * Get value's type.
+     *
+     * @returns Type.
+     */
+    Type type() const {
+        if (bits_ < TAGGED) {
+            return NumberType;
+        }
+
+        switch (bits_ >> 48) {
+        case UndefinedTag: return UndefinedType;
+        case NullTag: return NullType;
+        case BooleanTag: return BooleanType;
+        case StringTag: return StringType;
+        case ArrayTag: return ArrayType;
+        default: return ObjectType;
+        }
+    }
+
+    /**
+     * Get name of value's type like JS `typeof` does ("object" for null and arrays).
+     * @see https://developer.mozilla.org/en-US/docs/Web/JavaScript/Reference/Operators/typeof
+     *
+     * @returns Type name.
+     */
+    const char * typeOf() const {
+        static const char * const names[] = { "undefined", "object", "boolean", "number", "string", "object", "object" };
+        return names[type()];
+    }
+
+    bool isUndefined() const { return bits_ == tagged(UndefinedTag, 0); }
+    bool isNull() const { return bits_ == tagged(NullTag, 0); }
+    bool isBoolean() const { return (bits_ >> 48) == BooleanTag; }
+    bool isNumber() const { return bits_ < TAGGED; }
+    bool isString() const { return (bits_ >> 48) == StringTag; }
+    bool isArray() const { return (bits_ >> 48) == ArrayTag; }
+    bool isObject() const { return (bits_ >> 48) == ObjectTag; }
+
+    /**
+     * Get number. Value must be a number.
+     */
+    double asNumber() const {
+        return number_;
+    }
+
+    /**
+     * Get boolean. Value must be a boolean.
+     */
+    bool asBoolean() const {
+        return (bits_ & PAYLOAD) != 0;
+    }
+
+    /**
+     * Get string. Value must be a string.
+     */
+    const std::string & asString() const {
+        return cell<StringCell>()->value;
+    }
+
+    /**
+     * Get array. Value must be an array. Changes are seen by all copies.
+     */
+    Array<Value> & asArray() const;
+
+    /**
+     * Get object's properties. Value must be an object. Changes are seen by all copies.
+     */
+    Properties & asObject() const;
+
+    /**
+     * Get property of an object or element of an array (by numeric key).
+     *
+     * @param key Property name.
+     * @returns Property value or undefined.
+     */
+    Value get(const std::string & key) const;
+
+    /**
+     * Set property of an object.
+     *
+     * @param key Property name.
+     * @param value Property value.
+     */
+    void set(const std::string & key, const Value & value);
+
+    /**
+     * Convert to number like JS `Number(value)`.
+     * @see https://developer.mozilla.org/en-US/docs/Web/JavaScript/Reference/Global_Objects/Number#number_coercion
+     *
+     * @returns Number.
+     */
+    double toNumber() const;
+
+    /**
+     * Convert to boolean like JS `Boolean(value)`.
+     *
+     * @returns Boolean.
+     */
+    bool toBoolean() const;
+
+    /**
+     * Convert to string like JS `String(value)`.
+     *
+     * @returns String.
+     */
+    std::string toString() const;
+
+    /**
+     * Compare like JS `===`.
+     */
+    bool strictEquals(const Value & other) const;
+
+    /**
+     * Compare like JS `==`.
+     */
+    bool looselyEquals(const Value & other) const;
+
+    /**
+     * Compare like JS SameValueZero (`===`, but NaN equals NaN), as used by
+     * `includes`, Map and Set.
+     */
+    bool sameValueZero(const Value & other) const {
+        return (isNumber() && other.isNumber() && number_ != number_ && other.number_ != other.number_) || strictEquals(other);
+    }
+
+    /**
+     * Strict equality, so that indexOf and friends behave like in JS.
+     */
+    bool operator ==(const Value & other) const {
+        return strictEquals(other);
+    }
+
+    bool operator !=(const Value & other) const {
+        return !strictEquals(other);
+    }
+
+    /**
+     * Compare like JS `<`: strings are compared by code units, everything
+     * else as numbers.
+     */
+    bool operator <(const Value & other) const;
+
+    /**
+     * Get raw 64-bit representation.
+     *
+     * @returns Bits.
+     */
+    uint64_t bits() const {
+        return bits_;
+    }
+
+private:
+    enum Tag {
+        UndefinedTag = 0xfff9,
+        NullTag = 0xfffa,
+        BooleanTag = 0xfffb,
+        StringTag = 0xfffc,
+        ArrayTag = 0xfffd,
+        ObjectTag = 0xfffe
+    };
+
+    static const uint64_t TAGGED = uint64_t(UndefinedTag) << 48;
+    static const uint64_t PAYLOAD = (uint64_t(1) << 48) - 1;
+    static const uint64_t CANONICAL_NAN = 0x7ff8000000000000ULL;
+
+    struct Cell {
+        Cell() : refs(1) {}
+        size_t refs;
+    };
+
+    struct StringCell : Cell {
+        explicit StringCell(const std::string & string) : value(string) {}
+        std::string value;
+    };
+
+    struct ArrayCell;
+    struct ObjectCell;
+
+    static uint64_t tagged(Tag tag, uint64_t payload) {
+        return (uint64_t(tag) << 48) | payload;
+    }
+
+    static uint64_t boxed(Tag tag, const Cell * cell) {
+        return tagged(tag, reinterpret_cast<uintptr_t>(cell));
+    }
+
+    template <typename C>
+    C * cell() const {
+        return reinterpret_cast<C *>(static_cast<uintptr_t>(bits_ & PAYLOAD));
+    }
+
+    void setNumber(double value) {
+        if (value != value) {
+            bits_ = CANONICAL_NAN;
+        } else {
+            number_ = value;
+        }
+    }
+
+    bool isCell() const {
+        return (bits_ >> 48) >= StringTag;
+    }
+
+    void retain() const {
+        if (isCell()) {
+            ++cell<Cell>()->refs;
+        }
+    }
+
+    void release();
+
+    // Storage for a NaN-boxed number aliases the double itself, so arrays
+    // of numbers are arrays of doubles in memory.
+    union {
+        uint64_t bits_;
+        double number_;
+    };
+};
+
+struct Value::ArrayCell : Value::Cell {
+    explicit ArrayCell(const Array<Value> & array) : value(array) {}
+    Array<Value> value;
+};
+
+struct Value::ObjectCell : Value::Cell {
+    Properties value;
+};
+
+inline Value::Value(const Array<Value> & value) : bits_(boxed(ArrayTag, new ArrayCell(value))) {}
+
+inline Value Value::object() {
+    Value result;
+    result.bits_ = boxed(ObjectTag, new ObjectCell());
+    return result;
+}
+
+inline void Value::release() {
+    if (!isCell() || --cell<Cell>()->refs != 0) {
+        return;
+    }
+
+    switch (bits_ >> 48) {
+    case StringTag: delete cell<StringCell>(); break;
+    case ArrayTag: delete cell<ArrayCell>(); break;
+    default: delete cell<ObjectCell>(); break;
+    }
+}
+
+inline Array<Value> & Value::asArray() const {
+    return cell<ArrayCell>()->value;
+}
+
+inline Properties & Value::asObject() const {
+    return cell<ObjectCell>()->value;
+}
+
+inline Value Value::get(const std::string & key) const {
+    if (isObject()) {
+        const Properties & properties = asObject();
+
+        for (size_t i = 0; i < properties.size(); ++i) {
+            if (properties[i].first == key) {
+                return properties[i].second;
+            }
+        }
+    } else if (isArray()) {
+        if (key == "length") {
+            return Value(asArray().length());
+        }
+
+        char * end;
+        unsigned long index = std::strtoul(key.c_str(), &end, 10);
+
+        if (!key.empty() && *end == '\0' && index < asArray().length()) {
+            return asArray().begin()[index];
+        }
+    } else if (isString() && key == "length") {
+        return Value(asString().size());
+    }
+
+    return Value();
+}
+
+inline void Value::set(const std::string & key, const Value & value) {
+    if (!isObject()) {
+        return;
+    }
+
+    Properties & properties = asObject();
+
+    for (size_t i = 0; i < properties.size(); ++i) {
+        if (properties[i].first == key) {
+            properties[i].second = value;
+            return;
+        }
+    }
+    properties.push_back(std::make_pair(key, value));
+}
+
+inline double Value::toNumber() const {
+    switch (type()) {
+    case NumberType:
+        return number_;
+    case BooleanType:
+        return asBoolean() ? 1 : 0;
+    case NullType:
+        return 0;
+    case StringType: {
+        const std::string & string = asString();
+        size_t begin = string.find_first_not_of(" \t\n\r\f\v"), end = string.find_last_not_of(" \t\n\r\f\v");
+
+        if (begin == std::string::npos) {
+            return 0;
+        }
+
+        std::string trimmed = string.substr(begin, end - begin + 1);
+        if (trimmed == "Infinity" || trimmed == "+Infinity") {
+            return std::numeric_limits<double>::infinity();
+        }
+        if (trimmed == "-Infinity") {
+            return -std::numeric_limits<double>::infinity();
+        }
+
+        // Hex, octal and binary integers: unsigned, digits of the radix only.
+        if (trimmed.size() > 1 && trimmed[0] == '0' && std::strchr("xXoObB", trimmed[1])) {
+            int radix = trimmed[1] == 'x' || trimmed[1] == 'X' ? 16 : trimmed[1] == 'o' || trimmed[1] == 'O' ? 8 : 2;
+            double result = 0;
+
+            if (trimmed.size() == 2) {
+                return std::numeric_limits<double>::quiet_NaN();
+            }
+            for (size_t i = 2; i < trimmed.size(); ++i) {
+                char c = trimmed[i];
+                int digit = c >= '0' && c <= '9' ? c - '0' : c >= 'a' && c <= 'f' ? c - 'a' + 10 : c >= 'A' && c <= 'F' ? c - 'A' + 10 : radix;
+
+                if (digit >= radix) {
+                    return std::numeric_limits<double>::quiet_NaN();
+                }
+                result = result * radix + digit;
+            }
+
+            return result;
+        }
+
+        // strtod accepts things JS does not (e.g. "inf", "nan", hex floats,
+        // signed hex), so only decimal literal characters are let through.
+        const char * text = trimmed.c_str();
+        char * parsed;
+        double result = std::strtod(text, &parsed);
+
+        if (*parsed != '\0' || trimmed.find_first_not_of("0123456789+-.eE") != std::string::npos) {
+            return std::numeric_limits<double>::quiet_NaN();
+        }
+
+        return result;
+    }
+    case ArrayType:
+        return Value(toString()).toNumber();
+    default:
+        return std::numeric_limits<double>::quiet_NaN();
+    }
+}
+
+inline bool Value::toBoolean() const {
+    switch (type()) {
+    case NumberType:
+        return number_ == number_ && number_ != 0;
+    case BooleanType:
+        return asBoolean();
+    case StringType:
+        return !asString().empty();
+    case ArrayType:
+    case ObjectType:
+        return true;
+    default:
+        return false;
+    }
+}
+
+inline std::string Value::toString() const {
+    switch (type()) {
+    case UndefinedType:
+        return "undefined";
+    case NullType:
+        return "null";
+    case BooleanType:
+        return asBoolean() ? "true" : "false";
+    case NumberType: {
+        std::string result;
+        appendNumber(result, number_);
+        return result;
+    }
+    case StringType:
+        return asString();
+    case ArrayType:
+        return asArray().join();
+    default:
+        return "[object Object]";
+    }
+}
+
+inline bool Value::strictEquals(const Value & other) const {
+    if (isNumber() && other.isNumber()) {
+        return number_ == other.number_;
+    }
+    if (isString() && other.isString()) {
+        return asString() == other.asString();
+    }
+
+    return bits_ == other.bits_;
+}
+
+inline bool Value::looselyEquals(const Value & other) const {
+    Type a = type(), b = other.type();
+
+    if (a == b) {
+        return strictEquals(other);
+    }
+    if ((a == NullType || a == UndefinedType) && (b == NullType || b == UndefinedType)) {
+        return true;
+    }
+    if (a == NullType || a == UndefinedType || b == NullType || b == UndefinedType) {
+        return false;
+    }
+    if (a == ObjectType || b == ObjectType || a == ArrayType || b == ArrayType) {
+        // Objects are converted to primitives (strings) first.
+        Value left = (a == ObjectType || a == ArrayType) ? Value(toString()) : *this;
+        Value right = (b == ObjectType || b == ArrayType) ? Value(other.toString()) : other;
+
+        return left.looselyEquals(right);
+    }
+
+    return toNumber() == other.toNumber();
+}
+
+inline bool Value::operator <(const Value & other) const {
+    if (isNumber() && other.isNumber()) {
+        return number_ < other.number_;
+    }
+
+    Value left = (isObject() || isArray()) ? Value(toString()) : *this;
+    Value right = (other.isObject() || other.isArray()) ? Value(other.toString()) : other;
+
+    if (left.isString() && right.isString()) {
+        return left.asString() < right.asString();
+    }
+
+    return left.toNumber() < right.toNumber();
+}
+
+/**
+ * Append string form of a value for Array::join: like String(value), but
+ * undefined and null are written as empty strings.
+ */
+inline void appendString(std::string & out, const Value & value) {
+    if (!value.isUndefined() && !value.isNull()) {
+        out += value.toString();
+    }
+}
+
+/**
+ * Kinds of elements an Array<Value> holds, after V8's elements kinds.
+ */
+enum ElementsKind {
+    /** All elements are numbers with int32 values. */
+    PackedSmiElements,
+    /** All elements are numbers. */
+    PackedDoubleElements,
+    /** Anything else. */
+    PackedElements
+};
+
+/**
+ * Detect kind of elements of given array with a single linear scan.
+ *
+ * @param array Array.
+ * @returns Elements kind.
+ */
+inline ElementsKind elementsKind(const Array<Value> & array) {
+    ElementsKind kind = PackedSmiElements;
+
+    for (const Value & item : array) {
+        if (!item.isNumber()) {
+            return PackedElements;
+        }
+
+        // Range is checked before the number is truncated, so NaN, infinities
+        // and big numbers never reach the (undefined for them) cast.
+        double number = item.asNumber();
+        if (kind == PackedSmiElements && !(
+            number >= std::numeric_limits<int32_t>::min() && number <= std::numeric_limits<int32_t>::max() &&
+            number == std::trunc(number) && !(number == 0 && std::signbit(number))
+        )) {
+            kind = PackedDoubleElements;
+        }
+    }
+
+    return kind;
+}
+
+/**
+ * View array of numbers as packed doubles without copying. Since numbers
+ * are NaN-boxed as plain doubles, an array holding only numbers already is
+ * a packed double array, so numeric code can run over the view at full
+ * speed.
+ *
+ * @param array Array.
+ * @returns View of doubles or empty view if some element is not a number.
+ */
+inline ArrayView<double> numbers(const Array<Value> & array) {
+    if (elementsKind(array) == PackedElements) {
+        return ArrayView<double>();
+    }
+
+    static_assert(sizeof(Value) == sizeof(double), "Value must be NaN-boxed into 64 bits");
+    return ArrayView<double>(reinterpret_cast<const double *>(array.begin()), array.length());
+}
+
+/**
+ * JSON codec of dynamic values: parses any JSON and writes any value
+ * (undefined becomes null, like in JS arrays).
+ */
+template <> struct JSONCodec<Value> {
+    static Value parse(JSONParser & parser) {
+        switch (parser.peek()) {
+        case '"':
+            return Value(JSONCodec<std::string>::parse(parser));
+        case '[':
+            return Value(JSONCodec<Array<Value> >::parse(parser));
+        case '{': {
+            Value result = Value::object();
+            std::string key;
+
+            parser.expect('{');
+            if (parser.consume('}')) {
+                return result;
+            }
+            do {
+                key.clear();
+                parser.parseString(key);
+                parser.expect(':');
+                result.set(key, parse(parser));
+            } while (parser.consume(','));
+            parser.expect('}');
+
+            return result;
+        }
+        default:
+            if (parser.consumeLiteral("true")) {
+                return Value(true);
+            }
+            if (parser.consumeLiteral("false")) {
+                return Value(false);
+            }
+            if (parser.consumeLiteral("null")) {
+                return Value(nullptr);
+            }
+            return Value(parser.parseNumber<double>());
+        }
+    }
+
+    static void write(JSONWriter & writer, const Value & value) {
+        switch (value.type()) {
+        case Value::BooleanType:
+            writer.writeBool(value.asBoolean());
+            break;
+        case Value::NumberType:
+            writer.writeDouble(value.asNumber());
+            break;
+        case Value::StringType:
+            writer.writeString(value.asString());
+            break;
+        case Value::ArrayType:
+            JSONCodec<Array<Value> >::write(writer, value.asArray());
+            break;
+        case Value::ObjectType: {
+            const Properties & properties = value.asObject();
+
+            writer.write('{');
+            for (size_t i = 0; i < properties.size(); ++i) {
+                if (i != 0) {
+                    writer.write(',');
+                }
+                writer.writeString(properties[i].first);
+                writer.write(':');
+                write(writer, properties[i].second);
+            }
+            writer.write('}');
+            break;
+        }
+        default:
+            writer.write("null");
+        }
+    }
+
+    static size_t estimate(const Value &) {
+        return 16;
+    }
+};
+
+} // namespace js4cpp
+
+namespace std {
+
+/**
+ * Hash consistent with SameValueZero, so values can be Map and Set keys.
+ */
+template <> struct hash<js4cpp::Value> {
+    size_t operator ()(const js4cpp::Value & value) const {
+        if (value.isNumber()) {
+            // NaNs are canonical already; 0 and -0 must hash alike.
+            return value.asNumber() == 0 ? 0 : std::hash<uint64_t>()(value.bits());
+        }
+        if (value.isString()) {
+            return std::hash<std::string>()(value.asString());
+        }
+
+        return std::hash<uint64_t>()(value.bits());
+    }
+};
+
+} // namespace std
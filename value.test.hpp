@@ -0,0 +1,174 @@
+#pragma once
+
+#include <cmath>
+#include <limits>
+#include <string>
+
+#include <cppunit/TestCaller.h>
+#include <cppunit/TestCase.h>
+#include <cppunit/TestSuite.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+#include "value.hpp"
+
+class ValueTest : public CppUnit::TestCase
+{
+public:
+    ValueTest() : CppUnit::TestCase("Value Test Case") {};
+
+    void testTypes() {
+        using js4cpp::Array;
+        using js4cpp::Value;
+
+        CPPUNIT_ASSERT( sizeof(Value) == 8 );
+        CPPUNIT_ASSERT( Value().isUndefined() && Value(nullptr).isNull() );
+        CPPUNIT_ASSERT( Value(true).isBoolean() && Value(true).asBoolean() && !Value(false).asBoolean() );
+        CPPUNIT_ASSERT( Value(42).isNumber() && Value(42).asNumber() == 42 );
+        CPPUNIT_ASSERT( Value(-0.5).asNumber() == -0.5 && Value(-INFINITY).isNumber() );
+        CPPUNIT_ASSERT( Value(NAN).isNumber() && Value(-NAN).isNumber() && std::isnan(Value(-NAN).asNumber()) );
+        CPPUNIT_ASSERT( Value("text").isString() && Value("text").asString() == "text" );
+        CPPUNIT_ASSERT( Value(Array<Value>::of(1, "a")).isArray() && Value::object().isObject() );
+
+        CPPUNIT_ASSERT( std::string(Value(nullptr).typeOf()) == "object" );
+        CPPUNIT_ASSERT( std::string(Value().typeOf()) == "undefined" );
+        CPPUNIT_ASSERT( std::string(Value(1).typeOf()) == "number" );
+        CPPUNIT_ASSERT( std::string(Value("").typeOf()) == "string" );
+    }
+
+    void testSharing() {
+        using js4cpp::Array;
+        using js4cpp::Value;
+
+        Value array = Array<Value>::of(1, 2);
+        Value copy = array;
+        copy.asArray().push(3);
+        CPPUNIT_ASSERT( array.asArray().length() == 3 );
+
+        Value object = Value::object();
+        object.set("a", 1);
+        object.set("b", "x");
+        object.set("a", 2);
+        Value alias = object;
+        alias.set("c", array);
+        CPPUNIT_ASSERT( object.asObject().size() == 3 && object.asObject()[0].first == "a" );
+        CPPUNIT_ASSERT( object.get("a") == Value(2) && object.get("missing").isUndefined() );
+        CPPUNIT_ASSERT( object.get("c").get("length") == Value(3) && object.get("c").get("1") == Value(2) );
+
+        Value moved = std::move(copy);
+        CPPUNIT_ASSERT( copy.isUndefined() && moved.isArray() );
+        moved = Value("replaced");
+        CPPUNIT_ASSERT( array.asArray().length() == 3 );
+    }
+
+    void testCoercion() {
+        using js4cpp::Array;
+        using js4cpp::Value;
+
+        CPPUNIT_ASSERT( Value(" 12.5 ").toNumber() == 12.5 && Value("0x1f").toNumber() == 31 );
+        CPPUNIT_ASSERT( Value("").toNumber() == 0 && Value(nullptr).toNumber() == 0 && Value(true).toNumber() == 1 );
+        CPPUNIT_ASSERT( std::isnan(Value("12px").toNumber()) && std::isnan(Value().toNumber()) && std::isnan(Value("nan").toNumber()) );
+        CPPUNIT_ASSERT( Value("-Infinity").toNumber() == -INFINITY );
+        CPPUNIT_ASSERT( std::isnan(Value("-0x10").toNumber()) && std::isnan(Value("+0x10").toNumber()) && std::isnan(Value("-0x1p3").toNumber()) );
+        CPPUNIT_ASSERT( std::isnan(Value("0x1p3").toNumber()) && std::isnan(Value("0x-1").toNumber()) && std::isnan(Value("0x 1").toNumber()) );
+        CPPUNIT_ASSERT( std::isnan(Value("0x").toNumber()) && std::isnan(Value("0xg").toNumber()) && std::isnan(Value("infinity").toNumber()) );
+        CPPUNIT_ASSERT( Value("0XFF").toNumber() == 255 && Value("0o17").toNumber() == 15 && Value("0b101").toNumber() == 5 );
+        CPPUNIT_ASSERT( Value("0x10000000000000000").toNumber() == 18446744073709551616.0 && Value("-1e3").toNumber() == -1000 && Value("+.5").toNumber() == 0.5 );
+        CPPUNIT_ASSERT( Value(Array<Value>::of(7)).toNumber() == 7 && Value(Array<Value>()).toNumber() == 0 );
+
+        CPPUNIT_ASSERT( !Value(0).toBoolean() && !Value(NAN).toBoolean() && !Value("").toBoolean() && !Value().toBoolean() );
+        CPPUNIT_ASSERT( Value("0").toBoolean() && Value(Array<Value>()).toBoolean() && Value::object().toBoolean() );
+
+        CPPUNIT_ASSERT( Value(1.5).toString() == "1.5" && Value(1e21).toString() == "1e+21" && Value(NAN).toString() == "NaN" );
+        CPPUNIT_ASSERT( Value(-INFINITY).toString() == "-Infinity" && Value(nullptr).toString() == "null" );
+        CPPUNIT_ASSERT( Value(Array<Value>::of(1, Value(), "a", nullptr)).toString() == "1,,a," );
+        CPPUNIT_ASSERT( Value::object().toString() == "[object Object]" );
+    }
+
+    void testComparison() {
+        using js4cpp::Array;
+        using js4cpp::Value;
+
+        CPPUNIT_ASSERT( Value(1) == Value(1.0) && Value("a") == Value(std::string("a")) );
+        CPPUNIT_ASSERT( Value(0.0) == Value(-0.0) && Value(NAN) != Value(NAN) );
+        CPPUNIT_ASSERT( Value(1) != Value("1") && Value(nullptr) != Value() );
+        CPPUNIT_ASSERT( Value(NAN).sameValueZero(NAN) && Value(0.0).sameValueZero(-0.0) );
+
+        Value array = Array<Value>::of(1);
+        Value copy = array;
+        CPPUNIT_ASSERT( array == copy && array != Value(Array<Value>::of(1)) );
+
+        CPPUNIT_ASSERT( Value(1).looselyEquals("1") && Value(true).looselyEquals(1) && Value(nullptr).looselyEquals(Value()) );
+        CPPUNIT_ASSERT( !Value(nullptr).looselyEquals(0) && !Value(NAN).looselyEquals(NAN) );
+        CPPUNIT_ASSERT( array.looselyEquals("1") && Value("").looselyEquals(0) );
+
+        CPPUNIT_ASSERT( Value(2) < Value(10) && Value("10") < Value("2") && Value("2") < Value(10) );
+        CPPUNIT_ASSERT( !(Value(NAN) < Value(1)) && !(Value(1) < Value(NAN)) );
+
+        Array<Value> values = Array<Value>::of(1, "x", nullptr, NAN);
+        CPPUNIT_ASSERT( values.indexOf("x") == 1 && values.indexOf(NAN) == -1 );
+    }
+
+    void testElementsKind() {
+        using js4cpp::Array;
+        using js4cpp::ArrayView;
+        using js4cpp::Value;
+
+        CPPUNIT_ASSERT( js4cpp::elementsKind(Array<Value>::of(1, -2, 3)) == js4cpp::PackedSmiElements );
+        CPPUNIT_ASSERT( js4cpp::elementsKind(Array<Value>::of(1, 2.5)) == js4cpp::PackedDoubleElements );
+        CPPUNIT_ASSERT( js4cpp::elementsKind(Array<Value>::of(1, -0.0)) == js4cpp::PackedDoubleElements );
+        CPPUNIT_ASSERT( js4cpp::elementsKind(Array<Value>::of(1, 1e20)) == js4cpp::PackedDoubleElements );
+        CPPUNIT_ASSERT( js4cpp::elementsKind(Array<Value>::of(1, 3e9)) == js4cpp::PackedDoubleElements );
+        CPPUNIT_ASSERT( js4cpp::elementsKind(Array<Value>::of(NAN, 1)) == js4cpp::PackedDoubleElements );
+        CPPUNIT_ASSERT( js4cpp::elementsKind(Array<Value>::of(1, -INFINITY)) == js4cpp::PackedDoubleElements );
+        CPPUNIT_ASSERT( js4cpp::elementsKind(Array<Value>::of(2147483647, -2147483648.0)) == js4cpp::PackedSmiElements );
+        CPPUNIT_ASSERT( js4cpp::elementsKind(Array<Value>::of(1, "2")) == js4cpp::PackedElements );
+
+        Array<Value> values = Array<Value>::of(1, 2.5, NAN, 4);
+        ArrayView<double> numbers = js4cpp::numbers(values);
+        CPPUNIT_ASSERT( numbers.length() == 4 && numbers[1] == 2.5 && std::isnan(numbers[2]) );
+        CPPUNIT_ASSERT( numbers.data() == reinterpret_cast<const double *>(values.begin()) );
+        CPPUNIT_ASSERT( js4cpp::numbers(Array<Value>::of(1, true)).length() == 0 );
+    }
+
+    void testJSON() {
+        using js4cpp::JSON;
+        using js4cpp::Value;
+
+        Value value = JSON::parse<Value>("{\"b\": [1, \"two\", null, true, {}], \"a\": -1.5e1, \"b\": false}");
+        CPPUNIT_ASSERT( value.isObject() && value.asObject().size() == 2 );
+        CPPUNIT_ASSERT( value.asObject()[0].first == "b" && value.get("b") == Value(false) );
+        CPPUNIT_ASSERT( value.get("a") == Value(-15) );
+
+        Value array = JSON::parse<Value>("[1, \"two\", null, true, {\"x\": []}]");
+        CPPUNIT_ASSERT( JSON::stringify(array) == "[1,\"two\",null,true,{\"x\":[]}]" );
+        CPPUNIT_ASSERT( JSON::stringify(Value()) == "null" );
+        CPPUNIT_ASSERT( JSON::stringify(JSON::parse<Value>(" \"\\u0041\" ")) == "\"A\"" );
+
+        CPPUNIT_ASSERT( fails("{\"a\" 1}") );
+        CPPUNIT_ASSERT( fails("{\"a\": 1,}") );
+        CPPUNIT_ASSERT( fails("[undefined]") );
+    }
+
+    void setUp() {}
+
+    void tearDown() {}
+
+    CPPUNIT_TEST_SUITE( ValueTest );
+    CPPUNIT_TEST( testTypes );
+    CPPUNIT_TEST( testSharing );
+    CPPUNIT_TEST( testCoercion );
+    CPPUNIT_TEST( testComparison );
+    CPPUNIT_TEST( testElementsKind );
+    CPPUNIT_TEST( testJSON );
+    CPPUNIT_TEST_SUITE_END();
+
+private:
+    static bool fails(const std::string & json) {
+        try {
+            js4cpp::JSON::parse<js4cpp::Value>(json);
+        } catch (const js4cpp::SyntaxError &) {
+            return true;
+        }
+        return false;
+    }
+};